@@ -0,0 +1,67 @@
+#include "../includes/shell.h"
+
+/*
+ * Built-in dispatch cost: times find_builtin() against a linear _strcmp
+ * scan of the same names (what it replaced), for external command names
+ * (misses, the common case) and for built-ins. Run with: make bench
+ */
+#define ROUNDS 10000000
+
+/**
+ * linear_find - Looks a built-in up by comparing it with every name.
+ * @name: The command name.
+ * Return: The index of the name, or -1.
+ */
+static int linear_find(char *name)
+{
+	static char *names[] = {"exit", "env", "help", "history", "setenv",
+		"unsetenv", "cd", "alias", "break", "continue", "true", ":",
+		"false", "return", "local", ".", "source", "export", "readonly",
+		"unset", "declare", "typeset", "mapfile", "readarray", "read", NULL};
+	int i;
+
+	for (i = 0; names[i]; i++)
+		if (!_strcmp(name, names[i]))
+			return (i);
+	return (-1);
+}
+
+/**
+ * now_ns - Reads the monotonic clock.
+ * Return: The time in nanoseconds.
+ */
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+/**
+ * main - Prints the cost per lookup of each name, both ways.
+ * Return: 0.
+ */
+int main(void)
+{
+	char *words[] = {"ls", "grep", "printf", "readlink", "git", "cd",
+		"export", "readarray", NULL};
+	volatile long sink = 0;
+	double t, old;
+	int i, j;
+
+	printf("%-10s %8s %8s\n", "name", "linear", "hash");
+	for (j = 0; words[j]; j++)
+	{
+		t = now_ns();
+		for (i = 0; i < ROUNDS; i++)
+			sink += linear_find(words[j]);
+		old = (now_ns() - t) / ROUNDS;
+		t = now_ns();
+		for (i = 0; i < ROUNDS; i++)
+			sink += (long)find_builtin(words[j]);
+		printf("%-10s %6.1fns %6.1fns%s\n", words[j], old, (now_ns() - t) / ROUNDS,
+			find_builtin(words[j]) ? "" : "  (miss)");
+	}
+	return (sink == 42);
+}
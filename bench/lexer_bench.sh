@@ -0,0 +1,50 @@
+#!/bin/sh
+# ==============================================================================
+# Lexer throughput: runs a generated script of cheap built-in commands, heavy
+# on quotes, backslash escapes, comments and operators (and free of '$', so
+# expansion stays out of the way), and prints megabytes per second. The
+# script is run as a file (parsed whole) and from stdin (line by line).
+# HOME points nowhere and XDG_CACHE_HOME is unset, so that no history or
+# script cache is used.
+# Usage: sh bench/lexer_bench.sh [size in MB] [hsh...]   (or: make bench)
+# Give several binaries to compare them, e.g. a build of an older commit.
+# ==============================================================================
+
+MB=${1:-8}
+[ $# -gt 0 ] && shift
+[ $# -eq 0 ] && set -- ./hsh
+script=${TMPDIR:-/tmp}/hsh_lexer_bench_$$.sh
+trap 'rm -f "$script"' EXIT
+
+awk -v bytes=$((MB * 1048576)) 'BEGIN {
+	line[0] = ": word '\''single ; | & quoted'\'' \"double \\\"quoted\\\" text\" back\\ slash # comment"
+	line[1] = "true && : one two three || false ; : four five six"
+	line[2] = "# a comment line with ; | & and '\''quotes'\''"
+	line[3] = ": a\;b \"c|d\" '\''e&&f'\'' g\\\"h ; true"
+	line[4] = "if true; then : yes; else : no; fi"
+	for (n = i = 0; n < bytes; i++) {
+		print line[i % 5]
+		n += length(line[i % 5]) + 1
+	}
+}' > "$script"
+
+# ms - Prints the time in milliseconds
+ms()
+{
+	echo $(($(date +%s%N) / 1000000))
+}
+
+for hsh in "$@"; do
+	for mode in file stdin; do
+		t=$(ms)
+		if [ $mode = file ]; then
+			env -u XDG_CACHE_HOME HOME=/nonexistent "$hsh" "$script"
+		else
+			env -u XDG_CACHE_HOME HOME=/nonexistent "$hsh" < "$script"
+		fi || { echo "$hsh failed" >&2; exit 1; }
+		t=$(($(ms) - t))
+		[ $t -gt 0 ] || t=1
+		awk -v h="$hsh" -v m=$mode -v mb="$MB" -v t=$t \
+			'BEGIN { printf "%-24s %-5s %4d MB in %6d ms: %7.1f MB/s\n", h, m, mb, t, mb * 1000 / t }'
+	done
+done
@@ -0,0 +1,36 @@
+#!/bin/sh
+# ==============================================================================
+# Loop cost: times loops of 1M iterations over built-ins, which run from the
+# parsed form with no fork, and prints nanoseconds per iteration. There is no
+# `[` built in (it would be an exec of /usr/bin/[), so the conditions are
+# (( )) arithmetic and `true`.
+# Usage: sh bench/loop_bench.sh [iterations] [hsh...]   (or: make bench)
+# Give several binaries to compare them, e.g. a build of an older commit.
+# ==============================================================================
+
+N=${1:-1000000}
+[ $# -gt 0 ] && shift
+[ $# -eq 0 ] && set -- ./hsh
+dir=$(mktemp -d "${TMPDIR:-/tmp}/hsh_loop_bench.XXXXXX")
+trap 'rm -rf "$dir"' EXIT
+
+echo "for ((i = 0; i < $N; i++)); do :; done" > "$dir/for"
+printf 'i=0\nwhile (( i < %d )); do true; (( i++ )); done\n' "$N" > "$dir/while"
+echo "for ((i = 0; i < $N; i++)); do if true; then :; else false; fi; done" > "$dir/if"
+
+# ms - Prints the time in milliseconds
+ms()
+{
+	echo $(($(date +%s%N) / 1000000))
+}
+
+for hsh in "$@"; do
+	for loop in for while if; do
+		t=$(ms)
+		env -u XDG_CACHE_HOME HOME=/nonexistent "$hsh" "$dir/$loop" \
+			|| { echo "$hsh failed" >&2; exit 1; }
+		t=$(($(ms) - t))
+		awk -v h="$hsh" -v l=$loop -v n="$N" -v t=$t \
+			'BEGIN { printf "%-24s %-5s %8d iterations in %6d ms: %6.1f ns each\n", h, l, n, t, t * 1e6 / n }'
+	done
+done
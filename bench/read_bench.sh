@@ -0,0 +1,38 @@
+#!/bin/sh
+# ==============================================================================
+# read throughput: generates a file of 100-byte lines in a temporary
+# directory and times `while read -r l; do :; done` over it, with the file
+# as the shell's stdin. bash runs the same loop as the baseline when it is
+# installed.
+# Usage: sh bench/read_bench.sh [size in MB] [hsh...]   (or: make bench)
+# Give several binaries to compare them, e.g. a build of an older commit.
+# ==============================================================================
+
+MB=${1:-1024}
+[ $# -gt 0 ] && shift
+[ $# -eq 0 ] && set -- ./hsh
+command -v bash > /dev/null 2>&1 && set -- "$@" bash
+dir=$(mktemp -d "${TMPDIR:-/tmp}/hsh_read_bench.XXXXXX")
+trap 'rm -rf "$dir"' EXIT
+
+echo 'while read -r l; do :; done' > "$dir/loop.sh"
+awk -v lines=$((MB * 1048576 / 100)) 'BEGIN {
+	for (i = 0; i < lines; i++)
+		printf "%010d %-77s read bench\n", i, "field two three four five"
+}' > "$dir/data"
+
+# ms - Prints the time in milliseconds
+ms()
+{
+	echo $(($(date +%s%N) / 1000000))
+}
+
+for hsh in "$@"; do
+	t=$(ms)
+	env -u XDG_CACHE_HOME HOME=/nonexistent "$hsh" "$dir/loop.sh" < "$dir/data" \
+		|| { echo "$hsh failed" >&2; exit 1; }
+	t=$(($(ms) - t))
+	[ $t -gt 0 ] || t=1
+	awk -v h="$hsh" -v mb="$MB" -v t=$t \
+		'BEGIN { printf "%-24s %5d MB in %7d ms: %7.1f MB/s\n", h, mb, t, mb * 1000 / t }'
+done
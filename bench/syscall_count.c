@@ -0,0 +1,111 @@
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+/*
+ * LD_PRELOAD counter of the I/O system calls the shell makes through libc:
+ * read, write, writev and io_uring_enter. The counts are printed to stderr
+ * when the process exits. Used by uring_bench.sh where strace is missing.
+ * Build: cc -shared -fPIC syscall_count.c -o syscall_count.so -ldl
+ */
+static long n_read, n_write, n_enter;
+
+/**
+ * next - Finds the libc function this file overrides.
+ * @name: Its name.
+ * Return: The function.
+ */
+static void *next(const char *name)
+{
+	return (dlsym(RTLD_NEXT, name));
+}
+
+/**
+ * report - Prints the counts when the process exits.
+ */
+__attribute__((destructor)) static void report(void)
+{
+	ssize_t (*w)(int, const void *, size_t) = (ssize_t (*)(int, const void *, size_t))next("write");
+	char buf[128];
+	int len = snprintf(buf, sizeof(buf), "read=%ld write=%ld io_uring_enter=%ld total=%ld\n",
+		n_read, n_write, n_enter, n_read + n_write + n_enter);
+
+	w(2, buf, len);
+}
+
+/**
+ * read - Counts a read.
+ * @fd: The file descriptor.
+ * @buf: The buffer.
+ * @n: Its size.
+ * Return: What read returns.
+ */
+ssize_t read(int fd, void *buf, size_t n)
+{
+	static ssize_t (*f)(int, void *, size_t);
+
+	if (!f)
+		f = (ssize_t (*)(int, void *, size_t))next("read");
+	n_read++;
+	return (f(fd, buf, n));
+}
+
+/**
+ * write - Counts a write.
+ * @fd: The file descriptor.
+ * @buf: The data.
+ * @n: Its length.
+ * Return: What write returns.
+ */
+ssize_t write(int fd, const void *buf, size_t n)
+{
+	static ssize_t (*f)(int, const void *, size_t);
+
+	if (!f)
+		f = (ssize_t (*)(int, const void *, size_t))next("write");
+	n_write++;
+	return (f(fd, buf, n));
+}
+
+/**
+ * writev - Counts a writev.
+ * @fd: The file descriptor.
+ * @iov: The buffers.
+ * @n: Their number.
+ * Return: What writev returns.
+ */
+ssize_t writev(int fd, const struct iovec *iov, int n)
+{
+	static ssize_t (*f)(int, const struct iovec *, int);
+
+	if (!f)
+		f = (ssize_t (*)(int, const struct iovec *, int))next("writev");
+	n_write++;
+	return (f(fd, iov, n));
+}
+
+/**
+ * syscall - Counts io_uring_enter, which the shell makes with syscall().
+ * @no: The system call number.
+ * Return: What syscall returns.
+ */
+long syscall(long no, ...)
+{
+	static long (*f)(long, ...);
+	long a[6];
+	va_list ap;
+	int i;
+
+	if (!f)
+		f = (long (*)(long, ...))next("syscall");
+	va_start(ap, no);
+	for (i = 0; i < 6; i++)
+		a[i] = va_arg(ap, long);
+	va_end(ap);
+	n_enter += no == SYS_io_uring_enter;
+	return (f(no, a[0], a[1], a[2], a[3], a[4], a[5]));
+}
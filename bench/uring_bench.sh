@@ -0,0 +1,54 @@
+#!/bin/sh
+# ==============================================================================
+# I/O system calls of the default build against an IO_URING=1 build: runs
+# the same workloads through both and counts read, write, writev and
+# io_uring_enter, with strace -c when it is installed, else with the
+# LD_PRELOAD counter built from bench/syscall_count.c.
+# Usage: sh bench/uring_bench.sh plain_hsh uring_hsh [syscall_count.so]
+# (or: make bench, which builds both binaries and the counter)
+# ==============================================================================
+
+PLAIN=${1:?plain hsh}
+URING=${2:?io_uring hsh}
+COUNTER=$3
+dir=$(mktemp -d "${TMPDIR:-/tmp}/hsh_uring_bench.XXXXXX")
+trap 'rm -rf "$dir"' EXIT
+
+# The shell has no echo built in: alias prints, and cd fails to stderr
+awk 'BEGIN { print "alias l=line"; for (i = 0; i < 50000; i++) print "alias l" }' > "$dir/builtins.sh"
+awk 'BEGIN {
+	print "alias l=line"
+	for (i = 0; i < 10000; i++) {
+		print "(( x += 1 ))"
+		print "alias l"
+		print ": ${x:+set}"
+		print (i % 100 ? "true" : "cd /nonexistent/$x")
+	}
+}' > "$dir/mixed.sh"
+
+# count HSH ARGS... - Prints the I/O system calls hsh makes, reading the
+# workload from stdin when no script is given
+count()
+{
+	hsh=$1
+	shift
+	if command -v strace > /dev/null 2>&1; then
+		env -u XDG_CACHE_HOME HOME=/nonexistent strace -f -c -o "$dir/trace" \
+			-e trace=read,write,writev,io_uring_enter "$hsh" "$@" > /dev/null 2>&1
+		awk '$NF == "total" { print $4 }' "$dir/trace"
+	elif [ -n "$COUNTER" ]; then
+		env -u XDG_CACHE_HOME HOME=/nonexistent LD_PRELOAD="$COUNTER" "$hsh" "$@" 2>&1 \
+			> /dev/null | sed -n 's/.*total=//p'
+	else
+		echo "neither strace nor a counter library" >&2
+		exit 1
+	fi
+}
+
+printf '%-26s %8s %8s\n' workload plain io_uring
+for w in builtins mixed; do
+	printf '%-26s %8s %8s\n' "$w, piped on stdin" \
+		"$(cat "$dir/$w.sh" | count "$PLAIN")" "$(cat "$dir/$w.sh" | count "$URING")"
+	printf '%-26s %8s %8s\n' "$w, as a script file" \
+		"$(count "$PLAIN" "$dir/$w.sh")" "$(count "$URING" "$dir/$w.sh")"
+done
@@ -0,0 +1,97 @@
+#include "../includes/shell.h"
+
+/**
+ * open_input - Opens the input of mapfile: the file operand if there is
+ * one, otherwise the -u descriptor (standard input by default).
+ * @info: Structure containing potential arguments.
+ * @file: The file operand, or NULL.
+ * @fd: The descriptor to read when there is no file.
+ * Return: The descriptor, or -1 if the file could not be opened (reported).
+ */
+static int open_input(info_t *info, char *file, int fd)
+{
+	if (!file)
+		return (fd);
+	fd = open(file, O_RDONLY);
+	if (fd == -1)
+	{
+		error_line(info, info->argv[0], ": Can't open ", file, NULL);
+	}
+	return (fd);
+}
+
+/**
+ * load_lines - Splits a buffer into lines and appends them to an array.
+ * @a: The array.
+ * @buf: The text.
+ * @len: Length of the text; a last line without a newline still counts.
+ * @trim: Drop the newline that ends each line.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int load_lines(array_t *a, char *buf, size_t len, int trim)
+{
+	char *p, *nl, *end = buf + len;
+
+	for (p = buf; p < end; p = nl + 1)
+	{
+		nl = memchr(p, '\n', end - p);
+		if (!nl)
+			nl = end;
+		// array_push from variables/arrays.c
+		if (array_push(a, p, nl - p + (!trim && nl < end)))
+			return (-1);
+	}
+	return (0);
+}
+
+/**
+ * _mymapfile - Reads lines into an indexed array, one element per line:
+ * mapfile [-t] [-u fd] [array [file]] (also spelled readarray). The array
+ * is MAPFILE unless named. -t drops the newlines. As the shell has no
+ * redirections, the lines can come from a named file; the input is read
+ * whole in one pass and split in place.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: 0 on success, 1 on error, 2 on a bad option.
+ */
+int _mymapfile(info_t *info)
+{
+	int i, trim = 0, fd = STDIN_FILENO, ret = 0;
+	char *name = "MAPFILE", *file = NULL, *buf;
+	struct stat st;
+	array_t *a;
+	size_t len;
+
+	for (i = 1; info->argv[i] && info->argv[i][0] == '-' && info->argv[i][1]; i++)
+		if (!_strcmp(info->argv[i], "-t"))
+			trim = 1;
+		else if (!_strcmp(info->argv[i], "-u") && info->argv[i + 1])
+			fd = string_to_int(info->argv[++i]);
+		else
+		{
+			error_line(info, info->argv[0], ": ", info->argv[i], ": invalid option", NULL);
+			return (2);
+		}
+	if (info->argv[i])
+		name = info->argv[i++];
+	if (info->argv[i])
+		file = info->argv[i];
+	if (!valid_name(name))
+	{
+		error_line(info, info->argv[0], ": bad variable name: ", name, NULL);
+		return (1);
+	}
+	a = var_make_array(info, name, 0); // var_make_array from variables/shell_variables.c
+	fd = a && fd >= 0 ? open_input(info, file, fd) : -1;
+	if (fd == -1)
+		return (1);
+	// read_all from shell_core/script_loader.c; a regular file is read in one call
+	buf = read_all(fd, fstat(fd, &st) == 0 && S_ISREG(st.st_mode) ? st.st_size : 0, &len);
+	if (file)
+		close(fd);
+	array_clear(a); // array_clear from variables/arrays.c
+	if (!buf || load_lines(a, buf, len, trim))
+		ret = 1;
+	free(buf);
+	return (ret);
+}
@@ -44,9 +44,7 @@ int _mycd(info_t *info)
 
 	if (chdir_ret == -1) // chdir failed
 	{
-		print_error(info, "can't cd to ");
-		_eputs(info->argv[1]);
-		_eputchar('\n');
+		error_line(info, info->argv[0], ": can't cd to ", info->argv[1], NULL);
 	}
 	else // chdir successful, update PWD and OLDPWD
 	{
@@ -17,9 +17,7 @@ int _myexit(info_t *info)
 		if (exitcheck == -1)
 		{
 			info->status = 2;
-			print_error(info, "Illegal number: ");
-			_eputs(info->argv[1]);
-			_eputchar('\n');
+			error_line(info, info->argv[0], ": Illegal number: ", info->argv[1], NULL);
 			return (1);
 		}
 		info->err_num = exitcheck; // Use exitcheck directly
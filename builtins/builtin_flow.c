@@ -0,0 +1,75 @@
+#include "../includes/shell.h"
+
+/**
+ * loop_jump - Common part of break and continue: asks the evaluator to
+ * unwind n enclosing loops.
+ * @info: Structure containing potential arguments.
+ * @ctl: CTL_BREAK or CTL_CONTINUE.
+ * Return: 0, or 2 if the loop count is not a positive number.
+ */
+static int loop_jump(info_t *info, int ctl)
+{
+	int n = 1;
+
+	if (info->argv[1])
+	{
+		n = _erratoi(info->argv[1]);
+		if (n <= 0)
+		{
+			error_line(info, info->argv[0], ": Illegal number: ", info->argv[1], NULL);
+			return (2);
+		}
+	}
+	if (!info->loop_depth) // Outside a loop break and continue do nothing
+		return (0);
+	info->ctl = ctl;
+	info->ctl_levels = n > info->loop_depth ? info->loop_depth : n;
+	return (0);
+}
+
+/**
+ * _mybreak - Leaves the innermost loop, or the n innermost loops.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: 0, or 2 on a bad argument.
+ */
+int _mybreak(info_t *info)
+{
+	return (loop_jump(info, CTL_BREAK));
+}
+
+/**
+ * _mycontinue - Starts the next iteration of the innermost loop,
+ * or of the n-th enclosing loop.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: 0, or 2 on a bad argument.
+ */
+int _mycontinue(info_t *info)
+{
+	return (loop_jump(info, CTL_CONTINUE));
+}
+
+/**
+ * _mytrue - Does nothing, successfully (also ':').
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: Always 0.
+ */
+int _mytrue(info_t *info)
+{
+	(void)info;
+	return (0);
+}
+
+/**
+ * _myfalse - Does nothing, unsuccessfully.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: Always 1.
+ */
+int _myfalse(info_t *info)
+{
+	(void)info;
+	return (1);
+}
@@ -0,0 +1,75 @@
+#include "../includes/shell.h"
+
+/**
+ * _myreturn - Returns from the running shell function or sourced file.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: The status to return (the last command's by default),
+ * 1 outside a function or sourced file, or 2 on a bad argument.
+ */
+int _myreturn(info_t *info)
+{
+	int n = info->status;
+
+	if (info->argv[1])
+	{
+		n = _erratoi(info->argv[1]);
+		if (n == -1)
+		{
+			error_line(info, info->argv[0], ": Illegal number: ", info->argv[1], NULL);
+			return (2);
+		}
+	}
+	if (!info->func_depth && !info->source_depth)
+	{
+		print_error(info, "not in a function\n");
+		return (1);
+	}
+	info->ctl = CTL_RETURN;
+	return (n & 0xff);
+}
+
+/**
+ * _mylocal - Declares variables local to the running function:
+ * local [-aA] name[=value]... -a and -A make them indexed and associative
+ * arrays; a value may be an array name=(...).
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: 0 on success, 1 on error, 2 on a bad option.
+ */
+int _mylocal(info_t *info)
+{
+	int i, ret = 0, array = -1;
+	char *eq, *name, *o;
+
+	if (!info->func_depth)
+	{
+		print_error(info, "not in a function\n");
+		return (1);
+	}
+	for (i = 1; info->argv[i] && info->argv[i][0] == '-' && info->argv[i][1]; i++)
+		for (o = info->argv[i] + 1; *o; o++)
+			if (*o == 'a' || *o == 'A')
+				array = *o == 'A';
+			else
+			{
+				error_line(info, info->argv[0], ": ", info->argv[i], ": invalid option", NULL);
+				return (2);
+			}
+	for (; info->argv[i]; i++)
+	{
+		name = decl_name(info, i, &eq); // decl_name from builtins/builtin_variable.c
+		if (!name || !valid_name(name))
+		{
+			error_line(info, info->argv[0], ": bad variable name: ", info->argv[i], NULL);
+			ret = 1;
+			continue;
+		}
+		if (var_save(info, &info->locals, name)) // var_save from variables/shell_variables.c
+			return (1);
+		if ((array >= 0 && !var_make_array(info, name, array))
+			|| decl_assign(info, i, name, eq)) // decl_assign from builtins/builtin_variable.c
+			ret = 1;
+	}
+	return (ret);
+}
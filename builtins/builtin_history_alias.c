@@ -2,116 +2,118 @@
 
 /**
  * _myhistory - Displays the history list, one command by line, preceded
- * with line numbers, starting at 0.
+ * with line numbers. "history N" shows only the last N lines.
  * @info: Structure containing potential arguments. Used to maintain
  * constant function prototype.
- * Return: Always 0.
+ * Return: 0, or 2 if N is not a number.
  */
 int _myhistory(info_t *info)
 {
-	print_list(info->history); // print_list is in linked_lists/list_utilities.c
+	int n = info->argv[1] ? _erratoi(info->argv[1]) : -1; // _erratoi in error_handling/error_utilities.c
+
+	if (info->argv[1] && n < 0)
+	{
+		error_line(info, info->argv[0], ": Illegal number: ", info->argv[1], NULL);
+		return (2);
+	}
+	hist_print(info, info->argv[1] ? (unsigned int)n : HIST_MAX); // hist_print in history/history_manager.c
 	return (0);
 }
 
 /**
- * unset_alias - Unsets an alias by removing it from the alias list.
- * @info: Parameter struct.
- * @str: The alias string (e.g., "la=ls -al").
- * Return: Always 0 on success, 1 on error.
+ * print_alias - Prints an alias as name='value', in a form that can be
+ * read back as an alias command.
+ * @name: The alias name.
+ * @a: The alias.
  */
-int unset_alias(info_t *info, char *str)
+static void print_alias(char *name, alias_t *a)
 {
-	char *p, c;
-	int ret;
+	char *p;
 
-	p = _strchr(str, '='); // _strchr is in string_operations/string_manipulation1.c
-	if (!p)
-		return (1);
-	c = *p;
-	*p = 0; // Temporarily null-terminate to get the alias name
-	ret = delete_node_at_index(&(info->alias),
-		get_node_index(info->alias, node_starts_with(info->alias, str, -1)));
-	if (ret == 0)
-	{
-		_puts("Error: Alias not found\n");
-		return (1);
-	}
-	*p = c; // Restore the original string
-	return (ret);
+	_puts(name); // _puts is in string_operations/string_manipulation2.c
+	_puts("='");
+	for (p = a->value; *p; p++)
+		if (*p == '\'')
+			_puts("'\\''");
+		else
+			_putchar(*p);
+	_puts("'\n");
 }
 
 /**
- * set_alias - Sets an alias by adding or updating it in the alias list.
- * @info: Parameter struct.
- * @str: The alias string (e.g., "la=ls -al").
- * Return: Always 0 on success, 1 on error.
+ * cmp_alias - Orders hash entries by key, for qsort.
+ * @a: Pointer to an entry pointer.
+ * @b: Pointer to an entry pointer.
+ * Return: Negative, zero or positive, as for strcmp.
  */
-int set_alias(info_t *info, char *str)
+static int cmp_alias(const void *a, const void *b)
 {
-	char *p;
-
-	p = _strchr(str, '=');
-	if (!p)
-		return (1);
-	if (!*++p) // If there's no value after '=', unset the alias
-		return (unset_alias(info, str));
-
-	unset_alias(info, str); // Unset existing alias before setting new one
-	return (add_node_end(&(info->alias), str, 0) == NULL);
+	return (_strcmp((*(hash_entry_t *const *)a)->key, (*(hash_entry_t *const *)b)->key));
 }
 
 /**
- * print_alias - Prints an alias string in 'name='value'' format.
- * @node: The alias list node.
- * Return: Always 0 on success, 1 on error.
+ * print_aliases - Prints every alias, sorted by name.
+ * @info: Structure containing potential arguments.
+ * Return: 0 on success, 1 on allocation failure.
  */
-int print_alias(list_t *node)
+static int print_aliases(info_t *info)
 {
-	char *p = NULL, *a = NULL;
+	hash_entry_t **v, *e;
+	size_t i, n = 0;
 
-	if (node)
-	{
-		p = _strchr(node->str, '=');
-		for (a = node->str; a <= p; a++)
-			_putchar(*a);
-		_putchar('\'');
-		_puts(p + 1);
-		_puts("'\n");
+	if (!info->aliases.count)
 		return (0);
-	}
-	return (1);
+	v = arena_alloc(&info->scratch, sizeof(hash_entry_t *) * info->aliases.count);
+	if (!v)
+		return (1);
+	for (i = 0; i < info->aliases.size; i++)
+		for (e = info->aliases.buckets[i]; e; e = e->next)
+			v[n++] = e;
+	qsort(v, n, sizeof(hash_entry_t *), cmp_alias);
+	for (i = 0; i < n; i++)
+		print_alias(v[i]->key, v[i]->value);
+	return (0);
 }
 
 /**
- * _myalias - Mimics the alias built-in (man alias).
+ * _myalias - Mimics the alias built-in (man alias): alias [name[=value]...].
+ * name=value defines an alias (an empty value removes it); a name alone
+ * prints its alias; no operands print them all.
  * @info: Structure containing potential arguments. Used to maintain
  * constant function prototype.
- * Return: Always 0.
+ * Return: 0 on success, 1 if an alias was not found or not defined.
  */
 int _myalias(info_t *info)
 {
-	int i = 0;
-	char *p = NULL;
-	list_t *node = NULL;
+	int i, ret = 0, r;
+	char *p;
+	hash_entry_t *e;
 
 	if (info->argc == 1) // If no arguments, print all aliases
-	{
-		node = info->alias;
-		while (node)
-		{
-			print_alias(node);
-			node = node->next;
-		}
-		return (0);
-	}
+		return (print_aliases(info));
 	for (i = 1; info->argv[i]; i++) // Process arguments
 	{
 		p = _strchr(info->argv[i], '=');
-		if (p) // If argument contains '=', it's a set operation
-			set_alias(info, info->argv[i]);
-		else // Otherwise, it's a print operation
-			print_alias(node_starts_with(info->alias, info->argv[i], '='));
+		if (p && p > info->argv[i]) // name=value sets (or, when empty, unsets)
+		{
+			*p = '\0';
+			// alias_unset and alias_set from variables/aliases.c
+			r = p[1] ? alias_set(info, info->argv[i], p + 1) : (alias_unset(info, info->argv[i]), 0);
+			*p = '=';
+			if (r)
+			{
+				error_line(info, info->argv[0], r > 0 ? ": unterminated quote: "
+					: ": out of memory: ", info->argv[i], NULL);
+				ret = 1;
+			}
+		}
+		else if (!p && (e = hash_find(&info->aliases, info->argv[i])))
+			print_alias(e->key, e->value);
+		else
+		{
+			error_line(info, info->argv[0], ": ", info->argv[i], ": not found", NULL);
+			ret = 1;
+		}
 	}
-
-	return (0);
+	return (ret);
 }
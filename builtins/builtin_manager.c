@@ -1,49 +1,118 @@
 #include "../includes/shell.h"
 
+/*
+ * Built-in commands and reserved words share one table indexed by a
+ * perfect hash of the name's length, first and last bytes, so a lookup
+ * is one hash and at most one string comparison, hit or miss. The hash
+ * is evaluated by the compiler for the table's designated initializers;
+ * two names landing in the same slot override one another, which
+ * -Wextra (-Woverride-init) turns into a build error. A new name that
+ * collides needs new multipliers: any for which all the names of the
+ * table fall in distinct slots will do.
+ */
+#define NAME_SLOTS 128
+#define NAME_MAX_LEN 9 // Longest name in the table ("readarray")
+#define NAME_HASH(len, first, last) \
+	(((first) * 4 + (last) * 40 + (len) * 3) & (NAME_SLOTS - 1))
+
+static builtin_table names[NAME_SLOTS] = {
+	[NAME_HASH(4, 'e', 't')] = {"exit", _myexit, 0},          // from builtins/builtin_exit.c
+	[NAME_HASH(3, 'e', 'v')] = {"env", _myenv, 0},            // from environment/env_manager.c
+	[NAME_HASH(4, 'h', 'p')] = {"help", _myhelp, 0},          // from builtins/builtin_help.c
+	[NAME_HASH(7, 'h', 'y')] = {"history", _myhistory, 0},    // from builtins/builtin_history_alias.c
+	[NAME_HASH(6, 's', 'v')] = {"setenv", _mysetenv, 0},      // from environment/env_manager.c
+	[NAME_HASH(8, 'u', 'v')] = {"unsetenv", _myunsetenv, 0},  // from environment/env_manager.c
+	[NAME_HASH(2, 'c', 'd')] = {"cd", _mycd, 0},              // from builtins/builtin_cd.c
+	[NAME_HASH(5, 'a', 's')] = {"alias", _myalias, 0},        // from builtins/builtin_history_alias.c
+	[NAME_HASH(5, 'b', 'k')] = {"break", _mybreak, 0},        // from builtins/builtin_flow.c
+	[NAME_HASH(8, 'c', 'e')] = {"continue", _mycontinue, 0},  // from builtins/builtin_flow.c
+	[NAME_HASH(4, 't', 'e')] = {"true", _mytrue, 0},          // from builtins/builtin_flow.c
+	[NAME_HASH(1, ':', ':')] = {":", _mytrue, 0},             // from builtins/builtin_flow.c
+	[NAME_HASH(5, 'f', 'e')] = {"false", _myfalse, 0},        // from builtins/builtin_flow.c
+	[NAME_HASH(6, 'r', 'n')] = {"return", _myreturn, 0},      // from builtins/builtin_function.c
+	[NAME_HASH(5, 'l', 'l')] = {"local", _mylocal, 0},        // from builtins/builtin_function.c
+	[NAME_HASH(1, '.', '.')] = {".", _mysource, 0},           // from builtins/builtin_source.c
+	[NAME_HASH(6, 's', 'e')] = {"source", _mysource, 0},      // from builtins/builtin_source.c
+	[NAME_HASH(6, 'e', 't')] = {"export", _myexport, 0},      // from builtins/builtin_variable.c
+	[NAME_HASH(8, 'r', 'y')] = {"readonly", _myreadonly, 0},  // from builtins/builtin_variable.c
+	[NAME_HASH(5, 'u', 't')] = {"unset", _myunset, 0},        // from builtins/builtin_variable.c
+	[NAME_HASH(7, 'd', 'e')] = {"declare", _mydeclare, 0},    // from builtins/builtin_variable.c
+	[NAME_HASH(7, 't', 't')] = {"typeset", _mydeclare, 0},    // from builtins/builtin_variable.c
+	[NAME_HASH(7, 'm', 'e')] = {"mapfile", _mymapfile, 0},    // from builtins/builtin_array.c
+	[NAME_HASH(9, 'r', 'y')] = {"readarray", _mymapfile, 0},  // from builtins/builtin_array.c
+	[NAME_HASH(4, 'r', 'd')] = {"read", _myread, 0},          // from builtins/builtin_read.c
+	[NAME_HASH(1, '}', '}')] = {"}", NULL, KW_RBRACE},
+	[NAME_HASH(4, 't', 'n')] = {"then", NULL, KW_THEN},
+	[NAME_HASH(4, 'e', 'f')] = {"elif", NULL, KW_ELIF},
+	[NAME_HASH(4, 'e', 'e')] = {"else", NULL, KW_ELSE},
+	[NAME_HASH(2, 'f', 'i')] = {"fi", NULL, KW_FI},
+	[NAME_HASH(2, 'd', 'o')] = {"do", NULL, KW_DO},
+	[NAME_HASH(4, 'd', 'e')] = {"done", NULL, KW_DONE},
+	[NAME_HASH(4, 'e', 'c')] = {"esac", NULL, KW_ESAC},
+	[NAME_HASH(1, '{', '{')] = {"{", NULL, KW_LBRACE},
+	[NAME_HASH(2, 'i', 'f')] = {"if", NULL, KW_IF},
+	[NAME_HASH(5, 'w', 'e')] = {"while", NULL, KW_WHILE},
+	[NAME_HASH(5, 'u', 'l')] = {"until", NULL, KW_UNTIL},
+	[NAME_HASH(3, 'f', 'r')] = {"for", NULL, KW_FOR},
+	[NAME_HASH(4, 'c', 'e')] = {"case", NULL, KW_CASE},
+	[NAME_HASH(2, 'i', 'n')] = {"in", NULL, KW_IN},
+	[NAME_HASH(1, '!', '!')] = {"!", NULL, KW_BANG},
+};
+
+/**
+ * find_name - Looks a name up in the table of built-ins and reserved words.
+ * @name: The name.
+ * Return: Its table entry, or NULL if it is neither.
+ */
+builtin_table *find_name(char *name)
+{
+	size_t len = 0;
+	builtin_table *e;
+
+	while (name[len] && len <= NAME_MAX_LEN)
+		len++;
+	if (!len || len > NAME_MAX_LEN)
+		return (NULL);
+	e = &names[NAME_HASH(len, (unsigned char)name[0], (unsigned char)name[len - 1])];
+	return (e->type && !_strcmp(e->type, name) ? e : NULL);
+}
+
+/**
+ * find_builtin - Finds a built-in command. It is looked up before it runs
+ * so that NAME=value assignments before it can be applied to the shell.
+ * @name: The command name.
+ * Return: The built-in's table entry, or NULL if there is none. Its
+ * function returns the exit status, or -2 if the shell should exit.
+ */
+builtin_table *find_builtin(char *name)
+{
+	builtin_table *e = find_name(name);
+
+	return (e && e->func ? e : NULL);
+}
+
 /**
- * find_builtin - Finds and executes a built-in command.
- * @info: The parameter & return info struct.
- * Return: -1 if built-in not found,
- * 0 if built-in executed successfully,
- * 1 if built-in found but not successful,
- * -2 if built-in signals exit().
+ * decl_builtin - Checks whether a command name is a declaration built-in,
+ * whose arguments may be array assignments name=(...).
+ * @name: The command name.
+ * Return: 1 if it is one, else 0.
  */
-int find_builtin(info_t *info)
+int decl_builtin(char *name)
 {
-	int i, built_in_ret = -1;
-	builtin_table builtintbl[] = {
-		{"exit", _myexit},                 // from builtins/builtin_exit.c
-		{"env", _myenv},                   // from builtins/builtin_env.c 
-		{"help", _myhelp},                 // from builtins/builtin_help.c
-		{"history", _myhistory},           // from builtins/builtin_history_alias.c
-		{"setenv", _mysetenv},             // from builtins/builtin_env.c 
-		{"unsetenv", _myunsetenv},         // from builtins/builtin_env.c 
-		{"cd", _mycd},                     // from builtins/builtin_cd.c
-		{"alias", _myalias},               // from builtins/builtin_history_alias.c
-        {NULL, NULL},                       // Sentinel to mark the end of the table
-        {"", NULL},                         // Empty entry for compatibility
-        {"\n", NULL},                       // Newline entry for compatibility
-        {";", NULL},                        // Semicolon entry for compatibility
-        {"&&", NULL},                       // Logical AND entry for compatibility
-        {"||", NULL},                       // Logical OR entry for compatibility
-        {"\0", NULL},                       // Null entry for compatibility
-        {"exit\n", _myexit},               // Exit with newline for compatibility
-        {"env\n", _myenv},                 // Environment with newline for compatibility
-        {"help\n", _myhelp},               // Help with newline for compatibility
-        {"history\n", _myhistory},         // History with newline for compatibility
-        {"setenv\n", _mysetenv},           // Setenv with newline for compatibility
-        {"unsetenv\n", _myunsetenv},       // Unsetenv with newline for compatibility
-        {"cd\n", _mycd},                   // Change directory with newline for compatibility
-        {"alias\n", _myalias},             // Alias with newline for compatibility
-		{NULL, NULL}
-	};
-
-	for (i = 0; builtintbl[i].type; i++)
-		if (_strcmp(info->argv[0], builtintbl[i].type) == 0)
-		{
-			info->line_count++;
-			built_in_ret = builtintbl[i].func(info);
-			break;
-		}
-	return (built_in_ret);
+	builtin_table *e = find_builtin(name);
+
+	return (e && (e->func == _mydeclare || e->func == _mylocal
+		|| e->func == _myexport || e->func == _myreadonly));
+}
+
+/**
+ * reserved_word - Identifies a reserved word.
+ * @name: The word.
+ * Return: Its KW_* code, or 0 if it is not a reserved word.
+ */
+int reserved_word(char *name)
+{
+	builtin_table *e = find_name(name);
+
+	return (e ? e->word : 0);
 }
@@ -0,0 +1,435 @@
+#include "../includes/shell.h"
+
+// Status of read when -t runs out, as for a command killed by SIGALRM
+#define READ_TIMEOUT (128 + 14)
+
+/**
+ * struct rdopts - Options of one read command
+ * @delim: The byte that ends the input (-d; newline by default).
+ * @raw: Backslash is an ordinary character (-r).
+ * @nchars: Stop after this many bytes (-n), or 0 for no limit.
+ * @ms: Time limit in milliseconds (-t), or -1 for none.
+ * @deadline: When the time limit runs out (CLOCK_MONOTONIC milliseconds).
+ * @array: Name of the array to fill with the fields (-a), or NULL.
+ */
+typedef struct rdopts
+{
+	int delim;
+	int raw;
+	size_t nchars;
+	long ms;
+	long deadline;
+	char *array;
+} rdopts_t;
+
+/**
+ * now_ms - Reads the monotonic clock.
+ * Return: The time in milliseconds.
+ */
+static long now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000L + ts.tv_nsec / 1000000L);
+}
+
+/**
+ * parse_timeout - Parses the seconds of -t, which may have a fraction.
+ * @s: The text.
+ * @ms: Receives the time in milliseconds.
+ * Return: 0 on success, -1 if the text is not a number of seconds.
+ */
+static int parse_timeout(char *s, long *ms)
+{
+	long sec = 0, frac = 0, scale = 1000;
+
+	if (!*s)
+		return (-1);
+	for (; *s >= '0' && *s <= '9'; s++)
+		if ((sec = sec * 10 + (*s - '0')) > 100000000L)
+			return (-1);
+	if (*s == '.')
+		for (s++; *s >= '0' && *s <= '9'; s++)
+			frac += (*s - '0') * (scale /= 10);
+	*ms = sec * 1000 + frac;
+	return (*s ? -1 : 0);
+}
+
+/**
+ * rd_sync - Makes the read-ahead buffer valid for a descriptor. Bytes
+ * read ahead are only kept if the descriptor is still where the last
+ * read left it; a command that read from it meanwhile moved it.
+ * @rb: The read-ahead buffer.
+ * @fd: The descriptor about to be read.
+ */
+static void rd_sync(rdbuf_t *rb, int fd)
+{
+	if (rb->fd == fd && rb->pos < rb->len && lseek(fd, 0, SEEK_CUR) == rb->off)
+		return;
+	rb->fd = fd;
+	rb->pos = rb->len = 0;
+	rb->off = lseek(fd, 0, SEEK_CUR); // -1 on a pipe or terminal
+}
+
+/**
+ * rd_fill - Reads more input into the empty read-ahead buffer. A seekable
+ * descriptor is read RDBUF_SIZE bytes at a time with pread, at the
+ * offset the buffer has reached, and is then set just past the consumed
+ * bytes by rd_line(); anything else is read a byte at a time, so that no
+ * byte meant for a later command is taken. Pending output is written out
+ * first, as the read may block.
+ * @rb: The read-ahead buffer.
+ * @o: The options (for the time limit).
+ * Return: Number of bytes read, 0 at end of input, -1 on error, or -2
+ * when the time limit runs out.
+ */
+static ssize_t rd_fill(rdbuf_t *rb, rdopts_t *o)
+{
+	struct pollfd pfd;
+	ssize_t n;
+	long left;
+
+	if (!rb->buf && !(rb->buf = malloc(RDBUF_SIZE)))
+		return (-1);
+	flush_output(); // flush_output from io_handling/output_buffer.c
+	pfd.fd = rb->fd;
+	pfd.events = POLLIN;
+	do {
+		if (o->ms >= 0)
+		{
+			left = o->deadline - now_ms();
+			n = poll(&pfd, 1, left > 0 ? (int)left : 0);
+			if (n == 0)
+				return (-2);
+			if (n < 0)
+				continue;
+		}
+		n = rb->off >= 0 ? pread(rb->fd, rb->buf, RDBUF_SIZE, rb->off)
+			: read(rb->fd, rb->buf, 1);
+	} while (n < 0 && errno == EINTR);
+	rb->pos = 0;
+	rb->len = n > 0 ? (size_t)n : 0;
+	return (n);
+}
+
+/**
+ * line_put - Appends bytes to the line being read, growing it
+ * geometrically.
+ * @line: The line buffer (may be NULL).
+ * @len: Length of the line; updated.
+ * @cap: Size of the buffer; updated.
+ * @s: The bytes.
+ * @n: Number of bytes.
+ * Return: The buffer, or NULL on allocation failure (the old one is freed).
+ */
+static char *line_put(char *line, size_t *len, size_t *cap, char *s, size_t n)
+{
+	size_t c = *cap ? *cap : 128;
+	char *p;
+
+	while (c < *len + n + 1)
+		c *= 2;
+	if (c != *cap)
+	{
+		p = _realloc(line, *cap, c);
+		if (!p)
+		{
+			free(line);
+			return (NULL);
+		}
+		line = p;
+		*cap = c;
+	}
+	memcpy(line + *len, s, n);
+	*len += n;
+	line[*len] = '\0';
+	return (line);
+}
+
+/**
+ * odd_escape - Checks whether the line ends with an unescaped backslash.
+ * @line: The line.
+ * @len: Its length.
+ * Return: 1 if the byte after the line would be escaped, 0 otherwise.
+ */
+static int odd_escape(char *line, size_t len)
+{
+	size_t n = 0;
+
+	while (n < len && line[len - 1 - n] == '\\')
+		n++;
+	return (n & 1);
+}
+
+/**
+ * rd_line - Reads up to the delimiter, which is consumed but not kept.
+ * Each buffer of input is searched with memchr. Unless -r is given, a
+ * backslash before the delimiter escapes it; before a newline, both are
+ * dropped and the line continues.
+ * @info: The parameter struct (holds the read-ahead buffer).
+ * @fd: The descriptor.
+ * @o: The options.
+ * @line: Receives the line (NUL-terminated, malloc'd), even if partial.
+ * Return: 0 on success, 1 at end of input, READ_TIMEOUT when the time
+ * limit runs out, or -1 on error.
+ */
+static int rd_line(info_t *info, int fd, rdopts_t *o, char **line)
+{
+	rdbuf_t *rb = &info->rdbuf;
+	size_t len = 0, cap = 0, got = 0, avail;
+	char *p, *q;
+	ssize_t n;
+	int ret = -2;
+
+	rd_sync(rb, fd);
+	*line = line_put(NULL, &len, &cap, "", 0);
+	while (*line && ret == -2)
+	{
+		if (rb->pos == rb->len && (n = rd_fill(rb, o)) <= 0)
+		{
+			ret = n == 0 ? 1 : n == -2 ? READ_TIMEOUT : -1;
+			break;
+		}
+		p = rb->buf + rb->pos;
+		avail = rb->len - rb->pos;
+		if (o->nchars && avail > o->nchars - got)
+			avail = o->nchars - got;
+		q = memchr(p, o->delim, avail);
+		n = q ? q - p + 1 : (ssize_t)avail;
+		rb->pos += n;
+		rb->off += rb->off >= 0 ? n : 0;
+		got += n;
+		*line = line_put(*line, &len, &cap, p, n - (q != NULL));
+		if (q && *line && !o->raw && odd_escape(*line, len))
+		{
+			if (o->delim == '\n') // Line continuation
+				(*line)[--len] = '\0';
+			else
+				*line = line_put(*line, &len, &cap, q, 1);
+		}
+		else if (q || (o->nchars && got >= o->nchars))
+			ret = 0;
+	}
+	if (rb->off >= 0) // Leave the file right after what was consumed
+		lseek(fd, rb->off, SEEK_SET);
+	return (*line ? ret : -1);
+}
+
+/**
+ * in_ifs - Checks whether a byte separates fields.
+ * @c: The byte.
+ * @ifs: The separators.
+ * @ws: Only count blanks and newlines (IFS white space).
+ * Return: 1 if it does, 0 otherwise.
+ */
+static int in_ifs(char c, char *ifs, int ws)
+{
+	if (!c || (ws && c != ' ' && c != '\t' && c != '\n'))
+		return (0);
+	return (_strchr(ifs, c) != NULL);
+}
+
+/**
+ * next_field - Takes the next field off a line, removing backslash
+ * escapes (unless raw) in place. Escaped bytes never separate fields.
+ * The last field is the rest of the line, separators included, less the
+ * IFS white space it ends with.
+ * @pp: The position in the line; advanced past the field and the
+ * separators after it.
+ * @ifs: The separators.
+ * @raw: Backslash is an ordinary character.
+ * @last: Take the rest of the line.
+ * Return: The field, NUL-terminated.
+ */
+static char *next_field(char **pp, char *ifs, int raw, int last)
+{
+	char *r = *pp, *w = r, *start = r, *keep = r;
+
+	while (*r)
+	{
+		if (!raw && *r == '\\')
+		{
+			if (r[1])
+				*w++ = r[1];
+			r += r[1] ? 2 : 1;
+			keep = w;
+			continue;
+		}
+		if (in_ifs(*r, ifs, 0) && !last)
+			break;
+		keep = in_ifs(*r, ifs, 1) ? keep : w + 1;
+		*w++ = *r++;
+	}
+	if (!last)
+	{
+		keep = w;
+		while (in_ifs(*r, ifs, 1))
+			r++;
+		if (in_ifs(*r, ifs, 0)) // One other separator, with white space around
+			for (r++; in_ifs(*r, ifs, 1); r++)
+				;
+	}
+	*keep = '\0';
+	*pp = r;
+	return (start);
+}
+
+/**
+ * rd_assign - Splits the line into fields with IFS and assigns them:
+ * one field per name, the last name taking the rest of the line, and
+ * names left over set empty. With -a the fields fill an array; with no
+ * names at all, REPLY gets the whole line unsplit.
+ * @info: The parameter struct.
+ * @names: The variable names (argv from the first name).
+ * @o: The options.
+ * @line: The line; it is modified in place.
+ * Return: 0 on success, 1 on a failed assignment (reported).
+ */
+static int rd_assign(info_t *info, char **names, rdopts_t *o, char *line)
+{
+	char *ifs = var_get(info, "IFS"), *p = line, *f;
+	array_t *a = NULL;
+	int ret = 0;
+
+	if (!ifs)
+		ifs = " \t\n";
+	if (!o->array && !*names)
+		return (var_set(info, "REPLY", next_field(&p, "", o->raw, 1)) != 0);
+	while (in_ifs(*p, ifs, 1))
+		p++;
+	if (o->array)
+	{
+		a = var_make_array(info, o->array, 0); // var_make_array from variables/shell_variables.c
+		if (!a)
+			return (1);
+		array_clear(a); // array_clear from variables/arrays.c
+		while (*p && !ret)
+		{
+			f = next_field(&p, ifs, o->raw, 0);
+			ret = array_push(a, f, _strlen(f)) != 0;
+		}
+		return (ret);
+	}
+	for (; *names && !ret; names++)
+	{
+		f = *p ? next_field(&p, ifs, o->raw, !names[1]) : "";
+		ret = var_set(info, *names, f) != 0; // var_set from variables/shell_variables.c
+	}
+	return (ret);
+}
+
+/**
+ * read_opts - Parses the options of read. Options without an argument
+ * may be grouped (-rd: is -r -d :).
+ * @info: Structure containing potential arguments.
+ * @o: Receives the options.
+ * @fd: Receives the descriptor (-u).
+ * Return: Index of the first name, or -1 after reporting a bad option.
+ */
+static int read_opts(info_t *info, rdopts_t *o, int *fd)
+{
+	int i, bad;
+	char *c, *arg;
+
+	for (i = 1; info->argv[i] && info->argv[i][0] == '-' && info->argv[i][1]; i++)
+	{
+		if (!_strcmp(info->argv[i], "--"))
+			return (i + 1);
+		for (c = info->argv[i] + 1; *c == 'r'; c++)
+			o->raw = 1;
+		if (!*c)
+			continue;
+		arg = c[1] ? c + 1 : info->argv[i + 1];
+		bad = 0;
+		if (!arg || !_strchr("adntu", *c))
+			bad = 1;
+		else if (*c == 'd')
+			o->delim = (unsigned char)*arg;
+		else if (*c == 'a')
+			o->array = arg;
+		else if (*c == 't')
+			bad = parse_timeout(arg, &o->ms);
+		else if (*c == 'n')
+			bad = (long)(o->nchars = _erratoi(arg)) < 0; // _erratoi from error_handling/error_utilities.c
+		else
+			bad = (*fd = _erratoi(arg)) < 0;
+		if (bad)
+		{
+			error_line(info, info->argv[0], ": ", info->argv[i], ": invalid option", NULL);
+			return (-1);
+		}
+		i += !c[1];
+	}
+	return (i);
+}
+
+/**
+ * check_names - Checks the names read will assign.
+ * @info: Structure containing potential arguments.
+ * @names: The variable names.
+ * @array: The -a array name, or NULL.
+ * Return: 0 if they are valid, 1 after reporting a bad one.
+ */
+static int check_names(info_t *info, char **names, char *array)
+{
+	char *bad = array && !valid_name(array) ? array : NULL;
+
+	for (; *names && !bad; names++)
+		if (!valid_name(*names))
+			bad = *names;
+	if (!bad)
+		return (0);
+	error_line(info, info->argv[0], ": bad variable name: ", bad, NULL);
+	return (1);
+}
+
+/**
+ * _myread - Reads a line and splits it into variables:
+ * read [-r] [-a array] [-d delim] [-n nchars] [-t timeout] [-u fd] [name...]
+ * The line is split with IFS; see rd_assign() for how fields go to
+ * names. -r keeps backslashes, -d ends the line at delim's first byte
+ * (NUL if empty) instead of newline, -n stops after nchars bytes, -t gives
+ * up after timeout seconds (-t 0 only tells whether input is waiting)
+ * and -u reads fd instead of standard input.
+ * Regular files are read in large blocks; the bytes read ahead stay
+ * buffered for the next read, and the file is left (with lseek) right
+ * after the bytes consumed, so commands run from a while-read loop find
+ * the input where the loop left it. Pipes and terminals are read a byte
+ * at a time.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: 0 on success, 1 at end of input or on error, 2 on a bad option,
+ * or 142 (128 + SIGALRM) when the time limit runs out.
+ */
+int _myread(info_t *info)
+{
+	rdopts_t o = {'\n', 0, 0, -1, 0, NULL};
+	int i, fd = STDIN_FILENO, ret, sret;
+	char *line;
+	struct pollfd pfd;
+
+	i = read_opts(info, &o, &fd);
+	if (i < 0)
+		return (2);
+	if (check_names(info, info->argv + i, o.array))
+		return (1);
+	if (o.ms == 0) // Only tell whether there is input
+	{
+		rd_sync(&info->rdbuf, fd);
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		return (info->rdbuf.pos < info->rdbuf.len || poll(&pfd, 1, 0) > 0 ? 0 : 1);
+	}
+	o.deadline = o.ms > 0 ? now_ms() + o.ms : 0;
+	ret = rd_line(info, fd, &o, &line);
+	if (ret < 0)
+	{
+		print_error(info, "read error\n");
+		free(line);
+		return (1);
+	}
+	sret = rd_assign(info, info->argv + i, &o, line);
+	free(line);
+	return (sret ? sret : ret);
+}
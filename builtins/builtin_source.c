@@ -0,0 +1,78 @@
+#include "../includes/shell.h"
+
+/**
+ * open_source - Opens the file named by `.`: a name without a slash is
+ * looked up in PATH, anything else is used as given.
+ * @info: Structure containing potential arguments.
+ * @name: The file name.
+ * @path: Receives a malloc'd copy of the path that was opened.
+ * Return: The file descriptor, or -1 if the file could not be opened.
+ */
+static int open_source(info_t *info, char *name, char **path)
+{
+	char *p = name;
+
+	if (!_strchr(name, '/'))
+		p = find_path(info, _getenv(info, "PATH="), name); // find_path from environment/path_resolver.c
+	*path = p ? _strdup(p) : NULL;
+	if (!*path)
+		return (-1);
+	return (open(*path, O_RDONLY));
+}
+
+/**
+ * _mysource - Runs the commands of a file in the current shell:
+ * . file [arg...] (also spelled source). Arguments, when given, become
+ * the positional parameters while the file runs; return leaves the file.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: The status of the last command the file ran, or 2 if it
+ * could not be opened.
+ */
+int _mysource(info_t *info)
+{
+	char **params = info->params, *path;
+	int nparams = info->nparams, fd, ret;
+	unsigned int line = info->line_count;
+
+	if (!info->argv[1])
+	{
+		print_error(info, "filename argument required\n");
+		return (2);
+	}
+	fd = open_source(info, info->argv[1], &path);
+	if (fd == -1)
+	{
+		error_line(info, info->argv[0], ": Can't open ", info->argv[1], NULL);
+		free(path);
+		return (2);
+	}
+	if (info->argc > 2) // argv is reused by the file's commands: copy now
+	{
+		info->params = dup_vector(info->argv + 2, info->argc - 2);
+		info->nparams = info->params ? info->argc - 2 : nparams;
+		if (!info->params)
+			info->params = params;
+	}
+	info->status = 0; // An empty file succeeds
+	info->source_depth++;
+	ret = run_script(info, path, fd); // run_script from shell_core/script_loader.c
+	info->source_depth--;
+	close(fd);
+	if (info->ctl == CTL_RETURN)
+		info->ctl = CTL_NONE;
+	if (info->params != params)
+	{
+		free(info->params);
+		info->params = params;
+		info->nparams = nparams;
+	}
+	info->line_count = line;
+	if (ret == -1)
+	{
+		error_line(info, info->argv[0], ": Can't open ", path, NULL);
+		info->status = 2;
+	}
+	free(path);
+	return (info->status);
+}
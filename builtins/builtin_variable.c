@@ -0,0 +1,313 @@
+#include "../includes/shell.h"
+
+/**
+ * put_quoted - Prints a value in single quotes, with single quotes in it
+ * escaped, so the shell reads it back unchanged.
+ * @value: The value.
+ */
+static void put_quoted(char *value)
+{
+	_putchar('\'');
+	for (; *value; value++)
+		if (*value == '\'')
+			_puts("'\\''");
+		else
+			_putchar(*value);
+	_putchar('\'');
+}
+
+/**
+ * print_var - Prints a variable as a command that recreates it:
+ * prefix NAME='value', with single quotes in the value escaped.
+ * @prefix: The command, e.g. "export".
+ * @name: The name (up to '=' or the end of the string).
+ * @value: The value, or NULL if the variable is unset.
+ */
+static void print_var(char *prefix, char *name, char *value)
+{
+	_puts(prefix);
+	_putchar(' ');
+	while (*name && *name != '=')
+		_putchar(*name++);
+	if (value)
+	{
+		_putchar('=');
+		put_quoted(value);
+	}
+	_putchar('\n');
+}
+
+/**
+ * print_flagged - Prints every variable of the table that has a flag.
+ * @info: Structure containing potential arguments.
+ * @prefix: The command to print before each variable.
+ * @flag: The VAR_* flag to look for.
+ * @unset_only: Print only the variables that are not set.
+ */
+static void print_flagged(info_t *info, char *prefix, int flag, int unset_only)
+{
+	hash_entry_t *e;
+	var_t *v;
+	size_t i;
+	char *value;
+
+	for (i = 0; i < info->vars.size; i++)
+		for (e = info->vars.buckets[i]; e; e = e->next)
+		{
+			v = e->value;
+			value = var_get(info, e->key);
+			if ((v->flags & flag) && (!unset_only || !value))
+				print_var(prefix, e->key, value);
+		}
+}
+
+/**
+ * decl_name - Copies the name of an argument of a declaration command:
+ * what comes before its '=', or before the '+=' of name+=(...).
+ * @info: Structure containing potential arguments.
+ * @i: Index of the argument.
+ * @eq: Receives the argument's '=', or NULL if it has none.
+ * Return: The name, in the scratch arena (argv may point into the
+ * function's stored body), or NULL on allocation failure.
+ */
+char *decl_name(info_t *info, int i, char **eq)
+{
+	char *arg = info->argv[i];
+	size_t len;
+
+	*eq = _strchr(arg, '=');
+	len = *eq ? (size_t)(*eq - arg) : (size_t)_strlen(arg);
+	if (info->arrays && info->arrays[i] && len && arg[len - 1] == '+')
+		len--;
+	return (arena_strndup(&info->scratch, arg, len));
+}
+
+/**
+ * decl_assign - Makes the assignment of an argument of a declaration
+ * command, if it has one: name=value, or name=(...) and name+=(...) with
+ * the elements set_decl() expanded for it.
+ * @info: Structure containing potential arguments.
+ * @i: Index of the argument.
+ * @name: Its name.
+ * @eq: Its '=', or NULL.
+ * Return: 0 on success, non-zero on error (reported).
+ */
+int decl_assign(info_t *info, int i, char *name, char *eq)
+{
+	if (info->arrays && info->arrays[i]) // var_set_array from variables/shell_variables.c
+		return (var_set_array(info, name, info->arrays[i], eq[-1] == '+'));
+	return (eq ? var_set(info, name, eq + 1) : 0);
+}
+
+/**
+ * each_name - Applies export or readonly to each name[=value] argument.
+ * @info: Structure containing potential arguments.
+ * @i: Index of the first argument.
+ * @set: var_export or var_readonly.
+ * Return: 0 on success, 1 if an argument was rejected.
+ */
+static int each_name(info_t *info, int i, int (*set)(info_t *, char *, char *))
+{
+	int ret = 0;
+	char *eq, *name;
+
+	for (; info->argv[i]; i++)
+	{
+		name = decl_name(info, i, &eq);
+		if (!name || !valid_name(name))
+		{
+			error_line(info, info->argv[0], ": bad variable name: ", info->argv[i], NULL);
+			ret = 1;
+		}
+		else if (decl_assign(info, i, name, eq) || set(info, name, NULL))
+			ret = 1;
+	}
+	return (ret);
+}
+
+/**
+ * _myexport - Passes variables to the environment of commands:
+ * export [-p] [name[=value]...]. Without names, lists the exported
+ * variables.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: 0 on success, 1 on error.
+ */
+int _myexport(info_t *info)
+{
+	int i = 1 + (info->argv[1] && !_strcmp(info->argv[1], "-p"));
+	list_t *node;
+
+	if (info->argv[i])
+		return (each_name(info, i, var_export)); // var_export from variables/shell_variables.c
+	for (node = info->env; node; node = node->next)
+		print_var("export", node->str, _strchr(node->str, '=') + 1);
+	print_flagged(info, "export", VAR_EXPORT, 1); // Exported but not yet set
+	return (0);
+}
+
+/**
+ * _myreadonly - Makes variables read-only: readonly [-p] [name[=value]...].
+ * Without names, lists the read-only variables.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: 0 on success, 1 on error.
+ */
+int _myreadonly(info_t *info)
+{
+	int i = 1 + (info->argv[1] && !_strcmp(info->argv[1], "-p"));
+
+	if (info->argv[i])
+		return (each_name(info, i, var_readonly)); // var_readonly from variables/shell_variables.c
+	print_flagged(info, "readonly", VAR_READONLY, 0);
+	return (0);
+}
+
+/**
+ * _myunset - Unsets variables, or with -f functions: unset [-v|-f] name...
+ * A name[subscript] unsets one element of an array.
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: 0 on success, 1 if a variable is read-only.
+ */
+int _myunset(info_t *info)
+{
+	int i = 1, funcs = 0, ret = 0;
+	char *sub, *name;
+
+	if (info->argv[1] && (!_strcmp(info->argv[1], "-f") || !_strcmp(info->argv[1], "-v")))
+		funcs = info->argv[i++][1] == 'f';
+	for (; info->argv[i]; i++)
+		if (funcs)
+			remove_function(info, info->argv[i]); // remove_function from shell_core/functions.c
+		else if (!(sub = _strchr(info->argv[i], '[')))
+			ret |= var_unset(info, info->argv[i]); // var_unset from variables/shell_variables.c
+		else if ((name = arena_strndup(&info->scratch, info->argv[i], _strlen(info->argv[i]))))
+			ret |= var_unset_elem(info, name, name + (sub - info->argv[i]) + 1); // name[subscript]
+	return (ret);
+}
+
+
+/**
+ * print_declare - Prints a variable as the declare command that recreates
+ * it with its attributes, e.g. declare -a name=([0]='x' [1]='y').
+ * @info: Structure containing potential arguments.
+ * @name: The variable's name.
+ * Return: 0 on success, 1 if there is no such variable.
+ */
+static int print_declare(info_t *info, char *name)
+{
+	var_t *v = var_find(info, name); // var_find from variables/shell_variables.c
+	char *value = var_get(info, name), prefix[16] = "declare -", *f = prefix + 9;
+	char num[NUM_BUF_SIZE];
+	array_t *a = v ? v->arr : NULL;
+	size_t i, n = 0;
+
+	if (!v && !value)
+		return (1);
+	if (a)
+		*f++ = a->assoc ? 'A' : 'a';
+	if (v && (v->flags & VAR_READONLY))
+		*f++ = 'r';
+	if (v ? (v->flags & VAR_EXPORT) : 1) // Without an entry it was inherited
+		*f++ = 'x';
+	if (f == prefix + 9)
+		*f++ = '-';
+	*f = '\0';
+	if (!a)
+	{
+		print_var(prefix, name, value);
+		return (0);
+	}
+	_puts(prefix);
+	_putchar(' ');
+	_puts(name);
+	_puts("=(");
+	for (i = 0; i < a->n; i++)
+		if (a->vals[i])
+		{
+			_puts(n++ ? " [" : "[");
+			if (a->assoc)
+				put_quoted(a->keys[i]);
+			else
+			{
+				fmt_unsigned(i, num); // fmt_unsigned in memory_utils/string_converters.c
+				_puts(num);
+			}
+			_puts("]=");
+			put_quoted(a->vals[i]);
+		}
+	_puts(")\n");
+	return (0);
+}
+
+/**
+ * declare_all - Prints every variable as a declare command: those of the
+ * environment first, then the shell's own.
+ * @info: Structure containing potential arguments.
+ */
+static void declare_all(info_t *info)
+{
+	list_t *node;
+	hash_entry_t *e;
+	size_t i;
+	char *name;
+
+	for (node = info->env; node; node = node->next)
+	{
+		name = arena_strndup(&info->scratch, node->str, _strchr(node->str, '=') - node->str);
+		if (name)
+			print_declare(info, name);
+	}
+	for (i = 0; i < info->vars.size; i++)
+		for (e = info->vars.buckets[i]; e; e = e->next)
+			if (!(((var_t *)e->value)->flags & VAR_EXPORT) || !var_get(info, e->key))
+				print_declare(info, e->key);
+}
+
+/**
+ * _mydeclare - Declares variables and sets their attributes:
+ * declare [-aAprx] [name[=value]...] (also spelled typeset). -a and -A
+ * make indexed and associative arrays, -r and -x make the variables
+ * read-only and exported; -p, or no names, prints them. A value may be
+ * an array name=(...).
+ * @info: Structure containing potential arguments. Used to maintain
+ * constant function prototype.
+ * Return: 0 on success, 1 if a name was rejected, 2 on a bad option.
+ */
+int _mydeclare(info_t *info)
+{
+	int i, ret = 0, print = 0, array = -1, ro = 0, ex = 0;
+	char *o, *eq, *name;
+
+	for (i = 1; info->argv[i] && info->argv[i][0] == '-' && info->argv[i][1]; i++)
+		for (o = info->argv[i] + 1; *o; o++)
+			if (*o == 'a' || *o == 'A')
+				array = *o == 'A';
+			else if (*o == 'p' || *o == 'r' || *o == 'x')
+				*(*o == 'p' ? &print : *o == 'r' ? &ro : &ex) = 1;
+			else
+			{
+				error_line(info, info->argv[0], ": ", info->argv[i], ": invalid option", NULL);
+				return (2);
+			}
+	if (!info->argv[i])
+		declare_all(info);
+	for (; info->argv[i]; i++)
+	{
+		name = decl_name(info, i, &eq);
+		if (!name || !valid_name(name))
+		{
+			error_line(info, info->argv[0], ": bad variable name: ", info->argv[i], NULL);
+			ret = 1;
+		}
+		else if (print)
+			ret |= print_declare(info, name);
+		else if ((array >= 0 && !var_make_array(info, name, array)) // var_make_array from variables/shell_variables.c
+			|| decl_assign(info, i, name, eq)
+			|| (ex && var_export(info, name, NULL))
+			|| (ro && var_readonly(info, name, NULL)))
+			ret = 1;
+	}
+	return (ret);
+}
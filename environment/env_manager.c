@@ -12,32 +12,53 @@ int _myenv(info_t *info)
 	return (0);
 }
 
+/**
+ * env_link - Finds the link (info->env or a node's next) that points at
+ * an environment variable's node.
+ * @info: Structure containing potential arguments.
+ * @name: The name (not NUL-terminated).
+ * @len: Length of the name.
+ * Return: The link, or NULL if the variable is not in the environment.
+ */
+static list_t **env_link(info_t *info, const char *name, size_t len)
+{
+	hash_entry_t *e = hash_find_len(&info->envtab, name, len); // hash_find_len from linked_lists/hash_table.c
+
+	return (e ? e->value : NULL);
+}
+
+/**
+ * env_find - Finds an environment variable's value by exact name, with
+ * one hash lookup.
+ * @info: Structure containing potential arguments.
+ * @name: The name (not NUL-terminated).
+ * @len: Length of the name.
+ * Return: The value, or NULL if it is not in the environment.
+ */
+char *env_find(info_t *info, const char *name, size_t len)
+{
+	list_t **link = env_link(info, name, len);
+
+	return (link ? (*link)->str + len + 1 : NULL);
+}
+
 /**
  * _getenv - Gets the value of an environment variable.
  * @info: Structure containing potential arguments. Used to maintain
  * constant function prototype.
  * @name: The name of the environment variable (e.g., "HOME=").
- * Return: The value of the environment variable, or NULL if not found.
+ * Return: The value of the environment variable, or NULL if not found
+ * or empty.
  */
 char *_getenv(info_t *info, const char *name)
 {
-    list_t *node = info->env;
-    char *p;
-
-
-    while (node)
-    {
-        p = starts_with(node->str, name); // `node->str` is "HOME=/foo", `name` is "HOME="
-                                         // If it matches, `p` points to "/foo"
-
+	size_t len = _strlen((char *)name);
+	char *p;
 
-        if (p && *p) // Check if `p` is not NULL and the character it points to is not '\0'
-        {
-            return (p);
-        }
-        node = node->next;
-    }
-    return (NULL);
+	if (len && name[len - 1] == '=')
+		len--;
+	p = env_find(info, name, len);
+	return (p && *p ? p : NULL);
 }
 
 /**
@@ -54,10 +75,8 @@ int _mysetenv(info_t *info)
 		_eputs("Incorrect number of arguements\n");
 		return (1);
 	}
-	// Call the internal _setenv helper
-	if (_setenv(info, info->argv[1], info->argv[2]))
-		return (0);
-	return (1);
+	// Same as export NAME=VALUE, so a shell variable of that name moves over
+	return (var_export(info, info->argv[1], info->argv[2]) != 0); // from variables/shell_variables.c
 }
 
 /**
@@ -75,53 +94,142 @@ int _myunsetenv(info_t *info)
 		_eputs("Too few arguements.\n");
 		return (1);
 	}
-	for (i = 1; i <= info->argc; i++)
-		_unsetenv(info, info->argv[i]); // Call the internal _unsetenv helper
+	for (i = 1; i < info->argc; i++)
+		var_unset(info, info->argv[i]); // var_unset from variables/shell_variables.c
+
+	return (0);
+}
+
+/**
+ * envp_reserve - Makes room in info->environ for one more variable and
+ * the terminating NULL, growing it geometrically.
+ * @info: Structure containing potential arguments.
+ * Return: 0 on success, 1 on allocation failure.
+ */
+static int envp_reserve(info_t *info)
+{
+	size_t cap = info->env_cap ? info->env_cap * 2 : 64;
+	char **v;
+
+	if (info->env_count + 2 <= info->env_cap)
+		return (0);
+	v = _realloc(info->environ, info->env_cap * sizeof(char *), cap * sizeof(char *));
+	if (!v)
+		return (1);
+	info->environ = v;
+	info->env_cap = cap;
+	return (0);
+}
+
+/**
+ * env_append - Adds a variable at the end of the environment list and of
+ * info->environ, and indexes it by name.
+ * @info: Structure containing potential arguments.
+ * @str: The "NAME=value" string, which the list takes over.
+ * @len: Length of the name.
+ * Return: 0 on success, 1 on allocation failure (str is freed).
+ */
+int env_append(info_t *info, char *str, size_t len)
+{
+	list_t *node = envp_reserve(info) ? NULL : malloc(sizeof(list_t));
+	hash_entry_t *e = NULL;
 
+	if (node)
+	{
+		str[len] = '\0'; // hash_insert wants the name terminated
+		e = hash_insert(&info->envtab, str); // hash_insert from linked_lists/hash_table.c
+		str[len] = '=';
+	}
+	if (!e)
+	{
+		free(node);
+		free(str);
+		return (1);
+	}
+	if (!info->env_tail)
+		info->env_tail = &info->env;
+	node->num = info->env_count;
+	node->str = str;
+	node->next = NULL;
+	*info->env_tail = node;
+	e->value = info->env_tail;
+	info->env_tail = &node->next;
+	info->environ[info->env_count++] = str; // The array shares the list's strings
+	info->environ[info->env_count] = NULL;
 	return (0);
 }
 
 /**
- * populate_env_list - Populates the environment linked list.
+ * populate_env_list - Populates the environment list from environ, in
+ * order. Of a name given twice, the first one is kept.
  * @info: Structure containing potential arguments. Used to maintain
  * constant function prototype.
  * Return: Always 0.
  */
 int populate_env_list(info_t *info)
 {
-    list_t *node = NULL;
-    size_t i;
-
-    for (i = 0; environ[i]; i++) // 'environ' is the global variable
-    {
-        // Issue is likely here:
-        // environ[i] is a pointer to the actual env string (e.g., "PATH=/usr/bin")
-        // This pointer is passed to add_node_end
-        add_node_end(&node, environ[i], 0);
-    }
-    info->env = node;
-    return (0);
+	size_t i, len;
+	char *eq, *str;
+
+	for (i = 0; environ[i]; i++) // 'environ' is the global variable
+	{
+		eq = _strchr(environ[i], '=');
+		if (!eq || env_link(info, environ[i], eq - environ[i]))
+			continue;
+		len = eq - environ[i];
+		str = _strdup(environ[i]);
+		if (!str || env_append(info, str, len))
+			break;
+	}
+	return (0);
+}
+
+/**
+ * free_env - Frees the environment list and its index.
+ * @info: Structure containing potential arguments.
+ */
+void free_env(info_t *info)
+{
+	free_list(&info->env); // free_list from linked_lists/list_operations.c
+	hash_free(&info->envtab, NULL); // hash_free from linked_lists/hash_table.c
+	info->env_tail = NULL;
+	bfree((void **)&info->environ); // Its strings belonged to the list
+	info->env_count = info->env_cap = 0;
 }
 
 /**
- * get_environ - Returns the string array copy of our environment.
+ * get_environ - Returns the environment as an envp array. It is kept up
+ * to date as variables change, so this costs nothing.
  * @info: Structure containing potential arguments. Used to maintain
  * constant function prototype.
  * Return: A null-terminated array of strings (the environment).
  */
 char **get_environ(info_t *info)
 {
-	if (!info->environ || info->env_changed)
-	{
-		info->environ = list_to_strings(info->env);
-		info->env_changed = 0;
-	}
+	static char *empty[] = {NULL};
+
+	return (info->environ ? info->environ : empty);
+}
+
+/**
+ * env_index - Points the environment entry of a variable at a new index
+ * of info->environ.
+ * @info: Structure containing potential arguments.
+ * @str: The variable's "NAME=value" string.
+ * @i: The index.
+ */
+static void env_index(info_t *info, char *str, size_t i)
+{
+	list_t **link = env_link(info, str, _strchr(str, '=') - str);
 
-	return (info->environ);
+	(*link)->num = i;
 }
 
 /**
- * _unsetenv - Removes an environment variable from the linked list.
+ * _unsetenv - Removes an environment variable. The list is singly linked,
+ * but the index keeps the link that points at each node, so the node is
+ * unlinked directly; the next node's link becomes the removed one's. In
+ * info->environ, the last variable moves into the freed slot.
  * @info: Structure containing potential arguments. Used to maintain
  * constant function prototype.
  * @var: The string name of the environment variable property to remove.
@@ -129,27 +237,29 @@ char **get_environ(info_t *info)
  */
 int _unsetenv(info_t *info, char *var)
 {
-	list_t *node = info->env;
-	size_t i = 0;
-	char *p;
+	list_t **link, *node;
+	hash_entry_t *e;
 
-	if (!node || !var)
+	if (!var || !(link = env_link(info, var, _strlen(var))))
 		return (0);
-
-	while (node)
+	node = *link;
+	*link = node->next;
+	if (node->next)
 	{
-		p = starts_with(node->str, var);
-		if (p && *p == '=')
-		{
-			info->env_changed = delete_node_at_index(&(info->env), i);
-			i = 0; // Reset index as list might change after deletion
-			node = info->env; // Reset node to head
-			continue;
-		}
-		node = node->next;
-		i++;
+		e = hash_find_len(&info->envtab, node->next->str,
+			_strchr(node->next->str, '=') - node->next->str);
+		e->value = link;
 	}
-	return (info->env_changed);
+	else
+		info->env_tail = link;
+	hash_remove(&info->envtab, var, NULL); // hash_remove from linked_lists/hash_table.c
+	info->environ[node->num] = info->environ[--info->env_count]; // Swap-remove
+	info->environ[info->env_count] = NULL;
+	if ((size_t)node->num != info->env_count)
+		env_index(info, info->environ[node->num], node->num);
+	free(node->str);
+	free(node);
+	return (1);
 }
 
 /**
@@ -163,37 +273,25 @@ int _unsetenv(info_t *info, char *var)
  */
 int _setenv(info_t *info, char *var, char *value)
 {
-	char *buf = NULL;
-	list_t *node;
-	char *p;
+	size_t len, vlen;
+	list_t **link;
+	char *buf;
 
 	if (!var || !value)
 		return (0);
-
-	// Allocate buffer for "VAR=VALUE"
-	buf = malloc(_strlen(var) + _strlen(value) + 2);
+	len = _strlen(var);
+	vlen = _strlen(value);
+	buf = malloc(len + vlen + 2); // "VAR=VALUE"
 	if (!buf)
 		return (1);
-	_strcpy(buf, var);
-	_strcat(buf, "=");
-	_strcat(buf, value);
-
-	node = info->env;
-	while (node)
-	{
-		p = starts_with(node->str, var);
-		if (p && *p == '=') // Found an existing variable
-		{
-			free(node->str); // Free old string
-			node->str = buf; // Assign new string (buf)
-			info->env_changed = 1;
-			return (0);
-		}
-		node = node->next;
-	}
-	// Variable not found, add as new node
-	add_node_end(&(info->env), buf, 0);
-	free(buf); // add_node_end makes a copy, so free our local buf
-	info->env_changed = 1;
+	memcpy(buf, var, len);
+	buf[len] = '=';
+	memcpy(buf + len + 1, value, vlen + 1);
+	link = env_link(info, var, len);
+	if (!link) // Variable not found, add it at the end
+		return (env_append(info, buf, len));
+	free((*link)->str);
+	(*link)->str = buf;
+	info->environ[(*link)->num] = buf;
 	return (0);
 }
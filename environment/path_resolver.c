@@ -101,21 +101,8 @@ char *find_path(info_t *info, char *pathstr, char *cmd)
 void find_cmd(info_t *info)
 {
 	char *path = NULL;
-	int i, k;
 
 	info->path = info->argv[0]; // Assume command is first argument
-	if (info->linecount_flag == 1) // If counting lines for history/errors
-	{
-		info->line_count++;
-		info->linecount_flag = 0;
-	}
-	// Check if command line is empty or just whitespace
-	for (i = 0, k = 0; info->arg[i]; i++)
-		if (!is_delimiter(info->arg[i], " \t\n")) // is_delimiter in shell_core/shell_utilities.c
-			k++;
-	if (!k) // If no non-delimiter characters found (empty command)
-		return;
-
 	// Try to find command in PATH
 	path = find_path(info, _getenv(info, "PATH="), info->argv[0]);
 	if (path)
@@ -129,8 +116,9 @@ void find_cmd(info_t *info)
 		{
 			// No fork_cmd here, the main loop handles it.
 		}
-		else if (*(info->arg) != '\n') // If it's not just a newline and not found
+		else // Not found: leave nothing to execute
 		{
+			info->path = NULL;
 			info->status = 127; // Command not found status
 			print_error(info, "not found\n"); // print_error in error_handling/error_reporter.c
 		}
@@ -7,58 +7,32 @@
  */
 void _eputs(char *str)
 {
-	int i = 0;
-
-	if (!str)
-		return;
-	while (str[i] != '\0')
-	{
-		_eputchar(str[i]); // _eputchar is defined in this file
-		i++;
-	}
+	if (str)
+		out_write(2, str, _strlen(str)); // out_write from io_handling/output_buffer.c
 }
 
 /**
- * _eputchar - Writes the character c to stderr.
- * Implements buffering for efficiency.
- * @c: The character to print.
+ * _eputchar - Writes the character c to stderr, through its buffer.
+ * @c: The character to print, or BUF_FLUSH to write out the buffer.
  * Return: On success 1. On error, -1 is returned.
  */
 int _eputchar(char c)
 {
-	static int i; // Static counter for buffer index
-	static char buf[WRITE_BUF_SIZE]; // Static buffer for stderr output
-
-	if (c == BUF_FLUSH || i >= WRITE_BUF_SIZE) // If buffer is full or flush signal
-	{
-		write(2, buf, i); // Write buffer content to stderr (fd 2)
-		i = 0; // Reset buffer index
-	}
-	if (c != BUF_FLUSH) // If not a flush signal, add char to buffer
-		buf[i++] = c;
-	return (1);
+	return (_putfd(c, 2));
 }
 
 /**
- * _putfd - Writes the character c to a given file descriptor.
- * Implements buffering for efficiency.
- * @c: The character to print.
+ * _putfd - Writes the character c to a given file descriptor, through
+ * that descriptor's buffer.
+ * @c: The character to print, or BUF_FLUSH to write out the buffer.
  * @fd: The file descriptor to write to.
  * Return: On success 1. On error, -1 is returned.
  */
 int _putfd(char c, int fd)
 {
-	static int i; // Static counter for buffer index
-	static char buf[WRITE_BUF_SIZE]; // Static buffer
-
-	if (c == BUF_FLUSH || i >= WRITE_BUF_SIZE) // If buffer is full or flush signal
-	{
-		write(fd, buf, i); // Write buffer content to specified fd
-		i = 0; // Reset buffer index
-	}
-	if (c != BUF_FLUSH) // If not a flush signal, add char to buffer
-		buf[i++] = c;
-	return (1);
+	if (c == BUF_FLUSH)
+		return (out_flush(fd) ? -1 : 1); // out_flush from io_handling/output_buffer.c
+	return (out_putc(fd, c)); // out_putc from io_handling/output_buffer.c
 }
 
 /**
@@ -69,13 +43,11 @@ int _putfd(char c, int fd)
  */
 int _putsfd(char *str, int fd)
 {
-	int i = 0;
+	int n;
 
 	if (!str)
 		return (0);
-	while (*str)
-	{
-		i += _putfd(*str++, fd); // Use _putfd for buffered writing to specified fd
-	}
-	return (i);
+	n = _strlen(str);
+	out_write(fd, str, n);
+	return (n);
 }
@@ -29,79 +29,128 @@ int _erratoi(char *s)
 }
 
 /**
- * print_error - Prints a standardized error message to stderr.
- * Format: "shell_name: line_count: command: error_message\n"
- * @info: The parameter & return info struct containing shell state.
- * @estr: String containing the specified error type or message.
- * Return: void.
+ * line_put - Appends a string to an error line, cutting it short at
+ * PIPE_BUF - 1 bytes (leaving room for the '\n').
+ * @line: The line, PIPE_BUF bytes.
+ * @n: Its current length.
+ * @s: The string.
+ * Return: The new length.
  */
-void print_error(info_t *info, char *estr)
+static size_t line_put(char *line, size_t n, char *s)
 {
-	_eputs(info->fname); // _eputs in error_handling/error_reporter.c
-	_eputs(": ");
-	print_d(info->line_count, STDERR_FILENO); // print_d is defined in this file
-	_eputs(": ");
-	_eputs(info->argv[0]);
-	_eputs(": ");
-	_eputs(estr);
+	size_t k = _strlen(s);
+
+	if (k > PIPE_BUF - 1 - n)
+		k = PIPE_BUF - 1 - n;
+	memcpy(line + n, s, k);
+	return (n + k);
 }
 
 /**
- * print_d - Function prints a decimal (integer) number (base 10) to a given fd.
- * @input: The integer input.
- * @fd: The file descriptor to write to (e.g., STDERR_FILENO).
- * Return: Number of characters printed.
+ * line_add - Appends the strings of a NULL-terminated list to an error line.
+ * @line: The line, PIPE_BUF bytes.
+ * @n: Its current length.
+ * @ap: The strings.
+ * Return: The new length.
  */
-int print_d(int input, int fd)
+static size_t line_add(char *line, size_t n, va_list ap)
 {
-	int (*__putchar)(char) = _putchar; // Default to _putchar (stdout)
-	int i, count = 0;
-	unsigned int _abs_, current;
+	char *s;
 
-	if (fd == STDERR_FILENO)
-		__putchar = _eputchar; // Use _eputchar for stderr
+	while ((s = va_arg(ap, char *)))
+		n = line_put(line, n, s);
+	return (n);
+}
 
-	if (input < 0)
-	{
-		_abs_ = -input; // Convert to positive
-		__putchar('-');
-		count++;
-	}
-	else
-		_abs_ = input;
-	current = _abs_;
+/**
+ * line_out - Ends an error line with a newline, unless it has one, and
+ * writes it to stderr with a single write.
+ * @line: The line, PIPE_BUF bytes.
+ * @n: Its length.
+ */
+static void line_out(char *line, size_t n)
+{
+	if (!n || line[n - 1] != '\n')
+		line[n++] = '\n';
+	out_line(STDERR_FILENO, line, n); // out_line from io_handling/output_buffer.c
+}
 
-	// Print digits from most significant to least significant
-	for (i = 1000000000; i > 1; i /= 10) // Start with largest power of 10
-	{
-		if (_abs_ / i) // If there's a non-zero digit at this place
-		{
-			__putchar('0' + current / i); // Print the digit
-			count++;
-		}
-		current %= i; // Get the remaining part of the number
-	}
-	__putchar('0' + current); // Print the last digit (ones place)
-	count++;
+/**
+ * eprint_line - Prints a line made of several strings to stderr. The line
+ * is assembled first and written with a single write of at most PIPE_BUF
+ * bytes, so that shells sharing a pipe or an O_APPEND log file never
+ * interleave their messages mid-line.
+ * @s: The first string; the list ends with NULL. A newline is added
+ * unless the line already ends with one.
+ * Return: void.
+ */
+void eprint_line(char *s, ...)
+{
+	char line[PIPE_BUF];
+	size_t n = 0;
+	va_list ap;
 
-	return (count);
+	if (!s)
+		return;
+	n = line_put(line, 0, s);
+	va_start(ap, s);
+	n = line_add(line, n, ap);
+	va_end(ap);
+	line_out(line, n);
 }
 
 /**
- * remove_comments - Function replaces the first instance of '#' with '\0'.
- * This effectively removes comments from a command line string.
- * Comments are ignored if they are not preceded by a space or are at the start of the line.
- * @buf: Address of the string to modify.
- * Return: Always 0; (void function, returns nothing significant).
+ * error_line - Prints an error line to stderr with a single write, like
+ * eprint_line().
+ * Format: "shell_name: line_count: " followed by the strings and "\n"
+ * @info: The parameter & return info struct containing shell state.
+ * @...: The strings making up the message, ending with NULL.
+ * Return: void.
  */
-void remove_comments(char *buf)
+void error_line(info_t *info, ...)
 {
-	int i;
+	char line[PIPE_BUF], num[NUM_BUF_SIZE];
+	size_t n;
+	va_list ap;
 
-	for (i = 0; buf[i] != '\0'; i++)
-		if (buf[i] == '#' && (!i || buf[i - 1] == ' ')) // Check for '#' and if it's start of line or preceded by space
-		{
-			buf[i] = '\0'; // Null-terminate at the '#'
-			break;
-		}
+	fmt_unsigned(info->line_count, num); // fmt_unsigned from memory_utils/string_converters.c
+	n = line_put(line, 0, info->fname);
+	n = line_put(line, n, ": ");
+	n = line_put(line, n, num);
+	n = line_put(line, n, ": ");
+	va_start(ap, info);
+	n = line_add(line, n, ap);
+	va_end(ap);
+	line_out(line, n);
+}
+
+/**
+ * print_error - Prints a standardized error message to stderr.
+ * Format: "shell_name: line_count: command: error_message\n"
+ * @info: The parameter & return info struct containing shell state.
+ * @estr: String containing the specified error type or message.
+ * Return: void.
+ */
+void print_error(info_t *info, char *estr)
+{
+	error_line(info, info->argv[0], ": ", estr, NULL);
+}
+
+/**
+ * syntax_error - Prints a parser/lexer error to stderr and sets status 2.
+ * Format: "shell_name: line_count: Syntax error: "tok" message\n"
+ * @info: The parameter & return info struct containing shell state.
+ * @tok: The offending token text, quoted in the message, or NULL.
+ * @msg: The error message.
+ * Return: void.
+ */
+void syntax_error(info_t *info, char *tok, char *msg)
+{
+	if (info->syntax_quiet) // Compiling a script; reported later by run_script
+		return;
+	if (tok)
+		error_line(info, "Syntax error: \"", tok, "\" ", msg, NULL);
+	else
+		error_line(info, "Syntax error: ", msg, NULL);
+	info->status = 2;
 }
@@ -27,46 +27,166 @@ char *get_history_file(info_t *info)
 }
 
 /**
- * write_history - Creates a history file, or appends to an existing file,
- * writing the current command history to it.
- * @info: The parameter struct containing the history linked list.
- * Return: 1 on success, else -1.
+ * hist_open - Opens the history file for appending, once per session, and
+ * again if another shell has since replaced it with a compacted copy.
+ * @h: The history.
+ * @info: The parameter struct, for $HOME.
+ * Return: 0 on success, -1 on error.
  */
-int write_history(info_t *info)
+static int hist_open(hist_t *h, info_t *info)
 {
-	ssize_t fd;
-	char *filename = get_history_file(info); // Get history file path
-	list_t *node = NULL;
+	struct stat st;
 
-	if (!filename)
+	if (h->file && (stat(h->file, &st) || st.st_ino != h->ino))
+	{
+		close(h->fd);
+		bfree((void **)&h->file); // bfree from memory_utils/memory_allocators.c
+	}
+	if (h->file)
+		return (0);
+	h->file = get_history_file(info);
+	if (!h->file)
 		return (-1);
+	h->fd = open(h->file, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	if (h->fd == -1 || fstat(h->fd, &st))
+	{
+		if (h->fd != -1)
+			close(h->fd);
+		bfree((void **)&h->file);
+		return (-1);
+	}
+	h->ino = st.st_ino;
+	return (0);
+}
 
-	// Open file: create if not exists, truncate if exists, read/write permissions
-	fd = open(filename, O_CREAT | O_TRUNC | O_RDWR, 0644);
-	free(filename); // Free filename after opening
+/**
+ * hist_put - Writes a range of history lines to a file. Each line goes to
+ * out_write() with its newline in one piece, so every write() ends at the
+ * end of a line and shells appending to the same file at once interleave
+ * whole lines.
+ * @info: The parameter struct.
+ * @fd: The file.
+ * @from: Number of the first line.
+ * @to: Number past the last line.
+ * Return: 0 on success, -1 on error.
+ */
+static int hist_put(info_t *info, int fd, unsigned int from, unsigned int to)
+{
+	char *line;
+	size_t len;
+	int r = 0;
+
+	for (; from < to; from++)
+	{
+		line = hist_get(info, from);
+		len = _strlen(line);
+		line[len] = '\n'; // The pool's NUL becomes the newline for a moment
+		if (out_write(fd, line, len + 1) == -1) // out_write in io_handling/output_buffer.c
+			r = -1;
+		line[len] = '\0';
+	}
+	return (out_flush(fd) ? -1 : r);
+}
+
+/**
+ * hist_compact - Replaces the history file with the lines kept in memory,
+ * through a temporary file renamed over it, so that the file never holds
+ * less than it did.
+ * @info: The parameter struct.
+ * Return: 0 on success, -1 on error.
+ */
+static int hist_compact(info_t *info)
+{
+	hist_t *h = &info->hist;
+	char *tmp = malloc(_strlen(h->file) + 2 + NUM_BUF_SIZE);
+	struct stat st;
+	int fd;
+
+	if (!tmp)
+		return (-1);
+	_strcpy(tmp, h->file);
+	_strcat(tmp, ".");
+	fmt_unsigned(getpid(), tmp + _strlen(tmp)); // fmt_unsigned in memory_utils/string_converters.c
+	fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
 	if (fd == -1)
+	{
+		free(tmp);
 		return (-1);
-
-	// Iterate through history list and write each command to file
-	for (node = info->history; node; node = node->next)
+	}
+	if (hist_put(info, fd, h->first, h->first + h->count) || fstat(fd, &st)
+		|| rename(tmp, h->file))
 	{
-		_putsfd(node->str, fd); // _putsfd in error_handling/error_reporter.c
-		_putfd('\n', fd);       // _putfd in error_handling/error_reporter.c
+		close(fd);
+		unlink(tmp);
+		free(tmp);
+		return (-1);
 	}
-	_putfd(BUF_FLUSH, fd); // Flush any remaining buffer content
-	close(fd);
-	return (1);
+	free(tmp);
+	close(h->fd);
+	h->fd = fd; // Now the history file itself
+	h->ino = st.st_ino;
+	h->file_lines = h->count;
+	return (0);
 }
 
 /**
- * read_history - Reads command history from the history file and populates the linked list.
+ * write_history - Appends the lines added since the last call to the
+ * history file, in one write() as a rule. Once the file would exceed
+ * HIST_COMPACT lines it is rewritten with the last HIST_MAX instead, which
+ * costs no more than the lines appended since the last rewrite.
+ * @info: The parameter struct containing the history.
+ * Return: 1 on success, else -1.
+ */
+int write_history(info_t *info)
+{
+	hist_t *h = &info->hist;
+	unsigned int end = h->first + h->count;
+	unsigned int from = h->saved > h->first ? h->saved : h->first;
+	int r;
+
+	if (h->saved == end)
+		return (1);
+	h->saved = end; // Lines that fail to be written are not tried again
+	h->flushed = time(NULL);
+	if (hist_open(h, info))
+		return (-1);
+	if (h->file_lines >= HIST_COMPACT || end - from > HIST_COMPACT - h->file_lines)
+		return (hist_compact(info) ? -1 : 1);
+	r = hist_put(info, h->fd, from, end);
+	h->file_lines += end - from;
+	return (r ? -1 : 1);
+}
+
+/**
+ * hist_commit - Appends the new history lines to the file once
+ * HIST_FLUSH_LINES lines or HIST_FLUSH_BYTES bytes of them have gathered,
+ * or when the last write is HIST_FLUSH_SECS seconds old. At most that much
+ * is lost if the shell dies, for one write per batch.
+ * @info: The parameter struct.
+ */
+void hist_commit(info_t *info)
+{
+	hist_t *h = &info->hist;
+	unsigned int n = h->first + h->count - h->saved;
+
+	if (!n)
+		return;
+	if (n >= HIST_FLUSH_LINES || h->saved < h->first
+		|| h->pool_len - h->off[(h->head + h->saved - h->first) % HIST_MAX] >= HIST_FLUSH_BYTES
+		|| time(NULL) - h->flushed >= HIST_FLUSH_SECS)
+		write_history(info);
+}
+
+/**
+ * read_history - Reads command history from the history file. Only the
+ * last HIST_MAX lines are kept, numbered from 0.
  * @info: The parameter struct where history will be stored.
  * Return: The number of history entries read on success, 0 otherwise.
  */
 int read_history(info_t *info)
 {
-	int i, last = 0, linecount = 0;
-	ssize_t fd, rdlen, fsize = 0;
+	ssize_t i, last = 0, fd, rdlen, fsize = 0;
+	size_t lines = 0;
 	struct stat st; // For file status (size)
 	char *buf = NULL, *filename = get_history_file(info);
 
@@ -82,73 +202,175 @@ int read_history(info_t *info)
 	if (!fstat(fd, &st)) // fstat gets file status using its file descriptor
 		fsize = st.st_size;
 	if (fsize < 2) // Minimum size for meaningful history (e.g., "a\n")
+	{
+		close(fd);
 		return (0);
+	}
 
 	buf = malloc(sizeof(char) * (fsize + 1)); // Allocate buffer for file content + null terminator
 	if (!buf)
+	{
+		close(fd);
 		return (0);
+	}
 	rdlen = read(fd, buf, fsize); // Read file content into buffer
-	buf[fsize] = 0; // Null-terminate the buffer
-	if (rdlen <= 0) // Read error or empty file
-		return (free(buf), 0);
 	close(fd);
+	if (rdlen <= 0) // Read error or empty file
+	{
+		free(buf);
+		return (0);
+	}
+	fsize = rdlen;
 
-	// Parse buffer by newlines and build history list
+	// Add each line; the ring drops the oldest ones beyond HIST_MAX
 	for (i = 0; i < fsize; i++)
 		if (buf[i] == '\n')
 		{
-			buf[i] = 0; // Replace newline with null terminator
-			build_history_list(info, buf + last, linecount++); // Add entry to list
+			hist_add(info, buf + last, i - last);
 			last = i + 1; // Move 'last' to start of next line
+			lines++;
 		}
 	if (last != i) // Handle case where last line doesn't end with newline
-		build_history_list(info, buf + last, linecount++);
+	{
+		hist_add(info, buf + last, i - last);
+		lines = SIZE_MAX; // Appending would join lines: rewrite the file first
+	}
 	free(buf); // Free buffer after parsing
 
-	info->histcount = linecount; // Update total history count
-	// Trim history if it exceeds HIST_MAX
-	while (info->histcount-- >= HIST_MAX)
-		delete_node_at_index(&(info->history), 0); // Remove oldest entry
-	renumber_history(info); // Renumber nodes after trimming
-	return (info->histcount);
+	info->hist.first = 0; // Number the lines kept from 0
+	info->hist.saved = info->hist.count; // All of them are in the file
+	info->hist.file_lines = lines;
+	return (info->hist.count);
 }
 
 /**
- * build_history_list - Adds an entry to the command history linked list.
- * @info: Structure containing potential arguments. Used to maintain
- * constant function prototype.
- * @buf: The command string to add to history.
- * @linecount: The history line number to assign to this entry.
- * Return: Always 0.
+ * hist_reserve - Makes room for a line in the string pool. The text of
+ * evicted lines is dropped first by moving the live lines to the front;
+ * the pool then grows until at least half of it is free, so that each
+ * compaction (which also shifts the offsets) is paid for by as many bytes
+ * appended since the last one.
+ * @h: The history.
+ * @need: Bytes needed.
+ * Return: 0 on success, -1 on allocation failure.
  */
-int build_history_list(info_t *info, char *buf, int linecount)
+static int hist_reserve(hist_t *h, size_t need)
 {
-	list_t *node = NULL;
+	size_t base = h->count ? h->off[h->head] : h->pool_len;
+	size_t cap = h->pool_cap ? h->pool_cap : HIST_POOL_SIZE;
+	unsigned int i;
+	char *p;
+
+	if (base)
+	{
+		memmove(h->pool, h->pool + base, h->pool_len - base);
+		h->pool_len -= base;
+		for (i = 0; i < h->count; i++)
+			h->off[(h->head + i) % HIST_MAX] -= base;
+	}
+	while (cap < 2 * (h->pool_len + need))
+		cap *= 2;
+	if (cap == h->pool_cap)
+		return (0);
+	p = _realloc(h->pool, h->pool_len, cap); // _realloc from memory_utils/memory_allocators.c
+	if (!p)
+		return (h->pool_len + need <= h->pool_cap ? 0 : -1);
+	h->pool = p;
+	h->pool_cap = cap;
+	return (0);
+}
 
-	if (info->history) // If history list already exists, get its end
-		node = info->history;
-	add_node_end(&node, buf, linecount); // add_node_end in linked_lists/list_operations.c
+/**
+ * hist_add - Adds a line to the history, evicting the oldest line when
+ * HIST_MAX lines are kept. Takes constant time, amortized.
+ * @info: The parameter struct.
+ * @line: The line (need not be NUL-terminated).
+ * @len: Its length.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+int hist_add(info_t *info, const char *line, size_t len)
+{
+	hist_t *h = &info->hist;
+	unsigned int slot;
 
-	if (!info->history) // If it was an empty list, new node becomes the head
-		info->history = node;
+	if (!h->off)
+	{
+		h->off = malloc(sizeof(*h->off) * HIST_MAX);
+		if (!h->off)
+			return (-1);
+	}
+	if (h->count == HIST_MAX) // The oldest line makes room
+	{
+		h->head = (h->head + 1) % HIST_MAX;
+		h->first++;
+		h->count--;
+	}
+	if (h->pool_len + len + 1 > h->pool_cap && hist_reserve(h, len + 1))
+		return (-1);
+	slot = (h->head + h->count) % HIST_MAX;
+	h->off[slot] = h->pool_len;
+	memcpy(h->pool + h->pool_len, line, len);
+	h->pool[h->pool_len + len] = '\0';
+	h->pool_len += len + 1;
+	h->count++;
 	return (0);
 }
 
 /**
- * renumber_history - Renumbers the history linked list after changes
- * (e.g., additions or deletions). Ensures sequential numbering.
- * @info: Structure containing potential arguments.
- * Return: The new total history count.
+ * hist_get - Looks a history line up by its number.
+ * @info: The parameter struct.
+ * @num: The line's number.
+ * Return: The line, or NULL if it is not kept.
+ */
+char *hist_get(info_t *info, unsigned int num)
+{
+	hist_t *h = &info->hist;
+
+	if (num < h->first || num - h->first >= h->count)
+		return (NULL);
+	return (h->pool + h->off[(h->head + num - h->first) % HIST_MAX]);
+}
+
+/**
+ * hist_print - Prints the last lines of the history, each preceded with
+ * its number.
+ * @info: The parameter struct.
+ * @n: How many lines to print, at most.
+ */
+void hist_print(info_t *info, unsigned int n)
+{
+	hist_t *h = &info->hist;
+	char num[NUM_BUF_SIZE + 2], *line;
+	unsigned int i = n < h->count ? h->count - n : 0;
+	size_t k;
+
+	for (; i < h->count; i++)
+	{
+		k = fmt_unsigned(h->first + i, num); // fmt_unsigned in memory_utils/string_converters.c
+		num[k++] = ':';
+		num[k++] = ' ';
+		out_write(STDOUT_FILENO, num, k); // out_write in io_handling/output_buffer.c
+		line = h->pool + h->off[(h->head + i) % HIST_MAX];
+		_puts(line);
+		_putchar('\n');
+	}
+}
+
+/**
+ * hist_free - Frees the history and closes the history file.
+ * @info: The parameter struct.
  */
-int renumber_history(info_t *info)
+void hist_free(info_t *info)
 {
-	list_t *node = info->history;
-	int i = 0;
+	hist_t *h = &info->hist;
 
-	while (node)
+	if (h->file)
 	{
-		node->num = i++; // Assign sequential number
-		node = node->next;
+		close(h->fd);
+		bfree((void **)&h->file);
 	}
-	return (info->histcount = i); // Update info->histcount
+	bfree((void **)&h->pool);
+	bfree((void **)&h->off);
+	h->pool_len = h->pool_cap = 0;
+	h->head = h->count = h->first = h->saved = 0;
+	h->file_lines = 0;
 }
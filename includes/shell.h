@@ -10,23 +10,117 @@
 #include <sys/wait.h>
 #include <sys/stat.h>
 #include <limits.h>
+#include <stdint.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <time.h>
+#include <stdarg.h>
 
 // Macros for Read/Write Buffers
 #define READ_BUF_SIZE 1024
-#define WRITE_BUF_SIZE 1024
+#define OUT_BUF_SIZE 8192 // Output buffer of each file descriptor (see io_handling/output_buffer.c)
+#define OUT_MAX_FD 64 // Higher file descriptors are written to unbuffered
 #define BUF_FLUSH -1
-
-// Macros for Command Chaining Types
-#define CMD_NORM    0
-#define CMD_OR      1
-#define CMD_AND     2
-#define CMD_CHAIN   3
-
-// Macros for convert_number() flags
-#define CONVERT_LOWERCASE   1
-#define CONVERT_UNSIGNED    2
+#define RDBUF_SIZE 65536 // Read-ahead of the read built-in on seekable files
+#define LINE_BUF_SIZE 65536 // Initial read-ahead of the shell's own input; grows for longer lines
+
+// Macros for lexer token types (see string_operations/string_tokenization.c)
+#define TOK_WORD    0
+#define TOK_SEMI    1
+#define TOK_AND     2
+#define TOK_OR      3
+#define TOK_PIPE    4
+#define TOK_AMP     5
+#define TOK_LPAREN  6
+#define TOK_RPAREN  7
+#define TOK_NEWLINE 8
+#define TOK_DSEMI   9
+#define TOK_ARITH   10 // (( expression )); str is the expression text
+
+// Macros for lexer word token flags
+#define TOKF_QUOTED 1 // Word contained quotes or backslash escapes
+#define TOKF_DOLLAR 2 // Word contains a '$' (or a quoted glob character) and is left for expansion
+#define TOKF_ASSIGN 4 // Word starts with an unquoted NAME=, NAME+= or NAME[sub]=
+#define TOKF_ARRAY 8 // Word is the NAME=( of an array assignment
+#define TOKF_ELEM 16 // Word is an element of an array assignment
+
+// Reserved words (see find_name()); the closers of a command list come first
+#define KW_RBRACE   1 // }
+#define KW_THEN     2
+#define KW_ELIF     3
+#define KW_ELSE     4
+#define KW_FI       5
+#define KW_DO       6
+#define KW_DONE     7
+#define KW_ESAC     8 // Last word that ends a command list
+#define KW_LBRACE   9 // {
+#define KW_IF       10
+#define KW_WHILE    11
+#define KW_UNTIL    12
+#define KW_FOR      13
+#define KW_CASE     14 // Last word that starts a compound command
+#define KW_IN       15
+#define KW_BANG     16 // !
+
+// lex_line() failure codes
+#define LEX_NOMEM       -1
+#define LEX_INCOMPLETE  -2 // Unterminated quote; more input is needed
+
+// Macros for AST node types (see shell_core/command_parser.c)
+#define NODE_CMD      0 // Simple command: words[0..nwords)
+#define NODE_SEQ      1 // kid[0] ; kid[1]
+#define NODE_AND      2 // kid[0] && kid[1]
+#define NODE_OR       3 // kid[0] || kid[1]
+#define NODE_NOT      4 // ! kid[0]
+#define NODE_PIPE     5 // kid[0] | kid[1]
+#define NODE_BG       6 // kid[0] &
+#define NODE_SUBSHELL 7 // ( kid[0] )
+#define NODE_GROUP    8 // { kid[0] ; }
+#define NODE_IF       9 // if kid[0] then kid[1] else kid[2] fi
+#define NODE_WHILE    10 // while kid[0] do kid[1] done
+#define NODE_UNTIL    11 // until kid[0] do kid[1] done
+#define NODE_FOR      12 // for words[0] in kid[1]->words do kid[0] done
+#define NODE_ARITH_FOR 13 // for ((ex[0]; ex[1]; ex[2])) do kid[0] done
+#define NODE_CASE     14 // case words[0] in kid[0] (chain of items) esac
+#define NODE_CASE_ITEM 15 // words (patterns) ) kid[0] ;; next item kid[1]
+#define NODE_ARITH    16 // (( ex[0] ))
+#define NODE_FUNCDEF  17 // words[0] () kid[0]
+
+// Parser results
+#define PARSE_OK         0
+#define PARSE_ERROR      1
+#define PARSE_INCOMPLETE 2
+
+// Control-flow requests raised while evaluating (info->ctl)
+#define CTL_NONE 0
+#define CTL_EXIT 1
+#define CTL_BREAK 2
+#define CTL_CONTINUE 3
+#define CTL_RETURN 4
+
+// Initial number of buckets of a hash_table_t
+#define HASH_MIN_SIZE 16
+
+// Attributes of a shell variable (see variables/shell_variables.c)
+#define VAR_EXPORT   1 // Lives in info->env and is passed to commands
+#define VAR_READONLY 2
+
+// Operation types of a compiled glob pattern (see variables/pattern_match.c)
+#define PAT_CHAR 0
+#define PAT_ANY  1 // ?
+#define PAT_STAR 2 // *
+#define PAT_SET  3 // [...]
+
+// Compiled patterns kept before the cache is emptied
+#define PATTERN_CACHE_MAX 128
+
+// Size of each chunk handed out by arena_alloc()
+#define ARENA_CHUNK_SIZE 4096
+
+// Room for any number formatted by fmt_signed(), fmt_unsigned() or fmt_hex()
+#define NUM_BUF_SIZE 24
 
 // Feature Flags (for optional system calls vs custom implementations)
 #define USE_GETLINE 0 // Set to 1 to use system getline(), 0 for custom _getline
@@ -34,14 +128,20 @@
 
 // History File and Max History Size
 #define HIST_FILE   ".simple_shell_history"
-#define HIST_MAX    4096
+#define HIST_MAX    4096 // Lines kept; the oldest makes room for a new one
+#define HIST_POOL_SIZE 65536 // Initial size of the history's string pool
+#define HIST_FLUSH_LINES 64 // New lines are appended to the history file in batches
+#define HIST_FLUSH_BYTES (OUT_BUF_SIZE / 2) // of this many lines or bytes, or when they are
+#define HIST_FLUSH_SECS 5 // this many seconds older than the last write
+#define HIST_COMPACT (2 * HIST_MAX) // Beyond this many lines the file is rewritten
 
 // External Global Variable
 extern char **environ; // Declares the global environment array
 
 /**
  * struct liststr - singly linked list node for history, environment, or aliases
- * @num: The number field (e.g., history line number)
+ * @num: The number field (e.g., history line number; for the
+ * environment, the index of the variable in info->environ)
  * @str: A string associated with the node (e.g., environment variable string)
  * @next: Pointer to the next node in the list
  */
@@ -52,28 +152,407 @@ typedef struct liststr
     struct liststr *next;
 } list_t;
 
+/**
+ * struct arena_chunk - One block of bump-allocated arena memory
+ * @next: The previously filled chunk.
+ * @size: Usable bytes in @data.
+ * @used: Bytes of @data handed out so far.
+ * @data: The memory itself.
+ */
+typedef struct arena_chunk
+{
+    struct arena_chunk *next;
+    size_t size;
+    size_t used;
+    char data[];
+} arena_chunk_t;
+
+/**
+ * struct arena - A bump allocator whose memory is released all at once
+ * @head: The chunk currently being filled.
+ */
+typedef struct arena
+{
+    arena_chunk_t *head;
+} arena_t;
+
+/**
+ * struct token - A lexical token produced by lex_line()
+ * @type: One of the TOK_* types.
+ * @flags: TOKF_* flags for word tokens.
+ * @str: The NUL-terminated word text inside the line buffer (NULL for operators).
+ * @line: Input line number the token starts on.
+ */
+typedef struct token
+{
+    int type;
+    int flags;
+    char *str;
+    unsigned int line;
+} token_t;
+
+/**
+ * struct word - A word of a simple command as stored in the AST
+ * @str: The NUL-terminated word text.
+ * @flags: TOKF_* flags copied from the lexer.
+ */
+typedef struct word
+{
+    char *str;
+    int flags;
+} word_t;
+
+/**
+ * struct alias - An alias (see variables/aliases.c)
+ * @value: The value as it was defined, for printing.
+ * @text: The value split in place into the words of @words.
+ * @len: Size of @text.
+ * @words: The value's words, found once when the alias is defined.
+ * @nwords: Number of words.
+ * @more: The value ends with a blank, so the word after it is checked too.
+ * @seen: Expansion that last used the alias (info->alias_gen); an alias
+ * is used at most once per command.
+ */
+typedef struct alias
+{
+    char *value;
+    char *text;
+    size_t len;
+    word_t *words;
+    int nwords;
+    int more;
+    unsigned int seen;
+} alias_t;
+
+/**
+ * struct rdbuf - Read-ahead of the read built-in (see builtins/builtin_read.c)
+ * @buf: The bytes read ahead, RDBUF_SIZE of them at most.
+ * @pos: Position of the first unconsumed byte.
+ * @len: Number of bytes in @buf.
+ * @fd: The descriptor they were read from.
+ * @off: File offset of buf[pos]; the descriptor is kept at this offset
+ * between reads, so commands started meanwhile see the right position.
+ */
+typedef struct rdbuf
+{
+    char *buf;
+    size_t pos;
+    size_t len;
+    int fd;
+    off_t off;
+} rdbuf_t;
+
+/**
+ * struct linebuf - Read-ahead of the shell's input (see io_handling/input_reader.c)
+ * @buf: The bytes read ahead; grows to hold the longest line seen.
+ * @cap: Allocated size of @buf.
+ * @pos: Position of the first byte not yet returned.
+ * @len: Number of bytes in @buf.
+ * @scan: Bytes between @pos and this position hold no newline.
+ */
+typedef struct linebuf
+{
+    char *buf;
+    size_t cap;
+    size_t pos;
+    size_t len;
+    size_t scan;
+} linebuf_t;
+
+/**
+ * struct hist - The command history: a ring of the last HIST_MAX lines,
+ * whose text is kept in one string pool (see history/history_manager.c)
+ * @pool: The lines, NUL-terminated, oldest first; evicted lines' text is
+ * dropped when the pool is compacted.
+ * @pool_len: Bytes used in @pool.
+ * @pool_cap: Allocated size of @pool.
+ * @off: Offset in @pool of each line, HIST_MAX slots used as a ring.
+ * @head: Slot of the oldest line.
+ * @count: Number of lines kept.
+ * @first: History number of the oldest line.
+ * @saved: Number of the first line not yet appended to the history file.
+ * @file: Path of the history file once it is open, else NULL.
+ * @fd: The history file, open for appending.
+ * @ino: Its inode, to notice when another shell has replaced it.
+ * @file_lines: Lines in the file (SIZE_MAX to rewrite it on the next write).
+ * @flushed: When lines were last appended.
+ */
+typedef struct hist
+{
+    char *pool;
+    size_t pool_len;
+    size_t pool_cap;
+    size_t *off;
+    unsigned int head;
+    unsigned int count;
+    unsigned int first;
+    unsigned int saved;
+    char *file;
+    int fd;
+    ino_t ino;
+    size_t file_lines;
+    time_t flushed;
+} hist_t;
+
+/**
+ * struct arith - A node of a compiled arithmetic expression
+ * (see variables/arithmetic.c)
+ * @op: Operator code.
+ * @num: Constant value, or the operator a compound assignment applies.
+ * @name: Variable name of a variable operand.
+ * @kid: Operands.
+ */
+typedef struct arith
+{
+    int op;
+    long num;
+    char *name;
+    struct arith *kid[3];
+} arith_t;
+
+/**
+ * struct node - A node of the command AST built by parse_command()
+ * @type: One of the NODE_* types.
+ * @nwords: Number of entries in @words.
+ * @words: Words of a NODE_CMD, loop variable, case word or patterns.
+ * @kid: Child nodes; their meaning depends on @type (see NODE_*).
+ * @ex: Compiled arithmetic expressions of NODE_ARITH and NODE_ARITH_FOR.
+ * @line: Input line the node starts on, for error messages.
+ */
+typedef struct node
+{
+    int type;
+    int nwords;
+    unsigned int line;
+    word_t *words;
+    struct node *kid[3];
+    arith_t *ex[3];
+} node_t;
+
+/**
+ * struct hash_entry - An entry of a hash_table_t (see linked_lists/hash_table.c)
+ * @key: The key, stored in the same allocation as the entry.
+ * @value: The value.
+ * @next: Next entry in the same bucket.
+ */
+typedef struct hash_entry
+{
+    char *key;
+    void *value;
+    struct hash_entry *next;
+} hash_entry_t;
+
+/**
+ * struct hash_table - A string-keyed hash table with chained buckets
+ * @buckets: Bucket array; its size is a power of two.
+ * @size: Number of buckets.
+ * @count: Number of entries.
+ */
+typedef struct hash_table
+{
+    hash_entry_t **buckets;
+    size_t size;
+    size_t count;
+} hash_table_t;
+
+/**
+ * struct array - An indexed or associative array (see variables/arrays.c)
+ * @vals: Element values; NULL marks an unset index or a deleted entry.
+ * @keys: Keys of an associative array, parallel to @vals, in insertion order.
+ * @n: Number of slots of @vals in use (the highest index + 1).
+ * @cap: Allocated size of @vals and @keys.
+ * @count: Number of elements that are set.
+ * @slots: Open-addressing index of an associative array: entry number + 1,
+ * or 0 for an empty slot.
+ * @nslots: Size of @slots, a power of two.
+ * @assoc: Non-zero for an associative array.
+ */
+typedef struct array
+{
+    char **vals;
+    char **keys;
+    size_t n;
+    size_t cap;
+    size_t count;
+    size_t *slots;
+    size_t nslots;
+    int assoc;
+} array_t;
+
+/**
+ * struct var - A shell variable (see variables/shell_variables.c)
+ * @value: The value, or NULL while unset. Unused when @flags has
+ * VAR_EXPORT: an exported variable's value is kept in info->env.
+ * @cap: Allocated size of @value, reused by later assignments.
+ * @flags: VAR_* attributes.
+ * @arr: The elements if the variable is an array (its value is then the
+ * element at index or key 0), or NULL.
+ */
+typedef struct var
+{
+    char *value;
+    size_t cap;
+    int flags;
+    array_t *arr;
+} var_t;
+
+/**
+ * struct func - A shell function (see shell_core/functions.c)
+ * @body: The parsed body, copied out of the parse arena (or relocated from
+ * a state file, in which case its strings live in info->state_map).
+ * @mem: Arena owning @body.
+ * @refs: Number of calls currently running the body.
+ * @dead: Set once the function is redefined; freed when @refs drops to 0.
+ */
+typedef struct func
+{
+    node_t *body;
+    arena_t mem;
+    int refs;
+    int dead;
+} func_t;
+
+/**
+ * struct pat_op - One operation of a compiled glob pattern
+ * @type: PAT_* type.
+ * @c: The character matched by PAT_CHAR.
+ * @negate: Set for [!...] and [^...].
+ * @set: Bitmap of the characters matched by PAT_SET.
+ */
+typedef struct pat_op
+{
+    unsigned char type;
+    unsigned char c;
+    unsigned char negate;
+    unsigned char set[32];
+} pat_op_t;
+
+/**
+ * struct pattern - A compiled glob pattern
+ * @n: Number of operations.
+ * @minlen: Shortest string the pattern can match.
+ * @star: Set if the pattern contains a '*'.
+ * @ops: The operations.
+ */
+typedef struct pattern
+{
+    size_t n;
+    size_t minlen;
+    int star;
+    pat_op_t ops[];
+} pattern_t;
+
+/**
+ * struct script - A script file compiled in one go (see shell_core/script_loader.c)
+ * @path: The script's canonical path, or NULL if it is not a regular file.
+ * @st: The script's stat() at the time it was opened.
+ * @mem: Arena owning the AST (and the text it points into).
+ * @text: The whole script, or NULL when it came from the cache.
+ * @text_map: Size of the private mapping holding @text, or 0 if @text was
+ * read into malloc'd memory.
+ * @lines: Number of lines in @text.
+ * @tokens: The script's tokens.
+ * @tok_count: Number of @tokens.
+ * @root: The script's commands as one NODE_SEQ chain.
+ * @fail: PARSE_ERROR/PARSE_INCOMPLETE/LEX_INCOMPLETE if compiling stopped early.
+ * @fail_tok: Index of the first token of the command that failed to parse.
+ * @map: The mmap()ed cache file the AST was loaded from, or NULL.
+ * @map_len: Size of @map.
+ */
+typedef struct script
+{
+    char *path;
+    struct stat st;
+    arena_t mem;
+    char *text;
+    size_t text_map;
+    unsigned int lines;
+    token_t *tokens;
+    size_t tok_count;
+    node_t *root;
+    int fail;
+    size_t fail_tok;
+    void *map;
+    size_t map_len;
+} script_t;
+
 /**
  * struct passinfo - Contains pseudo-arguments and shell state information.
  * Allows uniform prototype for function pointer structs and
  * centralized access to shell data.
  * @arg: A string generated from getline, containing the raw command line input.
  * @argv: An array of strings (tokens) parsed from @arg, representing command and its arguments.
+ * Words point into the line buffer or @scratch and are not owned by @argv.
  * @path: The resolved full path for the current command if it's an external executable.
  * @argc: The number of arguments in @argv.
  * @line_count: The count of lines processed, used for error reporting.
  * @err_num: The error code to be used for exit() status.
- * @linecount_flag: Flag to indicate if the current line of input should be counted.
  * @fname: The program filename (e.g., "hsh").
  * @env: Pointer to the head of a linked list representing the shell's environment.
- * @environ: A null-terminated array of strings, a copy of the shell's environment.
- * @history: Pointer to the head of a linked list storing command history.
- * @alias: Pointer to the head of a linked list storing shell aliases.
- * @env_changed: Flag indicating if the environment has been modified.
+ * @environ: The environment as a NULL-terminated envp array for execve. It
+ * points at the strings of @env (each node's num is its index here) and is
+ * patched in place as variables are set and unset.
+ * @hist: The command history.
  * @status: The return status of the last executed command.
- * @cmd_buf: Pointer to the command chain buffer, used when commands are chained (e.g., `cmd1 ; cmd2`).
- * @cmd_buf_type: Type of command chaining (CMD_NORM, CMD_OR, CMD_AND, CMD_CHAIN).
  * @readfd: The file descriptor from which to read input (0 for stdin, or a file for script execution).
- * @histcount: The current count of history entries.
+ * @tokens: Token vector for the command being parsed, reused across commands.
+ * @tok_count: Number of tokens in @tokens.
+ * @tok_cap: Allocated capacity of @tokens.
+ * @tok_pos: Index of the next token the parser will look at.
+ * @cmd_words: Words of the simple command currently being run.
+ * @argv_buf: Storage backing @argv, reused across commands.
+ * @argv_cap: Number of pointers @argv_buf can hold.
+ * @scratch: Per-command arena for words materialized by expansion.
+ * @parse: Arena holding the input lines and AST of the command being run.
+ * @pending: Raw text of a line whose quote is still open.
+ * @pending_len: Bytes used in @pending.
+ * @parse_err: PARSE_* result of the last parser call.
+ * @ctl: CTL_* request (e.g. exit) that unwinds the evaluator.
+ * @forked: Set in a child process, so external commands exec without forking again.
+ * @loop_depth: Number of loops being evaluated, the limit for break/continue.
+ * @ctl_levels: Loops still to unwind for CTL_BREAK/CTL_CONTINUE.
+ * @funcs: Shell functions by name (func_t values).
+ * @func_depth: Number of function calls being evaluated.
+ * @params: Positional parameters $1..., NULL-terminated.
+ * @nparams: Number of positional parameters ($#).
+ * @locals: Saved values of variables declared local in the running function.
+ * @source_depth: Number of files being run by the . builtin.
+ * @syntax_quiet: Non-zero while a script is compiled; syntax errors are
+ * recorded but reported only after the commands before them have run.
+ * @xbuf: Buffer holding the expanded words of the command being run.
+ * @xbuf_len: Bytes used in @xbuf.
+ * @xbuf_cap: Allocated size of @xbuf.
+ * @pid: The shell's process ID ($$), read once at startup.
+ * @patterns: Compiled glob patterns by pattern text (pattern_t values).
+ * @vars: Shell variables by name (var_t values). Exported variables live in
+ * @env; an entry is kept for them only to carry attributes.
+ * @assigns: NAME=value assignments written before the external command
+ * being run; they go into that command's environment only.
+ * @arrays: Elements of the name=(...) arguments of the declaration command
+ * being run, by argv index (NULL for other arguments), or NULL.
+ * @xjoin: Set while expanding words that must stay one word each (case).
+ * @xfields: Set while expanding a word that "$@" or "${name[@]}" may
+ * turn into several words.
+ * @xsplit: Number of extra words the current word has been split into.
+ * @xnone: Set when a "$@" or "${name[@]}" in the current word had no
+ * elements, so that an otherwise empty word disappears.
+ * @aliases: Aliases by name (alias_t values).
+ * @alias_gen: Number of the last alias expansion, marking the aliases it used.
+ * @rdbuf: Read-ahead of the read built-in.
+ * @envtab: The environment by name. Each entry's value is the link
+ * (&info->env or a node's next) that points at the variable's node in
+ * @env, so looking a variable up or unlinking it takes constant time.
+ * @env_tail: The link the next variable of the environment goes into.
+ * @env_count: Number of variables in @environ.
+ * @env_cap: Allocated size of @environ.
+ * @state_file: File to save the shell's state to on exit (--save-state).
+ * @state_map: The state file loaded at startup (--load-state), mapped; the
+ * bodies of the functions it defined point into it.
+ * @state_len: Size of @state_map.
+ * @in: Read-ahead of the input read from @readfd.
+ * @arg_cap: Allocated size of @arg.
+ * @batch: Set when running -c, -s or a script: never interactive, no
+ * prompt and no history.
  */
 typedef struct passinfo
 {
@@ -83,35 +562,89 @@ typedef struct passinfo
     int argc;
     unsigned int line_count;
     int err_num;
-    int linecount_flag;
     char *fname;
     list_t *env;
-    list_t *history;
-    list_t *alias;
+    hist_t hist;
     char **environ;
-    int env_changed;
     int status;
 
-    char **cmd_buf; /* pointer to cmd ; chain buffer, for memory management */
-    int cmd_buf_type; /* CMD_type ||, &&, ; */
     int readfd;
-    int histcount;
+
+    token_t *tokens;
+    size_t tok_count;
+    size_t tok_cap;
+    size_t tok_pos;
+    word_t *cmd_words;
+
+    char **argv_buf;
+    size_t argv_cap;
+    arena_t scratch;
+
+    arena_t parse;
+    char *pending;
+    size_t pending_len;
+    int parse_err;
+    int ctl;
+    int forked;
+    int loop_depth;
+    int ctl_levels;
+
+    hash_table_t funcs;
+    int func_depth;
+    char **params;
+    int nparams;
+    list_t *locals;
+    int source_depth;
+    int syntax_quiet;
+
+    char *xbuf;
+    size_t xbuf_len;
+    size_t xbuf_cap;
+    pid_t pid;
+    hash_table_t patterns;
+    hash_table_t vars;
+    char **assigns;
+    char ***arrays;
+    int xjoin;
+    int xfields;
+    int xsplit;
+    int xnone;
+    hash_table_t aliases;
+    unsigned int alias_gen;
+    rdbuf_t rdbuf;
+    hash_table_t envtab;
+    list_t **env_tail;
+    size_t env_count;
+    size_t env_cap;
+    char *state_file;
+    void *state_map;
+    size_t state_len;
+    linebuf_t in;
+    size_t arg_cap;
+    int batch;
 } info_t;
 
 // Macro for initializing info_t struct
 #define INFO_INIT \
-{NULL, NULL, NULL, 0, 0, 0, 0, NULL, NULL, NULL, NULL, NULL, 0, 0, NULL, \
-    0, 0, 0}
+{NULL, NULL, NULL, 0, 0, 0, NULL, NULL, {NULL, 0, 0, NULL, 0, 0, 0, 0, NULL, 0, 0, 0, 0}, NULL, 0, \
+    0, NULL, 0, 0, 0, NULL, NULL, 0, {NULL}, {NULL}, NULL, 0, 0, 0, 0, 0, 0, \
+    {NULL, 0, 0}, 0, NULL, 0, NULL, 0, 0, NULL, 0, 0, 0, \
+    {NULL, 0, 0}, {NULL, 0, 0}, NULL, NULL, 0, 0, 0, 0, {NULL, 0, 0}, 0, {NULL, 0, 0, 0, 0}, {NULL, 0, 0}, NULL, 0, 0, \
+    NULL, NULL, 0, {NULL, 0, 0, 0, 0}, 0, 0}
 
 /**
- * struct builtin - Maps a built-in command string to its corresponding function.
- * @type: The string name of the built-in command (e.g., "exit", "env").
- * @func: A pointer to the function that implements the built-in command.
+ * struct builtin - Maps a built-in command or reserved word string to
+ * its meaning (see builtins/builtin_manager.c).
+ * @type: The string name (e.g., "exit", "env", "while").
+ * @func: A pointer to the function that implements the built-in command,
+ * or NULL for a reserved word.
+ * @word: The KW_* code of a reserved word, or 0 for a built-in.
  */
 typedef struct builtin
 {
     char *type;
     int (*func)(info_t *);
+    int word;
 } builtin_table;
 
 
@@ -121,27 +654,92 @@ typedef struct builtin
 
 // shell_core/shell_loop.c
 int hsh(info_t *, char **);
+void exit_shell(info_t *);
 int loophsh(char **); // This function might become obsolete or integrated into hsh
 
 // shell_core/command_executor.c
+int eval_node(info_t *, node_t *);
+int run_command(info_t *, node_t *);
 void fork_cmd(info_t *);
+void exec_cmd(info_t *);
+int wait_child(info_t *, pid_t);
+void child_exit(info_t *);
+
+// shell_core/command_parser.c
+node_t *parse_command(info_t *);
+
+// shell_core/control_flow.c
+int eval_if(info_t *, node_t *);
+int eval_loop(info_t *, node_t *);
+int eval_for(info_t *, node_t *);
+int eval_arith_for(info_t *, node_t *);
+int eval_case(info_t *, node_t *);
+int eval_arith(info_t *, node_t *);
+
+// shell_core/functions.c
+int define_function(info_t *, node_t *);
+int load_function(info_t *, char *, void *, size_t);
+func_t *find_function(info_t *, char *);
+int call_function(info_t *, func_t *);
+int remove_function(info_t *, char *);
+void free_functions(info_t *);
+
+// shell_core/script_loader.c
+char *read_all(int, size_t, size_t *);
+int run_script(info_t *, char *, int);
+int run_string(info_t *, char *);
 
 // shell_core/shell_utilities.c
 int is_interactive(info_t *); // Corrected name
 int is_delimiter(char, char *); // Corrected name
 int is_alpha_char(int);       // Corrected name
 int string_to_int(char *);    // Corrected name
+int valid_name(char *);
 void clear_info(info_t *);
-void set_info(info_t *, char **);
+int argv_reserve(info_t *, size_t);
+void set_info(info_t *, word_t *, int);
+char **expand_words(info_t *, word_t *, int);
+char ***set_decl(info_t *, word_t *, int);
+char **dup_vector(char **, int);
 void free_info(info_t *, int);
 
 
 // builtins/builtin_manager.c
-int find_builtin(info_t *);
+builtin_table *find_name(char *);
+builtin_table *find_builtin(char *);
+int decl_builtin(char *);
+int reserved_word(char *);
 
 // builtins/builtin_exit.c
 int _myexit(info_t *);
 
+// builtins/builtin_flow.c
+int _mybreak(info_t *);
+int _mycontinue(info_t *);
+int _mytrue(info_t *);
+int _myfalse(info_t *);
+
+// builtins/builtin_function.c
+int _myreturn(info_t *);
+int _mylocal(info_t *);
+
+// builtins/builtin_source.c
+int _mysource(info_t *);
+
+// builtins/builtin_variable.c
+int _myexport(info_t *);
+int _myreadonly(info_t *);
+int _myunset(info_t *);
+int _mydeclare(info_t *);
+char *decl_name(info_t *, int, char **);
+int decl_assign(info_t *, int, char *, char *);
+
+// builtins/builtin_array.c
+int _mymapfile(info_t *);
+
+// builtins/builtin_read.c
+int _myread(info_t *);
+
 // builtins/builtin_cd.c
 int _mycd(info_t *);
 
@@ -151,9 +749,6 @@ int _myhelp(info_t *);
 // builtins/builtin_history_alias.c
 int _myhistory(info_t *);
 int _myalias(info_t *);
-int unset_alias(info_t *, char *); // Helper for alias
-int set_alias(info_t *, char *);   // Helper for alias
-int print_alias(list_t *);         // Helper for alias
 
 // environment/env_manager.c
 int _myenv(info_t *);
@@ -161,7 +756,10 @@ char *_getenv(info_t *, const char *);
 int _mysetenv(info_t *);
 int _myunsetenv(info_t *);
 int populate_env_list(info_t *);
-char **get_environ(info_t *); // from getenv.c
+void free_env(info_t *);
+char *env_find(info_t *, const char *, size_t);
+int env_append(info_t *, char *, size_t);
+char **get_environ(info_t *);
 int _unsetenv(info_t *, char *); // from getenv.c (renamed from _unsetenv in getenv.c, if it differs)
 int _setenv(info_t *, char *, char *); // from getenv.c (renamed from _setenv in getenv.c, if it differs)
 
@@ -172,11 +770,24 @@ char *find_path(info_t *, char *, char *);
 void find_cmd(info_t *); // From shell_loop.c, related to path finding
 
 
+// io_handling/output_buffer.c
+ssize_t out_write(int, const char *, size_t);
+ssize_t out_line(int, const char *, size_t);
+int out_putc(int, char);
+int out_flush(int);
+void flush_output(void);
+ssize_t flush_read(int, void *, size_t);
+
+// io_handling/uring_io.c
+int uring_ready(void);
+char *uring_buffer(int);
+int uring_queue(int, const void *, size_t);
+ssize_t uring_submit(int, void *, size_t);
+
 // io_handling/input_reader.c
-ssize_t input_buf(info_t *, char **, size_t *);
-ssize_t get_input(info_t *);
-ssize_t read_buf(info_t *, char *, size_t *);
-int _getline(info_t *, char **, size_t *);
+ssize_t input_buf(info_t *, char **);
+ssize_t get_input(info_t *, node_t **);
+ssize_t _getline(info_t *, char **, size_t *);
 void sigintHandler(int);
 
 // memory_utils/memory_allocators.c
@@ -185,8 +796,16 @@ void ffree(char **);
 void *_realloc(void *, unsigned int, unsigned int);
 int bfree(void **);
 
+// memory_utils/arena.c
+void *arena_alloc(arena_t *, size_t);
+char *arena_strndup(arena_t *, const char *, size_t);
+void arena_reset(arena_t *);
+void arena_free(arena_t *);
+
 // memory_utils/string_converters.c
-char *convert_number(long int, int, int);
+size_t fmt_unsigned(unsigned long, char *);
+size_t fmt_signed(long, char *);
+size_t fmt_hex(unsigned long, char *, int);
 
 // linked_lists/list_operations.c
 list_t *add_node(list_t **, const char *, int);
@@ -194,6 +813,14 @@ list_t *add_node_end(list_t **, const char *, int);
 int delete_node_at_index(list_t **, unsigned int);
 void free_list(list_t **);
 
+// linked_lists/hash_table.c
+unsigned long hash_string(const char *);
+hash_entry_t *hash_find(hash_table_t *, const char *);
+hash_entry_t *hash_find_len(hash_table_t *, const char *, size_t);
+hash_entry_t *hash_insert(hash_table_t *, const char *);
+int hash_remove(hash_table_t *, const char *, void (*)(void *));
+void hash_free(hash_table_t *, void (*)(void *));
+
 // linked_lists/list_utilities.c
 size_t list_len(const list_t *);
 char **list_to_strings(list_t *);
@@ -219,8 +846,10 @@ void _puts(char *);
 int _putchar(char);
 
 // string_operations/string_tokenization.c
-char **strtow(char *, char *);
-char **strtow2(char *, char);
+ssize_t lex_line(info_t *, char *, unsigned int);
+char *word_unquote(char *);
+int lex_words(char *, word_t *);
+char *tok_name(int);
 
 // error_handling/error_reporter.c
 void _eputs(char *);
@@ -230,25 +859,89 @@ int _putsfd(char *str, int fd);
 
 // error_handling/error_utilities.c
 int _erratoi(char *);
+void eprint_line(char *, ...) __attribute__((sentinel));
+void error_line(info_t *, ...) __attribute__((sentinel));
 void print_error(info_t *, char *);
-int print_d(int, int);
-void remove_comments(char *);
+void syntax_error(info_t *, char *, char *);
 
 // history/history_manager.c
 char *get_history_file(info_t *info);
 int write_history(info_t *info);
 int read_history(info_t *info);
-int build_history_list(info_t *info, char *buf, int linecount);
-int renumber_history(info_t *info);
+int hist_add(info_t *, const char *, size_t);
+void hist_commit(info_t *);
+char *hist_get(info_t *, unsigned int);
+void hist_print(info_t *, unsigned int);
+void hist_free(info_t *);
+
+// io_handling/script_cache.c
+int cache_load(info_t *, script_t *);
+int cache_store(info_t *, script_t *);
+size_t ast_pack(node_t *, void *);
+int ast_unpack(arena_t *, void *, size_t, node_t **);
+
+// io_handling/state_snapshot.c
+int save_state(info_t *, char *);
+int load_state(info_t *, char *);
 
 // variables/command_chaining.c
-int is_chain(info_t *, char *, size_t *);
-void check_chain(info_t *, char *, size_t *, size_t, size_t);
+int eval_list(info_t *, node_t *);
+int eval_and_or(info_t *, node_t *);
+int eval_background(info_t *, node_t *);
+
+// io_handling/pipe_handler.c
+int eval_pipeline(info_t *, node_t *);
+int eval_subshell(info_t *, node_t *);
+
+// variables/arithmetic.c
+arith_t *arith_parse(info_t *, char *);
+int arith_run(info_t *, arith_t *, long *);
+int arith_eval(info_t *, char *, long *);
+
+// variables/aliases.c
+int alias_set(info_t *, char *, char *);
+int alias_load(info_t *, char *, alias_t *);
+int alias_unset(info_t *, char *);
+word_t *expand_alias(info_t *, word_t *, int *);
+void free_aliases(info_t *);
 
 // variables/variable_expansion.c
-int replace_alias(info_t *);
 int replace_vars(info_t *);
-int replace_string(char **, char *);
+char *expand_pattern(info_t *, word_t *);
+
+// variables/shell_variables.c
+var_t *var_find(info_t *, char *);
+char *var_lookup(info_t *, const char *, size_t);
+array_t *var_array(info_t *, const char *, size_t);
+char *var_get(info_t *, char *);
+int var_set(info_t *, char *, char *);
+int var_export(info_t *, char *, char *);
+int var_readonly(info_t *, char *, char *);
+int var_unset(info_t *, char *);
+int var_save(info_t *, list_t **, char *);
+void var_restore(info_t *, list_t **);
+array_t *var_make_array(info_t *, char *, int);
+int subscript_index(info_t *, char *, long *);
+int var_unset_elem(info_t *, char *, char *);
+int var_set_array(info_t *, char *, char **, int);
+int var_assign(info_t *, char **, list_t **);
+int assign_words(info_t *, word_t *, int);
+void free_vars(info_t *);
+
+// variables/arrays.c
+array_t *array_new(int);
+void array_clear(array_t *);
+void array_free(array_t *);
+char *array_at(array_t *, long);
+char *array_find(array_t *, const char *, size_t);
+int array_set(array_t *, long, const char *, const char *, size_t, int);
+int array_push(array_t *, const char *, size_t);
+void array_unset(array_t *, long, const char *);
+
+// variables/pattern_match.c
+pattern_t *pattern_get(info_t *, char *);
+int pattern_match(pattern_t *, const char *, size_t);
+void free_patterns(info_t *);
 
 
 #endif // _SHELL_H_
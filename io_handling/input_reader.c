@@ -1,166 +1,242 @@
 #include "../includes/shell.h"
 
 /**
- * input_buf - Buffers chained commands by reading from standard input.
+ * save_pending - Keeps the raw text of a line whose quote is still open,
+ * so it can be lexed again together with the next line.
  * @info: Parameter struct.
- * @buf: Address of buffer where input will be stored.
- * @len: Address of len variable (stores buffer size).
+ * @line: The raw line (without its newline).
+ * @len: Length of line.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int save_pending(info_t *info, char *line, size_t len)
+{
+	char *p;
+
+	p = _realloc(info->pending, info->pending_len, info->pending_len + len + 1);
+	if (!p)
+		return (-1);
+	memcpy(p + info->pending_len, line, len);
+	info->pending = p;
+	info->pending_len += len;
+	info->pending[info->pending_len++] = '\n';
+	return (0);
+}
+
+/**
+ * input_buf - Reads the next line of input, copies it into the parse arena
+ * and appends its tokens to info->tokens.
+ * @info: Parameter struct.
+ * @buf: Address of buffer where the raw input line will be stored; it is
+ * reused from line to line (info->arg_cap is its size).
  * Return: Bytes read on success, -1 on EOF or error.
  */
-ssize_t input_buf(info_t *info, char **buf, size_t *len)
+ssize_t input_buf(info_t *info, char **buf)
 {
-	ssize_t r = 0;
-	size_t len_p = 0;
+	ssize_t r = 0, n;
+	size_t len, base = info->tok_count, i;
+	unsigned int first = info->line_count + 1;
+	char *line, *text;
 
-	if (!*len) /* If nothing left in the buffer, fill it */
-	{
-		// bfree((void **)info->cmd_buf); // This line suggests freeing cmd_buf here.
-		// It might be better handled in free_info or specific command chaining logic
-		free(*buf); // Free previous buffer if any
-		*buf = NULL;
+	if (!info->batch)
 		signal(SIGINT, sigintHandler); // Set up Ctrl-C handler
 
 #if USE_GETLINE // Use system getline or custom _getline
-		r = getline(buf, &len_p, stdin);
+	r = getline(buf, &info->arg_cap, stdin);
 #else
-		r = _getline(info, buf, &len_p); // _getline is defined in this file
+	r = _getline(info, buf, &info->arg_cap); // _getline is defined in this file
 #endif
-		if (r > 0)
-		{
-			if ((*buf)[r - 1] == '\n')
-			{
-				(*buf)[r - 1] = '\0'; /* Remove trailing newline */
-				r--;
-			}
-			info->linecount_flag = 1; // Mark this line for counting
-			remove_comments(*buf);    // remove_comments from error_handling/error_utilities.c
-			build_history_list(info, *buf, info->histcount++); // build_history_list from history/history_manager.c
-			/* if (_strchr(*buf, ';')) is this a command chain? */
-			// The original logic for cmd_buf and len update was inside this block:
-			// {
-			// 	*len = r;
-			// 	info->cmd_buf = buf;
-			// }
-			// This logic is better handled outside, in get_input to ensure cmd_buf is set for chaining
-			*len = r;
-			info->cmd_buf = buf; // Point info->cmd_buf to the buffer holding the chain
-		}
+	if (r <= 0)
+		return (-1);
+	if ((*buf)[r - 1] == '\n')
+		(*buf)[--r] = '\0'; /* Remove trailing newline */
+	info->line_count++;
+	if (!info->batch && !hist_add(info, *buf, r)) // hist_add from history/history_manager.c
+		hist_commit(info);
+
+	line = *buf;
+	len = r;
+	if (info->pending_len) // Continue a quote left open on an earlier line
+	{
+		if (save_pending(info, *buf, r))
+			return (-1);
+		line = info->pending;
+		len = --info->pending_len; // Drop the newline save_pending added
+	}
+	text = arena_alloc(&info->parse, len + 2); // Lexing happens on this stable copy
+	if (!text)
+		return (-1);
+	memcpy(text, line, len);
+	text[len] = '\n';
+	text[len + 1] = '\0';
+
+	for (i = 0; i < len; i++) // Lines continued from earlier reads
+		first -= text[i] == '\n';
+	n = lex_line(info, text, first); // lex_line from string_operations/string_tokenization.c
+	if (n == LEX_INCOMPLETE)
+	{
+		info->tok_count = base; // Drop this line's tokens; it is lexed again whole
+		if (line == info->pending) // Already saved, newline included
+			info->pending_len = len + 1;
+		else if (save_pending(info, line, len))
+			return (-1);
 	}
+	else
+		info->pending_len = 0;
+	if (n == LEX_NOMEM)
+		return (-1);
 	return (r);
 }
 
 /**
- * get_input - Gets a line of input, handling command chaining.
- * Processes the buffer to extract one command at a time if chaining.
+ * read_tokens - Reads lines until every quote is closed.
  * @info: Parameter struct.
- * Return: Bytes read (length of the current command), or -1 on EOF/error.
+ * Return: 0 on success, -1 on EOF or error.
  */
-ssize_t get_input(info_t *info)
+static int read_tokens(info_t *info)
 {
-	static char *buf; /* The ';' command chain buffer */
-	static size_t i, j, len; // i: current position, j: iterator, len: buffer length
-	ssize_t r = 0;
-	char **buf_p = &(info->arg), *p; // buf_p points to info->arg, p is pointer to current command start
-
-	_putchar(BUF_FLUSH); // Flush any pending stdout output (_putchar in string_operations/string_manipulation2.c)
-	r = input_buf(info, &buf, &len); // Read a new buffer if needed
-	if (r == -1) /* EOF */
-		return (-1);
-	if (len)	/* We have commands left in the chain buffer */
+	while (1)
 	{
-		j = i; /* Initialize new iterator to current buf position */
-		p = buf + i; /* Get pointer for current command's start */
-
-		check_chain(info, buf, &j, i, len); // Check if we should continue chaining (from variables/command_chaining.c)
-		while (j < len) /* Iterate to semicolon or end of buffer */
+		if (input_buf(info, &info->arg) == -1)
 		{
-			if (is_chain(info, buf, &j)) // is_chain from variables/command_chaining.c
-				break; // Found a chain delimiter
-			j++;
+			if (info->pending_len)
+				syntax_error(info, NULL, "Unterminated quoted string");
+			info->pending_len = 0;
+			return (-1);
 		}
+		if (!info->pending_len)
+			return (0);
+		if (is_interactive(info))
+			_puts("> "); // Secondary prompt: the quote continues
+	}
+}
+
+/**
+ * get_input - Gets the next complete command, reading as many lines as it
+ * needs and parsing them once into an AST.
+ * @info: Parameter struct.
+ * @node: Receives the command's AST (NULL for a blank line or a syntax error).
+ * Return: 0 on success, or -1 on EOF/error.
+ */
+ssize_t get_input(info_t *info, node_t **node)
+{
+	size_t start;
 
-		i = j + 1; /* Increment past nulled ';' (or other delimiter) */
-		if (i >= len) /* Reached end of buffer (no more commands in chain)? */
+	*node = NULL;
+	if (info->tok_pos >= info->tok_count) /* Everything read so far has run */
+	{
+		arena_reset(&info->parse); // Releases the previous lines and their AST
+		info->tok_count = info->tok_pos = 0;
+		if (read_tokens(info) == -1) /* EOF */
+			return (-1);
+	}
+	start = info->tok_pos;
+	while (1)
+	{
+		*node = parse_command(info); // parse_command from shell_core/command_parser.c
+		if (info->parse_err != PARSE_INCOMPLETE)
+			break;
+		if (is_interactive(info))
+			_puts("> "); // Secondary prompt: the command continues
+		if (read_tokens(info) == -1)
 		{
-			i = len = 0; /* Reset position and length for next read */
-			info->cmd_buf_type = CMD_NORM; // Reset command type
+			syntax_error(info, NULL, "end of file unexpected");
+			return (-1);
 		}
-
-		*buf_p = p; /* Pass back pointer to current command position (info->arg) */
-		return (_strlen(p)); /* Return length of current command */
+		info->tok_pos = start; // Parse again with the new line's tokens
 	}
-
-	*buf_p = buf; /* Else not a chain, pass back buffer from _getline() to info->arg */
-	return (r); /* Return length of buffer from _getline() */
+	if (info->parse_err == PARSE_ERROR)
+	{
+		*node = NULL;
+		info->tok_pos = info->tok_count; // Discard the rest of the input read
+	}
+	return (0);
 }
 
 /**
- * read_buf - Reads a buffer from the current read file descriptor.
+ * fill_input - Reads more input into the read-ahead, first moving the
+ * unreturned bytes to the front or doubling the buffer when it is full.
+ * A partial line is moved at most once per read, and only after it was
+ * read, so the total work stays linear in the size of the input. Pending
+ * output (a prompt, or what earlier commands printed) is written out
+ * before the shell may block.
  * @info: Parameter struct containing the read file descriptor.
- * @buf: Buffer to read into.
- * @i: Pointer to a size_t variable to store the number of bytes read.
- * Return: Bytes read.
+ * @in: The read-ahead.
+ * Return: Bytes read, 0 at EOF, -1 on error.
  */
-ssize_t read_buf(info_t *info, char *buf, size_t *i)
+static ssize_t fill_input(info_t *info, linebuf_t *in)
 {
-	ssize_t r = 0;
+	size_t cap = in->cap ? in->cap * 2 : LINE_BUF_SIZE;
+	char *p;
+	ssize_t r;
 
-	if (*i) // If there's already data in the buffer from previous read_buf call
-		return (0);
-	r = read(info->readfd, buf, READ_BUF_SIZE); // Read from the specified fd
-	if (r >= 0)
-		*i = r; // Update the count of bytes read
+	if (in->pos)
+	{
+		memmove(in->buf, in->buf + in->pos, in->len - in->pos);
+		in->len -= in->pos;
+		in->scan -= in->pos;
+		in->pos = 0;
+	}
+	if (in->len == in->cap)
+	{
+		p = _realloc(in->buf, in->len, cap); // _realloc from memory_utils/memory_allocators.c
+		if (!p)
+			return (-1);
+		in->buf = p;
+		in->cap = cap;
+	}
+	do { // flush_read from io_handling/output_buffer.c
+		r = flush_read(info->readfd, in->buf + in->len, in->cap - in->len);
+	} while (r == -1 && errno == EINTR);
+	if (r > 0)
+		in->len += r;
 	return (r);
 }
 
 /**
- * _getline - Gets the next line of input from STDIN (or file).
- * Handles dynamic buffer reallocation if needed.
+ * _getline - Gets the next line of input from the shell's input, like
+ * getline(3). Input is read in large blocks and searched with memchr; each
+ * byte is looked at once however long the line is.
  * @info: Parameter struct.
- * @ptr: Address of pointer to buffer, preallocated or NULL.
- * @length: Size of preallocated ptr buffer if not NULL.
- * Return: Number of characters read (s), or -1 on EOF/error.
+ * @ptr: Address of the line buffer, malloc'd or NULL; grown as needed.
+ * @length: Address of the size of *ptr.
+ * Return: Number of bytes in the line, its newline included, or -1 on
+ * EOF/error.
  */
-int _getline(info_t *info, char **ptr, size_t *length)
+ssize_t _getline(info_t *info, char **ptr, size_t *length)
 {
-	static char buf[READ_BUF_SIZE]; // Static buffer for reading chunks
-	static size_t i, len;           // i: current position in buf, len: total bytes in buf
-	size_t k;                       // Length of current line
-	ssize_t r = 0, s = 0;           // r: bytes read, s: total characters in *ptr
-	char *p = NULL, *new_p = NULL, *c; // p: current *ptr, new_p: reallocated buffer, c: newline char position
-
-	p = *ptr;
-	if (p && length)
-		s = *length; // Get initial length if buffer is preallocated
-	if (i == len) // If current buffer is exhausted
-		i = len = 0; // Reset read buffer position and length
+	linebuf_t *in = &info->in;
+	char *nl = NULL, *p;
+	size_t n, cap;
+	ssize_t r = 1;
 
-	r = read_buf(info, buf, &len); // Read new data into static buffer
-	if (r == -1 || (r == 0 && len == 0)) // EOF or read error
+	while (r > 0)
+	{
+		nl = in->len > in->scan ? memchr(in->buf + in->scan, '\n', in->len - in->scan) : NULL;
+		if (nl)
+			break;
+		in->scan = in->len;
+		r = fill_input(info, in);
+	}
+	n = nl ? (size_t)(nl - in->buf) + 1 - in->pos : in->len - in->pos;
+	if (!n || r < 0) // EOF with nothing left, or a read error
 		return (-1);
-
-	// Find newline in the static buffer, or assume whole buffer is one line
-	c = _strchr(buf + i, '\n'); // _strchr from string_operations/string_manipulation1.c
-	k = c ? 1 + (unsigned int)(c - buf) : len; // Length to copy (including newline)
-
-	// Reallocate *ptr to accommodate new line + existing data
-	new_p = _realloc(p, s, s ? s + k : k + 1); // _realloc from memory_utils/memory_allocators.c
-	if (!new_p) /* MALLOC FAILURE! */
-		return (p ? (free(p), -1) : -1); // Free old buffer if it existed
-
-	if (s) // If *ptr already had content, concatenate
-		_strncat(new_p, buf + i, k - i); // _strncat from string_operations/string_manipulation1.c
-	else // Else, copy from scratch
-		_strncpy(new_p, buf + i, k - i + 1); // _strncpy from string_operations/string_manipulation1.c
-
-	s += k - i; // Update total length of line
-	i = k;      // Update static buffer position
-	p = new_p;  // Update pointer to new buffer
-
-	if (length)
-		*length = s; // Pass back new total length
-	*ptr = p;    // Pass back pointer to the line
-	return (s);  // Return length of the line
+	if (*length < n + 1)
+	{
+		cap = *length * 2 > n + 1 ? *length * 2 : n + 1;
+		p = malloc(cap); // Nothing in the old line is kept
+		if (!p)
+			return (-1);
+		free(*ptr);
+		*ptr = p;
+		*length = cap;
+	}
+	memcpy(*ptr, in->buf + in->pos, n);
+	(*ptr)[n] = '\0';
+	in->pos += n;
+	in->scan = in->pos;
+	if (in->pos == in->len) // Start over at the front of the buffer
+		in->pos = in->len = in->scan = 0;
+	return (n);
 }
 
 /**
@@ -0,0 +1,268 @@
+#include "../includes/shell.h"
+#include <sys/uio.h>
+
+/*
+ * All of the shell's own output goes through one buffer per file
+ * descriptor. A terminal is line buffered, as is stderr wherever it goes;
+ * pipes and files are fully buffered, and data that does not fit is
+ * written together with the buffer in one writev(). Besides that, output
+ * is only written before the shell forks or blocks reading its input
+ * (flush_output) and when it exits. Before stderr is written, stdout is
+ * flushed, so the two keep their order when they share a file. Built with
+ * io_uring support, the writes go through the ring (io_handling/uring_io.c).
+ */
+#define OUT_UNKNOWN 0 // Not used since it was last flushed (for fds > 2)
+#define OUT_LINE    1
+#define OUT_FULL    2
+
+/**
+ * struct outbuf - Pending output of one file descriptor
+ * @buf: OUT_BUF_SIZE bytes, allocated on first use.
+ * @len: Bytes waiting in @buf.
+ * @mode: OUT_LINE or OUT_FULL, or OUT_UNKNOWN until the fd is written to.
+ */
+typedef struct outbuf
+{
+	char *buf;
+	size_t len;
+	int mode;
+} outbuf_t;
+
+static outbuf_t outs[OUT_MAX_FD];
+
+/**
+ * write_all - Writes out a set of buffers, resuming after short writes.
+ * @fd: The file descriptor.
+ * @iov: The buffers; consumed.
+ * @n: Number of buffers.
+ * Return: 0 on success, -1 on error.
+ */
+static int write_all(int fd, struct iovec *iov, int n)
+{
+	ssize_t w;
+	int i;
+
+	if (uring_ready()) // uring_ready from io_handling/uring_io.c
+	{
+		for (i = 0; i < n; i++)
+			uring_queue(fd, iov[i].iov_base, iov[i].iov_len);
+		return (uring_submit(-1, NULL, 0) ? -1 : 0);
+	}
+	while (n)
+	{
+		w = writev(fd, iov, n);
+		if (w == -1 && errno == EINTR)
+			continue;
+		if (w == -1)
+			return (-1);
+		for (; n && (size_t)w >= iov->iov_len; iov++, n--)
+			w -= iov->iov_len;
+		if (n)
+		{
+			iov->iov_base = (char *)iov->iov_base + w;
+			iov->iov_len -= w;
+		}
+	}
+	return (0);
+}
+
+/**
+ * drain - Writes a buffer's pending bytes followed by more data.
+ * @fd: The file descriptor.
+ * @o: Its buffer.
+ * @s: The data, or NULL.
+ * @n: Length of the data.
+ * Return: 0 on success, -1 on error.
+ */
+static int drain(int fd, outbuf_t *o, const char *s, size_t n)
+{
+	struct iovec iov[2];
+	int k = 0;
+
+	if (fd == 2)
+		out_flush(1); // What was printed before the error comes first
+	if (o->len)
+	{
+		iov[k].iov_base = o->buf;
+		iov[k++].iov_len = o->len;
+	}
+	if (n)
+	{
+		iov[k].iov_base = (char *)s;
+		iov[k++].iov_len = n;
+	}
+	o->len = 0;
+	return (write_all(fd, iov, k));
+}
+
+/**
+ * out_get - Finds the buffer of a file descriptor, choosing its mode on
+ * first use.
+ * @fd: The file descriptor.
+ * Return: The buffer, or NULL if the fd is written to unbuffered.
+ */
+static outbuf_t *out_get(int fd)
+{
+	outbuf_t *o;
+
+	if (fd < 0 || fd >= OUT_MAX_FD)
+		return (NULL);
+	o = &outs[fd];
+	if (!o->buf)
+	{
+		o->buf = uring_buffer(fd); // Registered with the ring, if in use
+		if (!o->buf)
+			o->buf = malloc(OUT_BUF_SIZE);
+		if (!o->buf)
+			return (NULL);
+	}
+	if (o->mode == OUT_UNKNOWN)
+		o->mode = fd == 2 || isatty(fd) ? OUT_LINE : OUT_FULL;
+	return (o);
+}
+
+/**
+ * out_write - Writes bytes to a file descriptor through its buffer.
+ * @fd: The file descriptor.
+ * @s: The bytes.
+ * @n: Number of bytes.
+ * Return: n, or -1 on error.
+ */
+ssize_t out_write(int fd, const char *s, size_t n)
+{
+	outbuf_t *o = out_get(fd), tmp = {NULL, 0, OUT_FULL};
+
+	if (!o)
+		return (drain(fd, &tmp, s, n) ? -1 : (ssize_t)n);
+	if (o->len + n > OUT_BUF_SIZE) // Too big: written along with the buffer
+		return (drain(fd, o, s, n) ? -1 : (ssize_t)n);
+	memcpy(o->buf + o->len, s, n);
+	o->len += n;
+	if (o->mode == OUT_LINE && memchr(s, '\n', n))
+		return (drain(fd, o, NULL, 0) ? -1 : (ssize_t)n);
+	return (n);
+}
+
+/**
+ * out_line - Writes complete lines with a single write(), together with
+ * anything still buffered ahead of them, so that they are never split
+ * (which keeps them whole on a pipe or an O_APPEND file shared with other
+ * writers, up to PIPE_BUF bytes).
+ * @fd: The file descriptor.
+ * @s: The lines.
+ * @n: Their length.
+ * Return: n, or -1 on error.
+ */
+ssize_t out_line(int fd, const char *s, size_t n)
+{
+	outbuf_t *o = out_get(fd), tmp = {NULL, 0, OUT_FULL};
+
+	if (!o)
+		o = &tmp;
+	if (o->len && o->len + n <= OUT_BUF_SIZE) // One buffer, so one write
+	{
+		memcpy(o->buf + o->len, s, n);
+		o->len += n;
+		return (drain(fd, o, NULL, 0) ? -1 : (ssize_t)n);
+	}
+	return (drain(fd, o, s, n) ? -1 : (ssize_t)n);
+}
+
+/**
+ * out_putc - Writes one character to a file descriptor through its buffer.
+ * @fd: The file descriptor.
+ * @c: The character.
+ * Return: 1, or -1 on error.
+ */
+int out_putc(int fd, char c)
+{
+	outbuf_t *o = fd >= 0 && fd < OUT_MAX_FD ? &outs[fd] : NULL;
+
+	if (o && o->buf && o->mode == OUT_FULL && o->len < OUT_BUF_SIZE)
+	{
+		o->buf[o->len++] = c; // The common case
+		return (1);
+	}
+	return (out_write(fd, &c, 1) == -1 ? -1 : 1);
+}
+
+/**
+ * out_flush - Writes out what is buffered for a file descriptor. An fd
+ * above 2 is about to be closed, as a rule, so its mode is chosen again
+ * the next time it is written to.
+ * @fd: The file descriptor.
+ * Return: 0 on success, -1 on error.
+ */
+int out_flush(int fd)
+{
+	outbuf_t *o;
+	int r = 0;
+
+	if (fd < 0 || fd >= OUT_MAX_FD)
+		return (0);
+	o = &outs[fd];
+	if (o->len)
+		r = drain(fd, o, NULL, 0);
+	if (fd > 2)
+		o->mode = OUT_UNKNOWN;
+	return (r);
+}
+
+/**
+ * queue_output - Queues every buffer's pending bytes on the io_uring ring,
+ * in fd order so that stdout still comes before stderr.
+ * Return: 1 if they were queued, 0 if the ring is not in use.
+ */
+static int queue_output(void)
+{
+	int fd;
+
+	if (!uring_ready())
+		return (0);
+	for (fd = 0; fd < OUT_MAX_FD; fd++)
+	{
+		if (!outs[fd].len)
+			continue;
+		uring_queue(fd, outs[fd].buf, outs[fd].len);
+		outs[fd].len = 0; // The bytes stay put until submitted
+		if (fd > 2)
+			outs[fd].mode = OUT_UNKNOWN;
+	}
+	return (1);
+}
+
+/**
+ * flush_output - Writes out every buffer. Called before the shell forks,
+ * so that a child does not inherit (and write again) pending output.
+ */
+void flush_output(void)
+{
+	int fd;
+
+	if (queue_output())
+	{
+		uring_submit(-1, NULL, 0); // uring_submit from io_handling/uring_io.c
+		return;
+	}
+	for (fd = 0; fd < OUT_MAX_FD; fd++)
+		if (outs[fd].len)
+			out_flush(fd);
+}
+
+/**
+ * flush_read - Writes out every buffer, then reads input. The shell calls
+ * it when it may block, so that prompts and the output of earlier commands
+ * are seen first. With io_uring, the writes and the read are submitted
+ * together.
+ * @fd: The file descriptor to read.
+ * @buf: Where to read to.
+ * @n: How many bytes to read at most.
+ * Return: Bytes read, 0 at EOF, -1 on error.
+ */
+ssize_t flush_read(int fd, void *buf, size_t n)
+{
+	if (queue_output())
+		return (uring_submit(fd, buf, n));
+	flush_output();
+	return (read(fd, buf, n));
+}
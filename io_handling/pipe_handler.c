@@ -0,0 +1,119 @@
+#include "../includes/shell.h"
+
+/**
+ * pipeline_length - Counts the commands in a pipeline.
+ * @node: The pipeline (a chain of NODE_PIPE nodes).
+ * Return: The number of commands.
+ */
+static int pipeline_length(node_t *node)
+{
+	int n = 1;
+
+	for (; node->type == NODE_PIPE; node = node->kid[1])
+		n++;
+	return (n);
+}
+
+/**
+ * run_stage - Body of a forked pipeline stage: wires up stdin/stdout and
+ * evaluates the stage's command.
+ * @info: The parameter struct.
+ * @cmd: The stage's command.
+ * @in: Read end of the previous pipe, or -1 for the shell's stdin.
+ * @fds: The pipe to the next stage, or NULL for the last stage.
+ * Return: Never returns.
+ */
+static void run_stage(info_t *info, node_t *cmd, int in, int *fds)
+{
+	if (in != -1)
+	{
+		dup2(in, STDIN_FILENO);
+		close(in);
+	}
+	if (fds)
+	{
+		close(fds[0]);
+		dup2(fds[1], STDOUT_FILENO);
+		close(fds[1]);
+	}
+	info->forked = (cmd->type == NODE_CMD); // A simple command can exec in place
+	eval_node(info, cmd);
+	child_exit(info); // child_exit from shell_core/command_executor.c
+}
+
+/**
+ * eval_pipeline - Runs cmd1 | cmd2 | ... with each stage in its own process.
+ * @info: The parameter struct.
+ * @node: A NODE_PIPE node.
+ * Return: The exit status of the last stage.
+ */
+int eval_pipeline(info_t *info, node_t *node)
+{
+	int fds[2], in = -1, i, n = pipeline_length(node), status;
+	pid_t *pids = malloc(sizeof(pid_t) * n);
+	node_t *cmd;
+
+	if (!pids)
+		return (info->status = 1);
+	flush_output(); // Stages must not inherit unflushed output
+	for (i = 0; i < n; i++, node = node->kid[1])
+	{
+		cmd = node->type == NODE_PIPE ? node->kid[0] : node;
+		if (i < n - 1 && pipe(fds) == -1)
+			break;
+		pids[i] = fork();
+		if (pids[i] == -1)
+			break;
+		if (pids[i] == 0)
+			run_stage(info, cmd, in, i < n - 1 ? fds : NULL);
+		if (in != -1)
+			close(in);
+		if (i < n - 1)
+		{
+			close(fds[1]);
+			in = fds[0];
+		}
+	}
+	if (i < n) // pipe() or fork() failed part way
+	{
+		perror("Error:");
+		if (in != -1)
+			close(in);
+		info->status = 1;
+	}
+	status = info->status;
+	while (i-- > 0)
+	{
+		wait_child(info, pids[i]); // The last stage is waited for first
+		if (i == n - 1)
+			status = info->status; // It alone gives the pipeline its status
+	}
+	free(pids);
+	return (info->status = status);
+}
+
+/**
+ * eval_subshell - Runs '( list )' in a child process so changes it makes
+ * (directory, environment, exit) do not affect the shell.
+ * @info: The parameter struct.
+ * @node: A NODE_SUBSHELL node.
+ * Return: The subshell's exit status.
+ */
+int eval_subshell(info_t *info, node_t *node)
+{
+	pid_t pid;
+
+	flush_output();
+	pid = fork();
+	if (pid == -1)
+	{
+		perror("Error:");
+		return (info->status = 1);
+	}
+	if (pid == 0)
+	{
+		eval_node(info, node->kid[0]);
+		child_exit(info);
+	}
+	return (wait_child(info, pid));
+}
@@ -0,0 +1,498 @@
+#include "../includes/shell.h"
+#include <stdint.h>
+
+/*
+ * A cache file holds one compiled script: a header identifying the script,
+ * then the script's AST as a packed image (see ast_pack). The image has
+ * its own header, then the arithmetic nodes, AST nodes and words as
+ * fixed-size records that refer to each other by index (-1 for NULL), then
+ * a table of NUL-terminated strings. Loading maps the file and rebuilds
+ * the pointers in one pass.
+ */
+#define CACHE_MAGIC "HSHC"
+#define CACHE_VERSION 5
+#define AST_VERSION 4 // Bumped whenever the record layout or the parser changes
+
+/**
+ * struct cache_head - Header of a compiled-script cache file
+ * @magic: CACHE_MAGIC.
+ * @version: CACHE_VERSION; bumped whenever the file layout changes.
+ * @dev: Device of the script the entry was compiled from.
+ * @ino: Inode of the script.
+ * @size: Size of the script.
+ * @mtime: Modification time of the script, seconds.
+ * @mtime_ns: Modification time of the script, nanoseconds.
+ */
+typedef struct cache_head
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t dev;
+	uint64_t ino;
+	uint64_t size;
+	int64_t mtime;
+	int64_t mtime_ns;
+} cache_head_t;
+
+/**
+ * struct ast_head - Header of a packed AST image
+ * @version: AST_VERSION.
+ * @nnodes: Number of node records.
+ * @nwords: Number of word records.
+ * @nariths: Number of arithmetic records.
+ * @strsize: Bytes in the string table.
+ * @root: Index of the root node, or -1 for an empty AST.
+ */
+typedef struct ast_head
+{
+	uint32_t version;
+	uint32_t nnodes;
+	uint32_t nwords;
+	uint32_t nariths;
+	uint32_t strsize;
+	int32_t root;
+} ast_head_t;
+
+/**
+ * struct cache_arith - An arith_t record
+ * @num: Constant value.
+ * @op: A_* operator.
+ * @name: String offset of the variable name, or -1.
+ * @kid: Operand indexes, or -1.
+ * @pad: Keeps the record 8-byte aligned.
+ */
+typedef struct cache_arith
+{
+	int64_t num;
+	int32_t op;
+	int32_t name;
+	int32_t kid[3];
+	int32_t pad;
+} cache_arith_t;
+
+/**
+ * struct cache_node - A node_t record
+ * @type: NODE_* type.
+ * @nwords: Number of words.
+ * @words: Index of the first word, or -1.
+ * @line: Line the node starts on.
+ * @kid: Child node indexes, or -1.
+ * @ex: Arithmetic expression indexes, or -1.
+ */
+typedef struct cache_node
+{
+	int32_t type;
+	int32_t nwords;
+	int32_t words;
+	uint32_t line;
+	int32_t kid[3];
+	int32_t ex[3];
+} cache_node_t;
+
+/**
+ * struct cache_word - A word_t record
+ * @str: String offset.
+ * @flags: W_* flags.
+ */
+typedef struct cache_word
+{
+	int32_t str;
+	int32_t flags;
+} cache_word_t;
+
+/**
+ * struct cache_writer - Serialization state; with NULL arrays it only counts
+ * @n: Node records.
+ * @w: Word records.
+ * @a: Arithmetic records.
+ * @s: String table.
+ * @nn: Nodes so far.
+ * @nw: Words so far.
+ * @na: Arithmetic nodes so far.
+ * @ns: String bytes so far.
+ */
+typedef struct cache_writer
+{
+	cache_node_t *n;
+	cache_word_t *w;
+	cache_arith_t *a;
+	char *s;
+	uint32_t nn, nw, na, ns;
+} cache_writer_t;
+
+/**
+ * cache_path - Builds the cache file name for a script.
+ * The file lives in $XDG_CACHE_HOME/hsh (or ~/.cache/hsh) and is named
+ * after a hash of the script's canonical path.
+ * @info: The parameter struct.
+ * @script: The script's canonical path.
+ * @mkdirs: Create the cache directory, and the one it is in, if they do
+ * not exist.
+ * Return: A malloc'd path, or NULL if there is no usable cache directory.
+ */
+static char *cache_path(info_t *info, char *script, int mkdirs)
+{
+	char *base = _getenv(info, "XDG_CACHE_HOME="), *dir = "/hsh", *path, *p;
+	unsigned long h = hash_string(script); // hash_string from linked_lists/hash_table.c
+
+	if (!base || *base != '/')
+	{
+		base = _getenv(info, "HOME=");
+		dir = "/.cache/hsh";
+	}
+	if (!base || *base != '/')
+		return (NULL);
+	path = malloc(_strlen(base) + _strlen(dir) + 1 + 16 + sizeof(".hshc"));
+	if (!path)
+		return (NULL);
+	_strcpy(path, base);
+	_strcat(path, dir);
+	p = path + _strlen(path);
+	if (mkdirs) // $XDG_CACHE_HOME or ~/.cache may not exist yet either
+	{
+		p[-4] = '\0'; // Cut the "/hsh"
+		mkdir(path, 0700);
+		p[-4] = '/';
+		mkdir(path, 0700);
+	}
+	*p++ = '/';
+	p += fmt_hex(h, p, 16); // fmt_hex from memory_utils/string_converters.c
+	_strcpy(p, ".hshc");
+	return (path);
+}
+
+/**
+ * put_str - Adds a string to the string table.
+ * @wr: The writer.
+ * @s: The string, or NULL.
+ * Return: Its offset, or -1 for NULL.
+ */
+static int32_t put_str(cache_writer_t *wr, char *s)
+{
+	uint32_t off = wr->ns, len;
+
+	if (!s)
+		return (-1);
+	len = _strlen(s) + 1;
+	if (wr->s)
+		memcpy(wr->s + off, s, len);
+	wr->ns += len;
+	return (off);
+}
+
+/**
+ * put_arith - Serializes an arithmetic expression, parent before children.
+ * @wr: The writer.
+ * @e: The expression, or NULL.
+ * Return: Its record index, or -1 for NULL.
+ */
+static int32_t put_arith(cache_writer_t *wr, arith_t *e)
+{
+	uint32_t i = wr->na, k;
+	int32_t kid;
+
+	if (!e)
+		return (-1);
+	wr->na++;
+	if (wr->a)
+	{
+		wr->a[i].num = e->num;
+		wr->a[i].op = e->op;
+		wr->a[i].pad = 0;
+	}
+	kid = put_str(wr, e->name);
+	if (wr->a)
+		wr->a[i].name = kid;
+	for (k = 0; k < 3; k++)
+	{
+		kid = put_arith(wr, e->kid[k]);
+		if (wr->a)
+			wr->a[i].kid[k] = kid;
+	}
+	return (i);
+}
+
+/**
+ * put_node - Serializes an AST, parent before children. The kid[1] chain
+ * (the commands of a list, one after another) is followed in a loop, so a
+ * script of any length does not nest calls.
+ * @wr: The writer.
+ * @n: The AST, or NULL.
+ * Return: Its record index, or -1 for NULL.
+ */
+static int32_t put_node(cache_writer_t *wr, node_t *n)
+{
+	int32_t first = n ? (int32_t)wr->nn : -1, kid;
+	uint32_t i, k;
+
+	for (; n; n = n->kid[1])
+	{
+		i = wr->nn++;
+		if (wr->n)
+		{
+			wr->n[i].type = n->type;
+			wr->n[i].nwords = n->nwords;
+			wr->n[i].words = n->nwords ? (int32_t)wr->nw : -1;
+			wr->n[i].line = n->line;
+		}
+		for (k = 0; k < (uint32_t)n->nwords; k++, wr->nw++)
+		{
+			kid = put_str(wr, n->words[k].str);
+			if (wr->w)
+			{
+				wr->w[wr->nw].str = kid;
+				wr->w[wr->nw].flags = n->words[k].flags;
+			}
+		}
+		for (k = 0; k < 3; k++)
+		{
+			kid = k == 1 ? -1 : put_node(wr, n->kid[k]);
+			if (wr->n)
+				wr->n[i].kid[k] = kid;
+			kid = put_arith(wr, n->ex[k]);
+			if (wr->n)
+				wr->n[i].ex[k] = kid;
+		}
+		if (wr->n && n->kid[1]) // The next record is the one the loop writes
+			wr->n[i].kid[1] = wr->nn;
+	}
+	return (first);
+}
+
+/**
+ * ast_pack - Packs an AST into a relocatable image (see ast_unpack).
+ * @root: The AST, or NULL.
+ * @buf: Where to write the image, or NULL to only measure it.
+ * Return: Size of the image.
+ */
+size_t ast_pack(node_t *root, void *buf)
+{
+	cache_writer_t wr;
+	ast_head_t *h = buf;
+	size_t len;
+
+	_memset((char *)&wr, 0, sizeof(wr));
+	put_node(&wr, root); // First pass: sizes only
+	len = sizeof(ast_head_t) + wr.na * sizeof(cache_arith_t)
+		+ wr.nn * sizeof(cache_node_t) + wr.nw * sizeof(cache_word_t) + wr.ns;
+	if (!h)
+		return (len);
+	h->version = AST_VERSION;
+	h->nariths = wr.na;
+	h->nnodes = wr.nn;
+	h->nwords = wr.nw;
+	h->strsize = wr.ns;
+	wr.a = (cache_arith_t *)(h + 1);
+	wr.n = (cache_node_t *)(wr.a + wr.na);
+	wr.w = (cache_word_t *)(wr.n + wr.nn);
+	wr.s = (char *)(wr.w + wr.nw);
+	wr.na = wr.nn = wr.nw = wr.ns = 0;
+	h->root = put_node(&wr, root);
+	return (len);
+}
+
+/**
+ * cache_store - Writes a compiled script to the cache. The file is written
+ * under a temporary name and renamed, so a reader never sees half of it.
+ * @info: The parameter struct.
+ * @sc: The compiled script.
+ * Return: 0 on success, -1 if it could not be stored.
+ */
+int cache_store(info_t *info, script_t *sc)
+{
+	cache_head_t *h;
+	char *path = cache_path(info, sc->path, 1), *tmp = NULL, *buf = NULL;
+	size_t len = sizeof(cache_head_t) + ast_pack(sc->root, NULL);
+	ssize_t w = -1;
+	int fd = -1;
+
+	if (path && len < INT32_MAX)
+		buf = calloc(1, len);
+	if (path && buf)
+		tmp = malloc(_strlen(path) + 1 + NUM_BUF_SIZE);
+	if (tmp)
+	{
+		h = (cache_head_t *)buf;
+		memcpy(h->magic, CACHE_MAGIC, 4);
+		h->version = CACHE_VERSION;
+		h->dev = sc->st.st_dev;
+		h->ino = sc->st.st_ino;
+		h->size = sc->st.st_size;
+		h->mtime = sc->st.st_mtim.tv_sec;
+		h->mtime_ns = sc->st.st_mtim.tv_nsec;
+		ast_pack(sc->root, h + 1);
+		_strcpy(tmp, path);
+		_strcat(tmp, ".");
+		fmt_unsigned(getpid(), tmp + _strlen(tmp)); // fmt_unsigned from memory_utils/string_converters.c
+		fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	}
+	if (fd != -1)
+	{
+		w = write(fd, buf, len);
+		close(fd);
+		if (w != (ssize_t)len || rename(tmp, path) == -1)
+		{
+			unlink(tmp);
+			w = -1;
+		}
+	}
+	free(tmp);
+	free(buf);
+	free(path);
+	return (w == -1 ? -1 : 0);
+}
+
+/**
+ * check_head - Checks that a cache file was compiled from the script as
+ * it is now.
+ * @h: The mapped header.
+ * @len: Size of the mapping.
+ * @st: The script's stat().
+ * Return: 1 if the entry can be used, 0 otherwise.
+ */
+static int check_head(cache_head_t *h, size_t len, struct stat *st)
+{
+	return (len >= sizeof(*h) && !memcmp(h->magic, CACHE_MAGIC, 4)
+		&& h->version == CACHE_VERSION
+		&& h->dev == (uint64_t)st->st_dev && h->ino == (uint64_t)st->st_ino
+		&& h->size == (uint64_t)st->st_size
+		&& h->mtime == (int64_t)st->st_mtim.tv_sec
+		&& h->mtime_ns == (int64_t)st->st_mtim.tv_nsec);
+}
+
+/**
+ * ref_ok - Checks a record's reference to a later record.
+ * Children always come after their parent, so a valid image has no cycles.
+ * @ref: The index, or -1.
+ * @self: Index of the referring record, or -1 for references across kinds.
+ * @count: Number of records of the referenced kind.
+ * Return: 1 if it is valid, 0 otherwise.
+ */
+static int ref_ok(int32_t ref, int32_t self, uint32_t count)
+{
+	return (ref == -1 || (ref > self && (uint32_t)ref < count));
+}
+
+/**
+ * relocate - Rebuilds an AST from its packed records.
+ * @mem: Arena receiving the nodes.
+ * @h: The image's header.
+ * @root: Receives the root node.
+ * Return: 0 on success, -1 if the image is corrupt or memory ran out.
+ */
+static int relocate(arena_t *mem, ast_head_t *h, node_t **root)
+{
+	cache_arith_t *ca = (cache_arith_t *)(h + 1);
+	cache_node_t *cn = (cache_node_t *)(ca + h->nariths);
+	cache_word_t *cw = (cache_word_t *)(cn + h->nnodes);
+	char *str = (char *)(cw + h->nwords);
+	arith_t *a = arena_alloc(mem, sizeof(arith_t) * h->nariths + 1);
+	node_t *n = arena_alloc(mem, sizeof(node_t) * h->nnodes + 1);
+	word_t *w = arena_alloc(mem, sizeof(word_t) * h->nwords + 1);
+	uint32_t i, k;
+
+	if (!a || !n || !w)
+		return (-1);
+	for (i = 0; i < h->nwords; i++)
+	{
+		if (!ref_ok(cw[i].str, -1, h->strsize))
+			return (-1);
+		w[i].str = str + cw[i].str;
+		w[i].flags = cw[i].flags;
+	}
+	for (i = 0; i < h->nariths; i++)
+	{
+		a[i].op = ca[i].op;
+		a[i].num = ca[i].num;
+		if (!ref_ok(ca[i].name, -1, h->strsize))
+			return (-1);
+		a[i].name = ca[i].name == -1 ? NULL : str + ca[i].name;
+		for (k = 0; k < 3; k++)
+		{
+			if (!ref_ok(ca[i].kid[k], i, h->nariths))
+				return (-1);
+			a[i].kid[k] = ca[i].kid[k] == -1 ? NULL : &a[ca[i].kid[k]];
+		}
+	}
+	for (i = 0; i < h->nnodes; i++)
+	{
+		n[i].type = cn[i].type;
+		n[i].nwords = cn[i].nwords;
+		n[i].line = cn[i].line;
+		if (cn[i].nwords < 0 || (cn[i].nwords && (cn[i].words < 0
+			|| (uint64_t)cn[i].words + cn[i].nwords > h->nwords)))
+			return (-1);
+		n[i].words = cn[i].nwords ? &w[cn[i].words] : NULL;
+		for (k = 0; k < 3; k++)
+		{
+			if (!ref_ok(cn[i].kid[k], i, h->nnodes) || !ref_ok(cn[i].ex[k], -1, h->nariths))
+				return (-1);
+			n[i].kid[k] = cn[i].kid[k] == -1 ? NULL : &n[cn[i].kid[k]];
+			n[i].ex[k] = cn[i].ex[k] == -1 ? NULL : &a[cn[i].ex[k]];
+		}
+	}
+	*root = h->root == -1 ? NULL : &n[h->root];
+	return (0);
+}
+
+/**
+ * ast_unpack - Rebuilds an AST from an image made by ast_pack. The image
+ * must be 8-byte aligned; the AST's strings point into it, so it has to
+ * stay mapped (and writable) for as long as the AST is used.
+ * @mem: Arena receiving the nodes.
+ * @buf: The image.
+ * @len: Size of the image.
+ * @root: Receives the AST (NULL for an empty one).
+ * Return: 0 on success, -1 if the image is corrupt or memory ran out.
+ */
+int ast_unpack(arena_t *mem, void *buf, size_t len, node_t **root)
+{
+	ast_head_t *h = buf;
+
+	if (len < sizeof(*h) || h->version != AST_VERSION
+		|| len != sizeof(*h) + (uint64_t)h->nariths * sizeof(cache_arith_t)
+		+ (uint64_t)h->nnodes * sizeof(cache_node_t)
+		+ (uint64_t)h->nwords * sizeof(cache_word_t) + h->strsize)
+		return (-1);
+	if (h->strsize && ((char *)buf)[len - 1] != '\0')
+		return (-1);
+	if (h->root < -1 || (h->root != -1 && (uint32_t)h->root >= h->nnodes))
+		return (-1);
+	return (relocate(mem, h, root));
+}
+
+/**
+ * cache_load - Loads a compiled script from the cache. The entry is mapped
+ * rather than read; the AST's strings point into the mapping, which the
+ * caller unmaps (sc->map) once the script has run.
+ * @info: The parameter struct.
+ * @sc: The script; path and st are set.
+ * Return: 0 if the script was loaded, -1 on a miss.
+ */
+int cache_load(info_t *info, script_t *sc)
+{
+	char *path = cache_path(info, sc->path, 0);
+	struct stat st;
+	void *map = MAP_FAILED;
+	int fd = path ? open(path, O_RDONLY) : -1;
+
+	free(path);
+	if (fd == -1)
+		return (-1);
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+		map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return (-1);
+	if (!check_head(map, st.st_size, &sc->st) || ast_unpack(&sc->mem,
+		(cache_head_t *)map + 1, st.st_size - sizeof(cache_head_t), &sc->root))
+	{
+		munmap(map, st.st_size);
+		arena_free(&sc->mem);
+		sc->root = NULL;
+		return (-1);
+	}
+	sc->map = map;
+	sc->map_len = st.st_size;
+	return (0);
+}
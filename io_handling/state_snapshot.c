@@ -0,0 +1,439 @@
+#include "../includes/shell.h"
+#include <stdint.h>
+
+/*
+ * A state file holds what a shell has built up: its environment, aliases,
+ * functions and history. It starts with a header, then one fixed-size
+ * record per item, then the data the records refer to by offset from the
+ * start of the file. Nothing in it depends on where it is mapped, so a
+ * new shell maps the file, checks it and takes the items over without
+ * lexing or parsing any text: aliases keep the words they were split into,
+ * and function bodies are packed ASTs (see ast_pack) rebuilt in one pass,
+ * their strings left in the mapping. Environment strings, history lines
+ * and alias texts are copied out, since they are freed one by one.
+ */
+#define STATE_MAGIC "HSHS"
+#define STATE_VERSION 1
+
+/**
+ * struct state_str - A string in the data area
+ * @off: Offset of the string; it is followed by a NUL.
+ * @len: Length of the string.
+ */
+typedef struct state_str
+{
+	uint32_t off;
+	uint32_t len;
+} state_str_t;
+
+/**
+ * struct state_head - Header of a state file
+ * @magic: STATE_MAGIC.
+ * @version: STATE_VERSION; bumped whenever the layout changes.
+ * @size: Size of the file.
+ * @nenv: Number of environment records ("NAME=value" strings).
+ * @nhist: Number of history records, oldest first.
+ * @nalias: Number of alias records.
+ * @nfunc: Number of function records.
+ */
+typedef struct state_head
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t size;
+	uint32_t nenv;
+	uint32_t nhist;
+	uint32_t nalias;
+	uint32_t nfunc;
+} state_head_t;
+
+/**
+ * struct state_alias - An alias record
+ * @name: The alias name.
+ * @value: The value as it was given.
+ * @text: The value split into words, NUL-separated; its length counts
+ * the final NUL, like alias_t's len.
+ * @words: Offset of the alias's word records.
+ * @nwords: Number of words.
+ * @more: The value ends with a blank.
+ */
+typedef struct state_alias
+{
+	state_str_t name;
+	state_str_t value;
+	state_str_t text;
+	uint32_t words;
+	int32_t nwords;
+	int32_t more;
+	int32_t pad;
+} state_alias_t;
+
+/**
+ * struct state_word - A word of an alias
+ * @off: Offset of the word in the alias's text.
+ * @flags: W_* flags.
+ */
+typedef struct state_word
+{
+	uint32_t off;
+	int32_t flags;
+} state_word_t;
+
+/**
+ * struct state_func - A function record
+ * @name: The function's name.
+ * @body: Offset of the packed body; 8-byte aligned.
+ * @len: Size of the packed body.
+ */
+typedef struct state_func
+{
+	state_str_t name;
+	uint32_t body;
+	uint32_t len;
+} state_func_t;
+
+/**
+ * struct state_writer - Serialization state; with a NULL buffer it only counts
+ * @buf: The file image.
+ * @len: Bytes used so far.
+ */
+typedef struct state_writer
+{
+	char *buf;
+	size_t len;
+} state_writer_t;
+
+/**
+ * put_data - Appends bytes to the data area.
+ * @wr: The writer.
+ * @p: The bytes, or NULL to only reserve room for them.
+ * @n: Number of bytes.
+ * @align: Alignment of the first byte, a power of two.
+ * Return: Their offset.
+ */
+static uint32_t put_data(state_writer_t *wr, const void *p, size_t n, size_t align)
+{
+	uint32_t off;
+
+	wr->len = (wr->len + align - 1) & ~(align - 1);
+	off = wr->len;
+	if (wr->buf && p)
+		memcpy(wr->buf + off, p, n);
+	wr->len += n;
+	return (off);
+}
+
+/**
+ * put_string - Appends a string, NUL included, to the data area.
+ * @wr: The writer.
+ * @rec: Receives the string's offset and length (when writing).
+ * @s: The string.
+ * @len: Its length.
+ */
+static void put_string(state_writer_t *wr, state_str_t *rec, const char *s, size_t len)
+{
+	uint32_t off = put_data(wr, s, len + 1, 1);
+
+	if (wr->buf)
+	{
+		rec->off = off;
+		rec->len = len;
+	}
+}
+
+/**
+ * put_alias - Appends an alias to the data area.
+ * @wr: The writer.
+ * @rec: Offset of the alias record.
+ * @name: The alias name.
+ * @a: The alias.
+ */
+static void put_alias(state_writer_t *wr, size_t rec, char *name, alias_t *a)
+{
+	state_alias_t tmp, *r = wr->buf ? (state_alias_t *)(wr->buf + rec) : &tmp;
+	state_word_t *w;
+	int i;
+
+	put_string(wr, &r->name, name, _strlen(name));
+	put_string(wr, &r->value, a->value, a->len - 1);
+	put_string(wr, &r->text, a->text, a->len - 1);
+	r->words = put_data(wr, NULL, sizeof(state_word_t) * a->nwords, 8);
+	if (!wr->buf)
+		return;
+	w = (state_word_t *)(wr->buf + r->words);
+	for (i = 0; i < a->nwords; i++)
+	{
+		w[i].off = a->words[i].str - a->text;
+		w[i].flags = a->words[i].flags;
+	}
+	r->nwords = a->nwords;
+	r->more = a->more;
+	r->pad = 0;
+}
+
+/**
+ * put_func - Appends a function to the data area.
+ * @wr: The writer.
+ * @rec: Offset of the function record.
+ * @name: The function's name.
+ * @f: The function.
+ */
+static void put_func(state_writer_t *wr, size_t rec, char *name, func_t *f)
+{
+	state_func_t tmp, *r = wr->buf ? (state_func_t *)(wr->buf + rec) : &tmp;
+
+	put_string(wr, &r->name, name, _strlen(name));
+	r->len = ast_pack(f->body, NULL); // ast_pack from io_handling/script_cache.c
+	r->body = put_data(wr, NULL, r->len, 8);
+	if (wr->buf)
+		ast_pack(f->body, wr->buf + r->body);
+}
+
+/**
+ * put_state - Lays the state file out; called once to measure it and
+ * once more to fill in a buffer of that size. The records follow the
+ * header in order: environment, history, aliases, functions.
+ * @info: The parameter struct.
+ * @wr: The writer.
+ */
+static void put_state(info_t *info, state_writer_t *wr)
+{
+	state_head_t h;
+	state_str_t tmp;
+	hash_entry_t *e;
+	list_t *node;
+	size_t i, rec;
+	char *s;
+
+	_memset((char *)&h, 0, sizeof(h));
+	memcpy(h.magic, STATE_MAGIC, 4);
+	h.version = STATE_VERSION;
+	h.nenv = info->env_count;
+	h.nhist = info->hist.count;
+	h.nalias = info->aliases.count;
+	h.nfunc = info->funcs.count;
+	rec = sizeof(h);
+	wr->len = rec + sizeof(state_str_t) * (h.nenv + h.nhist)
+		+ sizeof(state_alias_t) * h.nalias + sizeof(state_func_t) * h.nfunc;
+	for (node = info->env; node; node = node->next, rec += sizeof(state_str_t))
+		put_string(wr, wr->buf ? (state_str_t *)(wr->buf + rec) : &tmp,
+			node->str, _strlen(node->str));
+	for (i = 0; i < h.nhist; i++, rec += sizeof(state_str_t))
+	{
+		s = hist_get(info, info->hist.first + i); // hist_get from history/history_manager.c
+		put_string(wr, wr->buf ? (state_str_t *)(wr->buf + rec) : &tmp, s, _strlen(s));
+	}
+	for (i = 0; i < info->aliases.size; i++)
+		for (e = info->aliases.buckets[i]; e; e = e->next, rec += sizeof(state_alias_t))
+			put_alias(wr, rec, e->key, e->value);
+	for (i = 0; i < info->funcs.size; i++)
+		for (e = info->funcs.buckets[i]; e; e = e->next, rec += sizeof(state_func_t))
+			put_func(wr, rec, e->key, e->value);
+	h.size = wr->len;
+	if (wr->buf)
+		memcpy(wr->buf, &h, sizeof(h));
+}
+
+/**
+ * state_error - Reports a state file that could not be saved or loaded.
+ * @info: The parameter struct.
+ * @file: The state file.
+ * @msg: What went wrong.
+ * Return: Always -1.
+ */
+static int state_error(info_t *info, char *file, char *msg)
+{
+	eprint_line(info->fname, ": ", file, msg, NULL); // eprint_line from error_handling/error_utilities.c
+	return (-1);
+}
+
+/**
+ * save_state - Writes the shell's environment, aliases, functions and
+ * history to a state file. The file is written under a temporary name and
+ * renamed, so a shell loading it never sees half of it.
+ * @info: The parameter struct.
+ * @file: The state file.
+ * Return: 0 on success, -1 (reported) on failure.
+ */
+int save_state(info_t *info, char *file)
+{
+	state_writer_t wr = {NULL, 0};
+	char *tmp = NULL;
+	ssize_t w = -1;
+	int fd = -1;
+
+	put_state(info, &wr);
+	if (wr.len < INT32_MAX)
+		wr.buf = calloc(1, wr.len);
+	if (wr.buf)
+		tmp = malloc(_strlen(file) + 1 + NUM_BUF_SIZE);
+	if (tmp)
+	{
+		put_state(info, &wr);
+		_strcpy(tmp, file);
+		_strcat(tmp, ".");
+		fmt_unsigned(getpid(), tmp + _strlen(tmp)); // fmt_unsigned from memory_utils/string_converters.c
+		fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	}
+	if (fd != -1)
+	{
+		w = write(fd, wr.buf, wr.len);
+		close(fd);
+		if (w != (ssize_t)wr.len || rename(tmp, file) == -1)
+		{
+			unlink(tmp);
+			w = -1;
+		}
+	}
+	free(tmp);
+	free(wr.buf);
+	return (w == -1 ? state_error(info, file, ": cannot save state") : 0);
+}
+
+/**
+ * get_str - Finds a string of a mapped state file.
+ * @map: The mapping.
+ * @size: Size of the mapping.
+ * @s: The string's record.
+ * @nul_ok: Whether the string may hold NULs (an alias's split text).
+ * Return: The string, or NULL if the record is out of bounds.
+ */
+static char *get_str(char *map, size_t size, state_str_t *s, int nul_ok)
+{
+	char *p = map + s->off;
+
+	if ((uint64_t)s->off + s->len >= size || p[s->len])
+		return (NULL);
+	if (!nul_ok && memchr(p, '\0', s->len))
+		return (NULL);
+	return (p);
+}
+
+/**
+ * load_items - Takes over the items of a mapped state file.
+ * @info: The parameter struct.
+ * @map: The mapping; its header has been checked.
+ * Return: 0 on success, 1 if the file is corrupt, -1 if memory ran out.
+ */
+static int load_items(info_t *info, char *map)
+{
+	state_head_t *h = (state_head_t *)map;
+	state_str_t *env = (state_str_t *)(h + 1), *hist = env + h->nenv;
+	state_alias_t *al = (state_alias_t *)(hist + h->nhist);
+	state_func_t *fn = (state_func_t *)(al + h->nalias);
+	word_t words[64], *w;
+	state_word_t *sw;
+	alias_t a;
+	char *s, *eq, *name;
+	uint32_t i;
+	int k, r;
+
+	for (i = 0; i < h->nenv; i++)
+	{
+		s = get_str(map, h->size, &env[i], 0);
+		eq = s ? _strchr(s, '=') : NULL;
+		if (!eq || eq == s || env_find(info, s, eq - s))
+			return (1);
+		s = _strdup(s);
+		if (!s || env_append(info, s, eq - (map + env[i].off))) // env_append from environment/env_manager.c
+			return (-1);
+	}
+	for (i = 0; i < h->nhist; i++)
+	{
+		s = get_str(map, h->size, &hist[i], 0);
+		if (!s)
+			return (1);
+		if (hist_add(info, s, hist[i].len)) // hist_add from history/history_manager.c
+			return (-1);
+	}
+	info->hist.first = 0;
+	info->hist.saved = info->hist.count; // Not from the history file: only new lines go there
+	info->hist.file_lines = 0; // Unknown; it gets compacted HIST_COMPACT lines later at worst
+	for (i = 0; i < h->nalias; i++)
+	{
+		name = get_str(map, h->size, &al[i].name, 0);
+		a.value = get_str(map, h->size, &al[i].value, 0);
+		a.text = get_str(map, h->size, &al[i].text, 1);
+		a.len = al[i].text.len + 1;
+		a.nwords = al[i].nwords;
+		a.more = al[i].more;
+		if (!name || !a.value || !a.text || al[i].value.len != al[i].text.len || a.nwords < 0
+			|| al[i].words % 8 || (uint64_t)al[i].words + sizeof(state_word_t) * a.nwords > h->size)
+			return (1);
+		w = a.nwords <= 64 ? words : malloc(sizeof(word_t) * a.nwords);
+		if (!w)
+			return (-1);
+		for (k = 0, sw = (state_word_t *)(map + al[i].words); k < a.nwords; k++)
+		{
+			if (sw[k].off >= a.len)
+				break;
+			w[k].str = a.text + sw[k].off;
+			w[k].flags = sw[k].flags;
+		}
+		a.words = w;
+		r = k < a.nwords ? 1 : alias_load(info, name, &a); // alias_load from variables/aliases.c
+		if (w != words)
+			free(w);
+		if (r)
+			return (r);
+	}
+	for (i = 0; i < h->nfunc; i++)
+	{
+		name = get_str(map, h->size, &fn[i].name, 0);
+		if (!name || fn[i].body % 8 || (uint64_t)fn[i].body + fn[i].len > h->size)
+			return (1);
+		r = load_function(info, name, map + fn[i].body, fn[i].len); // load_function from shell_core/functions.c
+		if (r)
+			return (r);
+	}
+	return (0);
+}
+
+/**
+ * load_state - Sets the shell up from a state file instead of from the
+ * process environment and the history file. The file is mapped, and the
+ * mapping is kept while functions defined from it may run.
+ * @info: The parameter struct; nothing has been loaded into it yet.
+ * @file: The state file.
+ * Return: 0 on success, -1 (reported, with nothing loaded) on failure.
+ */
+int load_state(info_t *info, char *file)
+{
+	struct stat st;
+	void *map = MAP_FAILED;
+	state_head_t *h;
+	int fd = open(file, O_RDONLY), r = 1;
+
+	if (fd == -1)
+		return (state_error(info, file, ": cannot open state file"));
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+		map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return (state_error(info, file, ": cannot open state file"));
+	h = map;
+	if ((size_t)st.st_size >= sizeof(*h) && !memcmp(h->magic, STATE_MAGIC, 4)
+		&& h->version == STATE_VERSION && h->size == (uint64_t)st.st_size
+		&& sizeof(*h) + (uint64_t)(h->nenv + (uint64_t)h->nhist) * sizeof(state_str_t)
+		+ (uint64_t)h->nalias * sizeof(state_alias_t)
+		+ (uint64_t)h->nfunc * sizeof(state_func_t) <= h->size)
+		r = load_items(info, map);
+	if (r)
+	{
+		free_env(info); // free_env from environment/env_manager.c
+		hist_free(info); // hist_free from history/history_manager.c
+		free_aliases(info); // free_aliases from variables/aliases.c
+		free_functions(info); // free_functions from shell_core/functions.c
+		munmap(map, st.st_size);
+		return (state_error(info, file, r == -1 ? ": out of memory"
+			: ": not a usable state file"));
+	}
+	if (info->funcs.count)
+	{
+		info->state_map = map;
+		info->state_len = st.st_size;
+	}
+	else
+		munmap(map, st.st_size);
+	return (0);
+}
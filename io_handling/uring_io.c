@@ -0,0 +1,431 @@
+#include "../includes/shell.h"
+
+/*
+ * Optional io_uring backend of the output buffers and the input reader,
+ * built with `make IO_URING=1`. Writes are queued on a small ring and
+ * submitted together, linked so that they complete in order, and a read
+ * of the shell's input goes in the same submission as the output flushed
+ * before it: one io_uring_enter instead of a write per file descriptor
+ * plus a read. The stdout and stderr buffers live in a region registered
+ * with the ring, so their writes use IORING_OP_WRITE_FIXED.
+ *
+ * The ring is set up on first use; when that fails (no kernel support,
+ * io_uring disabled by sysctl or seccomp) uring_ready() returns 0 and the
+ * callers use plain syscalls. A forked child drops the ring, as does a
+ * signal handler that interrupts a submission, and writes directly.
+ */
+#ifdef HSH_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <pthread.h>
+
+#define URING_ENTRIES 16
+#define URING_FIXED_FDS 3 // fds whose buffers are registered
+
+/**
+ * struct uring_op - A queued request
+ * @fd: The file descriptor.
+ * @p: The data (or the read buffer).
+ * @n: Its length.
+ * @res: The result, once completed.
+ * @read: Set for the read that ends a submission.
+ */
+typedef struct uring_op
+{
+	int fd;
+	char *p;
+	size_t n;
+	ssize_t res;
+	int read;
+} uring_op_t;
+
+/**
+ * struct uring - The ring and its queue
+ * @fd: The ring's file descriptor.
+ * @on: Set while the ring is usable.
+ * @tried: Set once setup was attempted.
+ * @busy: Set while requests are queued or in flight.
+ * @sq_head: Kernel's submission head.
+ * @sq_tail: Submission tail.
+ * @sq_mask: Submission ring mask.
+ * @sq_array: Submission index array.
+ * @cq_head: Completion head.
+ * @cq_tail: Kernel's completion tail.
+ * @cq_mask: Completion ring mask.
+ * @sqes: Submission entries.
+ * @cqes: Completion entries.
+ * @bufs: The registered output buffers, or NULL.
+ * @ops: The queued requests.
+ * @nops: Number of queued requests.
+ */
+typedef struct uring
+{
+	int fd, on, tried, busy;
+	unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+	unsigned *cq_head, *cq_tail, *cq_mask;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+	char *bufs;
+	uring_op_t ops[URING_ENTRIES];
+	int nops;
+} uring_t;
+
+static uring_t ring;
+
+/**
+ * uring_forget - Drops the ring in a forked child, which must not share
+ * it with the shell; the registered buffers remain valid memory.
+ */
+static void uring_forget(void)
+{
+	if (ring.on)
+		close(ring.fd);
+	ring.on = 0;
+	ring.busy = 0;
+	ring.nops = 0;
+}
+
+/**
+ * uring_map - Maps the rings of a new io_uring instance.
+ * @p: The parameters filled in by io_uring_setup.
+ * Return: 0 on success, -1 on failure.
+ */
+static int uring_map(struct io_uring_params *p)
+{
+	size_t sq_len = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+	size_t cq_len = p->cq_off.cqes + p->cq_entries * sizeof(struct io_uring_cqe);
+	char *sq, *cq;
+
+	if (p->features & IORING_FEAT_SINGLE_MMAP)
+		sq_len = cq_len = sq_len > cq_len ? sq_len : cq_len;
+	sq = mmap(NULL, sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		ring.fd, IORING_OFF_SQ_RING);
+	if (sq == MAP_FAILED)
+		return (-1);
+	cq = sq;
+	if (!(p->features & IORING_FEAT_SINGLE_MMAP))
+		cq = mmap(NULL, cq_len, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_CQ_RING);
+	ring.sqes = mmap(NULL, p->sq_entries * sizeof(struct io_uring_sqe),
+		PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd,
+		IORING_OFF_SQES);
+	if (cq == MAP_FAILED || ring.sqes == MAP_FAILED)
+		return (-1);
+	ring.sq_head = (unsigned *)(sq + p->sq_off.head);
+	ring.sq_tail = (unsigned *)(sq + p->sq_off.tail);
+	ring.sq_mask = (unsigned *)(sq + p->sq_off.ring_mask);
+	ring.sq_array = (unsigned *)(sq + p->sq_off.array);
+	ring.cq_head = (unsigned *)(cq + p->cq_off.head);
+	ring.cq_tail = (unsigned *)(cq + p->cq_off.tail);
+	ring.cq_mask = (unsigned *)(cq + p->cq_off.ring_mask);
+	ring.cqes = (struct io_uring_cqe *)(cq + p->cq_off.cqes);
+	return (0);
+}
+
+/**
+ * uring_probe - Checks that the kernel reads and writes at the file
+ * position (off -1) and knows every opcode the shell sends.
+ * @p: The parameters the ring was set up with.
+ * Return: 0 if it does, -1 otherwise.
+ */
+static int uring_probe(struct io_uring_params *p)
+{
+	static const int need[] = {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_WRITE_FIXED};
+	struct io_uring_probe *probe;
+	size_t size = sizeof(*probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op);
+	int i, r = 0;
+
+	if (!(p->features & IORING_FEAT_RW_CUR_POS))
+		return (-1);
+	probe = calloc(1, size);
+	if (!probe || syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_PROBE,
+		probe, IORING_OP_LAST))
+		r = -1;
+	for (i = 0; !r && i < (int)(sizeof(need) / sizeof(*need)); i++)
+		if (need[i] > probe->last_op || !(probe->ops[need[i]].flags & IO_URING_OP_SUPPORTED))
+			r = -1;
+	free(probe);
+	return (r);
+}
+
+/**
+ * uring_setup - Sets up the ring and registers the output buffers of the
+ * first URING_FIXED_FDS descriptors. Failing to register them only means
+ * they are allocated and written as usual. A kernel that lacks an opcode
+ * the shell needs gets plain syscalls instead.
+ */
+static void uring_setup(void)
+{
+	struct io_uring_params p;
+	struct iovec iov;
+	char *b;
+
+	ring.tried = 1;
+	memset(&p, 0, sizeof(p));
+	ring.fd = syscall(__NR_io_uring_setup, URING_ENTRIES, &p);
+	if (ring.fd == -1)
+		return;
+	ring.on = 1;
+	if (uring_map(&p) == -1 || uring_probe(&p) || pthread_atfork(NULL, NULL, uring_forget))
+	{
+		uring_forget(); // Plain syscalls from now on
+		return;
+	}
+	fcntl(ring.fd, F_SETFD, FD_CLOEXEC); // Not inherited by commands
+	b = mmap(NULL, URING_FIXED_FDS * OUT_BUF_SIZE, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (b == MAP_FAILED)
+		return;
+	iov.iov_base = b;
+	iov.iov_len = URING_FIXED_FDS * OUT_BUF_SIZE;
+	if (syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_BUFFERS, &iov, 1))
+		munmap(b, URING_FIXED_FDS * OUT_BUF_SIZE);
+	else
+		ring.bufs = b;
+}
+
+/**
+ * uring_ready - Tells whether writes and reads can go through the ring,
+ * setting it up on first use.
+ * Return: 1 if they can, 0 if plain syscalls must be used.
+ */
+int uring_ready(void)
+{
+	if (!ring.tried)
+		uring_setup();
+	return (ring.on && !ring.busy);
+}
+
+/**
+ * uring_buffer - Gets the registered output buffer of a file descriptor.
+ * @fd: The file descriptor.
+ * Return: OUT_BUF_SIZE bytes, or NULL if the fd has none.
+ */
+char *uring_buffer(int fd)
+{
+	if (!ring.tried)
+		uring_setup();
+	if (!ring.bufs || fd < 0 || fd >= URING_FIXED_FDS)
+		return (NULL);
+	return (ring.bufs + (size_t)fd * OUT_BUF_SIZE);
+}
+
+/**
+ * uring_wait - Submits the queued requests and waits until all of them
+ * have completed, storing each result in its op.
+ * Return: 0 on success, -1 if io_uring_enter failed.
+ */
+static int uring_wait(void)
+{
+	unsigned head, tail, todo;
+	struct io_uring_cqe *cqe;
+	int done = 0;
+
+	while (done < ring.nops)
+	{
+		todo = *ring.sq_tail - __atomic_load_n(ring.sq_head, __ATOMIC_ACQUIRE);
+		if (syscall(__NR_io_uring_enter, ring.fd, todo, ring.nops - done,
+			IORING_ENTER_GETEVENTS, NULL, 0) == -1 && errno != EINTR)
+			return (-1);
+		head = *ring.cq_head;
+		tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++, done++)
+		{
+			cqe = &ring.cqes[head & *ring.cq_mask];
+			ring.ops[cqe->user_data].res = cqe->res;
+		}
+		__atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+	}
+	return (0);
+}
+
+/**
+ * uring_push - Queues a request, linked to the one queued before it so
+ * they run in order; a failed or short request cancels the rest.
+ * @op: The request.
+ */
+static void uring_push(uring_op_t *op)
+{
+	unsigned tail = *ring.sq_tail, i = tail & *ring.sq_mask;
+	struct io_uring_sqe *sqe = &ring.sqes[i];
+	int fixed = ring.bufs && op->p >= ring.bufs
+		&& op->p < ring.bufs + URING_FIXED_FDS * OUT_BUF_SIZE;
+
+	memset(sqe, 0, sizeof(*sqe));
+	if (op->read)
+		sqe->opcode = IORING_OP_READ;
+	else
+		sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+	sqe->fd = op->fd;
+	sqe->off = (__u64)-1; // At the file position, like read/write
+	sqe->addr = (unsigned long)op->p;
+	sqe->len = op->n;
+	sqe->user_data = ring.nops;
+	if (ring.nops) // Link the previous entry to this one
+		ring.sqes[(tail - 1) & *ring.sq_mask].flags |= IOSQE_IO_LINK;
+	ring.sq_array[i] = i;
+	ring.ops[ring.nops++] = *op;
+	__atomic_store_n(ring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * uring_finish - Waits for the queued requests, then completes with plain
+ * syscalls, in order, any write that failed, was cut short or was
+ * cancelled, and the read if it was cancelled or refused by the kernel
+ * (-EINVAL, -EOPNOTSUPP). A failing write is thus
+ * reported (or raises SIGPIPE) exactly as without the ring.
+ * @read_res: Receives the result of the read, if one was queued.
+ * Return: 0 if all the writes were done, -1 otherwise.
+ */
+static int uring_finish(ssize_t *read_res)
+{
+	uring_op_t *op;
+	int i, err = 0, lost = uring_wait();
+	ssize_t w, r;
+
+	for (i = 0; i < ring.nops; i++)
+	{
+		op = &ring.ops[i];
+		if (op->read)
+		{
+			if (op->res == -ECANCELED || op->res == -EINTR
+				|| op->res == -EINVAL || op->res == -EOPNOTSUPP) // Not done, or not supported
+			{
+				r = read(op->fd, op->p, op->n);
+				op->res = r == -1 ? -errno : r;
+			}
+			*read_res = op->res;
+			continue;
+		}
+		for (w = op->res > 0 ? op->res : 0; (size_t)w < op->n; w += r)
+		{
+			r = write(op->fd, op->p + w, op->n - w);
+			if (r == -1 && errno == EINTR)
+				r = 0;
+			else if (r == -1)
+				break;
+		}
+		err |= (size_t)w < op->n;
+	}
+	ring.nops = 0;
+	ring.busy = 0;
+	if (lost)
+		uring_forget(); // The ring failed: plain syscalls from now on
+	return (-err);
+}
+
+/**
+ * uring_queue - Queues a write, first submitting what is queued if the
+ * ring is full. The data must stay unchanged until uring_submit().
+ * @fd: The file descriptor.
+ * @p: The data.
+ * @n: Its length.
+ * Return: 0 if queued, -1 if the ring is not in use.
+ */
+int uring_queue(int fd, const void *p, size_t n)
+{
+	uring_op_t op;
+	ssize_t r;
+
+	if (!ring.on)
+		return (-1);
+	ring.busy = 1;
+	if (ring.nops == URING_ENTRIES - 1) // Keep room for a read
+		uring_finish(&r);
+	ring.busy = 1;
+	op.fd = fd;
+	op.p = (char *)p;
+	op.n = n;
+	op.res = -ECANCELED; // Until it completes
+	op.read = 0;
+	uring_push(&op);
+	return (0);
+}
+
+/**
+ * uring_submit - Submits the queued writes and, after them, a read when
+ * @fd is not -1, then waits for all of them.
+ * @fd: The file descriptor to read, or -1.
+ * @buf: Where to read to.
+ * @n: How many bytes to read at most.
+ * Return: The read's result (with errno set if it failed), or 0 on success
+ * and -1 on error when only writes were submitted.
+ */
+ssize_t uring_submit(int fd, void *buf, size_t n)
+{
+	uring_op_t op;
+	ssize_t r = 0;
+	int err;
+
+	if (!ring.on)
+		return (-1);
+	ring.busy = 1;
+	if (fd != -1)
+	{
+		op.fd = fd;
+		op.p = buf;
+		op.n = n;
+		op.res = -ECANCELED;
+		op.read = 1;
+		uring_push(&op);
+	}
+	err = uring_finish(&r);
+	if (fd == -1)
+		return (err);
+	if (r < 0)
+	{
+		errno = -r;
+		return (-1);
+	}
+	return (r);
+}
+
+#else
+
+/**
+ * uring_ready - io_uring support is not built in.
+ * Return: 0, always.
+ */
+int uring_ready(void)
+{
+	return (0);
+}
+
+/**
+ * uring_buffer - io_uring support is not built in.
+ * @fd: Unused.
+ * Return: NULL, always.
+ */
+char *uring_buffer(__attribute__((unused))int fd)
+{
+	return (NULL);
+}
+
+/**
+ * uring_queue - io_uring support is not built in.
+ * @fd: Unused.
+ * @p: Unused.
+ * @n: Unused.
+ * Return: -1, always.
+ */
+int uring_queue(__attribute__((unused))int fd,
+	__attribute__((unused))const void *p, __attribute__((unused))size_t n)
+{
+	return (-1);
+}
+
+/**
+ * uring_submit - io_uring support is not built in.
+ * @fd: Unused.
+ * @buf: Unused.
+ * @n: Unused.
+ * Return: -1, always.
+ */
+ssize_t uring_submit(__attribute__((unused))int fd,
+	__attribute__((unused))void *buf, __attribute__((unused))size_t n)
+{
+	return (-1);
+}
+
+#endif
@@ -0,0 +1,164 @@
+#include "../includes/shell.h"
+
+/**
+ * hash_string - Hashes a string (FNV-1a).
+ * @s: The string.
+ * Return: The hash value.
+ */
+unsigned long hash_string(const char *s)
+{
+	unsigned long h = 14695981039346656037UL;
+
+	while (*s)
+	{
+		h ^= (unsigned char)*s++;
+		h *= 1099511628211UL;
+	}
+	return (h);
+}
+
+/**
+ * hash_find - Looks up a key.
+ * @t: The table.
+ * @key: The key.
+ * Return: The entry, or NULL if the key is not in the table.
+ */
+hash_entry_t *hash_find(hash_table_t *t, const char *key)
+{
+	return (hash_find_len(t, key, _strlen((char *)key)));
+}
+
+/**
+ * hash_find_len - Looks up a key that need not be NUL-terminated,
+ * such as a name inside a word being expanded.
+ * @t: The table.
+ * @key: The key.
+ * @len: Length of the key.
+ * Return: The entry, or NULL if the key is not in the table.
+ */
+hash_entry_t *hash_find_len(hash_table_t *t, const char *key, size_t len)
+{
+	unsigned long h = 14695981039346656037UL; // FNV-1a, as in hash_string()
+	hash_entry_t *e;
+	size_t i;
+
+	if (!t->count)
+		return (NULL);
+	for (i = 0; i < len; i++)
+	{
+		h ^= (unsigned char)key[i];
+		h *= 1099511628211UL;
+	}
+	for (e = t->buckets[h & (t->size - 1)]; e; e = e->next)
+		if (!strncmp(e->key, key, len) && !e->key[len])
+			return (e);
+	return (NULL);
+}
+
+/**
+ * hash_grow - Doubles the number of buckets and rehashes every entry.
+ * @t: The table.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int hash_grow(hash_table_t *t)
+{
+	size_t size = t->size ? t->size * 2 : HASH_MIN_SIZE, i, b;
+	hash_entry_t **buckets = malloc(sizeof(hash_entry_t *) * size), *e, *next;
+
+	if (!buckets)
+		return (-1);
+	for (i = 0; i < size; i++)
+		buckets[i] = NULL;
+	for (i = 0; i < t->size; i++)
+		for (e = t->buckets[i]; e; e = next)
+		{
+			next = e->next;
+			b = hash_string(e->key) & (size - 1);
+			e->next = buckets[b];
+			buckets[b] = e;
+		}
+	free(t->buckets);
+	t->buckets = buckets;
+	t->size = size;
+	return (0);
+}
+
+/**
+ * hash_insert - Finds the entry for a key, adding it if it is missing.
+ * The key is copied into the same allocation as the entry.
+ * @t: The table.
+ * @key: The key.
+ * Return: The entry (value is NULL for a new entry), or NULL on failure.
+ */
+hash_entry_t *hash_insert(hash_table_t *t, const char *key)
+{
+	hash_entry_t *e = hash_find(t, key);
+	size_t len, b;
+
+	if (e)
+		return (e);
+	if (t->count + 1 > t->size - t->size / 4 && hash_grow(t)) // Keep load under 3/4
+		return (NULL);
+	len = _strlen((char *)key);
+	e = malloc(sizeof(hash_entry_t) + len + 1);
+	if (!e)
+		return (NULL);
+	e->key = (char *)(e + 1);
+	memcpy(e->key, key, len + 1);
+	e->value = NULL;
+	b = hash_string(key) & (t->size - 1);
+	e->next = t->buckets[b];
+	t->buckets[b] = e;
+	t->count++;
+	return (e);
+}
+
+/**
+ * hash_remove - Removes a key from the table.
+ * @t: The table.
+ * @key: The key.
+ * @free_value: Called on the entry's value, or NULL.
+ * Return: 1 if the key was removed, 0 if it was not in the table.
+ */
+int hash_remove(hash_table_t *t, const char *key, void (*free_value)(void *))
+{
+	hash_entry_t **p, *e;
+
+	if (!t->count)
+		return (0);
+	for (p = &t->buckets[hash_string(key) & (t->size - 1)]; *p; p = &(*p)->next)
+		if (!strcmp((*p)->key, key))
+		{
+			e = *p;
+			*p = e->next;
+			if (free_value)
+				free_value(e->value);
+			free(e);
+			t->count--;
+			return (1);
+		}
+	return (0);
+}
+
+/**
+ * hash_free - Frees every entry and the bucket array.
+ * @t: The table.
+ * @free_value: Called on each entry's value, or NULL.
+ */
+void hash_free(hash_table_t *t, void (*free_value)(void *))
+{
+	hash_entry_t *e, *next;
+	size_t i;
+
+	for (i = 0; i < t->size; i++)
+		for (e = t->buckets[i]; e; e = next)
+		{
+			next = e->next;
+			if (free_value)
+				free_value(e->value);
+			free(e);
+		}
+	free(t->buckets);
+	t->buckets = NULL;
+	t->size = t->count = 0;
+}
@@ -61,13 +61,15 @@ char **list_to_strings(list_t *head)
  */
 size_t print_list(const list_t *h)
 {
-	size_t i = 0;
+	size_t i = 0, n;
+	char num[NUM_BUF_SIZE + 2];
 
 	while (h)
 	{
-		_puts(convert_number(h->num, 10, 0)); // convert_number in memory_utils/string_converters.c
-		_putchar(':');                        // _putchar in string_operations/string_manipulation2.c
-		_putchar(' ');
+		n = fmt_unsigned(h->num, num); // fmt_unsigned in memory_utils/string_converters.c
+		num[n++] = ':';
+		num[n++] = ' ';
+		out_write(STDOUT_FILENO, num, n); // out_write in io_handling/output_buffer.c
 		_puts(h->str ? h->str : "(nil)"); // _puts in string_operations/string_manipulation2.c
 		_puts("\n");
 		h = h->next;
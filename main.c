@@ -1,9 +1,103 @@
 #include "includes/shell.h"
 
+/**
+ * usage_error - Reports a bad command line and exits with status 2.
+ * @av0: The program name.
+ * @opt: The option at fault.
+ * @msg: What is wrong with it.
+ */
+static void usage_error(char *av0, char *opt, char *msg)
+{
+	eprint_line(av0, ": 0: ", msg, opt, NULL); // eprint_line from error_handling/error_utilities.c
+	exit(2);
+}
+
+/**
+ * parse_options - Reads the options that come before the operands:
+ * -c (run a command string), -s (read commands from stdin),
+ * --load-state FILE, --save-state FILE and -- (end of options).
+ * @info: The parameter struct; -s sets batch, --save-state state_file.
+ * @av: Argument vector.
+ * @state: Receives the file of --load-state.
+ * @cmd: Set if -c was given.
+ * Return: The index of the first operand.
+ */
+static int parse_options(info_t *info, char **av, char **state, int *cmd)
+{
+	int i;
+
+	for (i = 1; av[i] && av[i][0] == '-' && av[i][1]; i++)
+	{
+		if (!_strcmp(av[i], "--"))
+			return (i + 1);
+		if (!_strcmp(av[i], "-c"))
+			*cmd = 1;
+		else if (!_strcmp(av[i], "-s"))
+			info->batch = 1;
+		else if (!_strcmp(av[i], "--load-state") || !_strcmp(av[i], "--save-state"))
+		{
+			if (!av[i + 1])
+				usage_error(av[0], av[i], "option requires an argument: ");
+			if (av[i][2] == 'l')
+				*state = av[i + 1];
+			else
+				info->state_file = av[i + 1];
+			i++;
+		}
+		else
+			usage_error(av[0], av[i], "Illegal option ");
+	}
+	return (i);
+}
+
+/**
+ * set_params - Sets the positional parameters the shell starts with.
+ * @info: The parameter struct.
+ * @v: The arguments.
+ * @n: Their number.
+ */
+static void set_params(info_t *info, char **v, int n)
+{
+	if (n <= 0)
+		return;
+	info->params = dup_vector(v, n); // dup_vector from shell_core/shell_utilities.c
+	info->nparams = info->params ? n : 0;
+}
+
+/**
+ * open_script - Opens the script named on the command line, exiting the
+ * way sh does when it cannot be opened.
+ * @av0: The program name.
+ * @path: The script.
+ * Return: The file descriptor.
+ */
+static int open_script(char *av0, char *path)
+{
+	int fd = open(path, O_RDONLY); // Try to open the script file for reading
+
+	if (fd != -1)
+		return (fd);
+	if (errno == EACCES) // Permission denied
+		exit(126);
+	if (errno == ENOENT) // File not found
+	{
+		eprint_line(av0, ": 0: Can't open ", path, NULL);
+		exit(127);
+	}
+	exit(EXIT_FAILURE); // Other file open errors
+}
+
 /**
  * main - Entry point for the simple shell.
  * Initializes shell information, handles script file input,
- * and enters the main shell loop.
+ * and enters the main shell loop. The shell runs one of:
+ *   hsh [options] [-s] [arg...]         commands from stdin
+ *   hsh [options] script [arg...]       a script, with $1... set to the args
+ *   hsh [options] -c cmd [arg0 [arg...]] a command string, $0 set to arg0
+ * --load-state FILE sets the shell up from a state file instead of the
+ * environment and history file; --save-state FILE writes one on exit.
+ * Only a shell reading stdin without -s may be interactive; the others
+ * show no prompt and keep no history.
  * @ac: Argument count.
  * @av: Argument vector (array of strings).
  * Return: 0 on success, 1 on error (or exit code from hsh).
@@ -11,30 +105,45 @@
 int main(int ac, char **av)
 {
 	info_t info[] = { INFO_INIT }; // Initialize info_t struct
-	int fd = 2; // Default file descriptor for error output (stderr)
+	int fd = 2, i, cmd = 0; // Default file descriptor for error output (stderr)
+	char *state = NULL; // State file to load
+	struct stat st;
 
-	if (ac == 2) // If a script file is provided as an argument
+	info->fname = av[0]; // Needed by error messages raised before the first command
+	info->pid = getpid(); // $$ stays the shell's PID, even in subshells
+	i = parse_options(info, av, &state, &cmd);
+	if (cmd)
 	{
-		fd = open(av[1], O_RDONLY); // Try to open the script file for reading
-		if (fd == -1) // File opening failed
-		{
-			if (errno == EACCES) // Permission denied
-				exit(126);
-			if (errno == ENOENT) // File not found
-			{
-				_eputs(av[0]); // _eputs from error_handling/error_reporter.c
-				_eputs(": 0: Can't open ");
-				_eputs(av[1]);
-				_eputchar('\n'); // _eputchar from error_handling/error_reporter.c
-				_eputchar(BUF_FLUSH);
-				exit(127);
-			}
-			return (EXIT_FAILURE); // Other file open errors
-		}
+		if (i == ac)
+			usage_error(av[0], "", "-c requires an argument");
+		if (i + 1 < ac)
+			info->fname = av[i + 1]; // $0, also used in error messages
+		set_params(info, av + i + 2, ac - i - 2);
+		info->batch = 1;
+	}
+	else if (!info->batch && i < ac) // If a script file is provided as an argument
+	{
+		fd = open_script(av[0], av[i]);
 		info->readfd = fd; // Set shell's input file descriptor to the script file
+		set_params(info, av + i + 1, ac - i - 1);
+		info->batch = 1;
+	}
+	else
+		set_params(info, av + i, ac - i);
+	if (!state || load_state(info, state)) // load_state from io_handling/state_snapshot.c
+	{
+		populate_env_list(info); // Populate environment linked list (from environment/env_manager.c)
+		if (!info->batch)
+			read_history(info); // Read command history (from history/history_manager.c)
+	}
+	if (cmd)
+	{
+		run_string(info, av[i]); // run_string from shell_core/script_loader.c
+		exit_shell(info); // exit_shell from shell_core/shell_loop.c
+		return (EXIT_SUCCESS);
 	}
-	populate_env_list(info); // Populate environment linked list (from environment/env_manager.c)
-	read_history(info);      // Read command history (from history/history_manager.c)
+	if (fd > 2 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+		run_script(info, av[i], fd); // Compile the whole file at once (from shell_core/script_loader.c)
 	hsh(info, av);           // Start the main shell loop (from shell_core/shell_loop.c)
 
 	return (EXIT_SUCCESS); // Shell exits normally
@@ -0,0 +1,80 @@
+#include "../includes/shell.h"
+
+/**
+ * arena_alloc - Allocates memory from an arena by bumping a pointer.
+ * A new chunk is chained in only when the current one is full, so
+ * memory handed out never moves and is released all at once.
+ * @a: The arena.
+ * @size: Number of bytes wanted.
+ * Return: Pointer to the memory (aligned for any pointer type), or NULL.
+ */
+void *arena_alloc(arena_t *a, size_t size)
+{
+	arena_chunk_t *c = a->head;
+	size_t want;
+
+	size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1); // Keep pointer alignment
+	if (!c || c->used + size > c->size)
+	{
+		want = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+		c = malloc(sizeof(arena_chunk_t) + want);
+		if (!c)
+			return (NULL);
+		c->size = want;
+		c->used = 0;
+		c->next = a->head;
+		a->head = c;
+	}
+	c->used += size;
+	return (c->data + c->used - size);
+}
+
+/**
+ * arena_strndup - Copies n bytes of a string into an arena and NUL-terminates it.
+ * @a: The arena.
+ * @s: The string to copy (may be NULL if n is 0).
+ * @n: Number of bytes to copy.
+ * Return: The copy, or NULL on failure.
+ */
+char *arena_strndup(arena_t *a, const char *s, size_t n)
+{
+	char *p = arena_alloc(a, n + 1);
+
+	if (!p)
+		return (NULL);
+	if (n) // s may be NULL when there is nothing to copy
+		memcpy(p, s, n);
+	p[n] = '\0';
+	return (p);
+}
+
+/**
+ * arena_reset - Releases everything allocated from an arena, keeping the
+ * most recent chunk for reuse so steady-state use does not call malloc.
+ * @a: The arena.
+ */
+void arena_reset(arena_t *a)
+{
+	arena_chunk_t *c, *next;
+
+	if (!a->head)
+		return;
+	for (c = a->head->next; c; c = next)
+	{
+		next = c->next;
+		free(c);
+	}
+	a->head->next = NULL;
+	a->head->used = 0;
+}
+
+/**
+ * arena_free - Frees every chunk of an arena.
+ * @a: The arena.
+ */
+void arena_free(arena_t *a)
+{
+	arena_reset(a);
+	free(a->head);
+	a->head = NULL;
+}
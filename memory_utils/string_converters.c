@@ -1,39 +1,109 @@
 #include "../includes/shell.h"
 
+/*
+ * Integer formatting. Every function writes the digits and a NUL into a
+ * buffer supplied by the caller (NUM_BUF_SIZE bytes are always enough)
+ * and returns the length, so callers can use the result in place, without a
+ * copy, and several numbers can be formatted at once. Decimal numbers are
+ * produced two digits per division from a table of the pairs 00..99.
+ */
+static const char digit_pairs[201] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/**
+ * dec_len - Counts the decimal digits of a number.
+ * @n: The number.
+ * Return: The number of digits (1 for 0).
+ */
+static size_t dec_len(unsigned long n)
+{
+	size_t len = 1;
+
+	while (1)
+	{
+		if (n < 10)
+			return (len);
+		if (n < 100)
+			return (len + 1);
+		if (n < 1000)
+			return (len + 2);
+		if (n < 10000)
+			return (len + 3);
+		n /= 10000;
+		len += 4;
+	}
+}
+
+/**
+ * fmt_unsigned - Formats an unsigned number in decimal.
+ * @n: The number.
+ * @buf: The buffer (NUM_BUF_SIZE bytes always suffice).
+ * Return: The length of the string written.
+ */
+size_t fmt_unsigned(unsigned long n, char *buf)
+{
+	size_t len = dec_len(n);
+	char *p = buf + len;
+	unsigned int i;
+
+	*p = '\0';
+	while (n >= 100)
+	{
+		i = (n % 100) * 2;
+		n /= 100;
+		*--p = digit_pairs[i + 1];
+		*--p = digit_pairs[i];
+	}
+	if (n >= 10)
+	{
+		*--p = digit_pairs[n * 2 + 1];
+		*--p = digit_pairs[n * 2];
+	}
+	else
+		*--p = '0' + n;
+	return (len);
+}
+
+/**
+ * fmt_signed - Formats a signed number in decimal.
+ * @n: The number.
+ * @buf: The buffer (NUM_BUF_SIZE bytes always suffice).
+ * Return: The length of the string written.
+ */
+size_t fmt_signed(long n, char *buf)
+{
+	if (n >= 0)
+		return (fmt_unsigned(n, buf));
+	*buf = '-';
+	return (1 + fmt_unsigned(0UL - (unsigned long)n, buf + 1)); // Safe for LONG_MIN
+}
+
 /**
- * convert_number - Converter function, a clone of itoa (integer to ASCII).
- * Converts a long integer to a string representation in a specified base.
- * @num: The number to convert.
- * @base: The base for conversion (e.g., 10 for decimal, 16 for hexadecimal).
- * @flags: Argument flags that modify conversion behavior:
- * CONVERT_UNSIGNED (for unsigned numbers),
- * CONVERT_LOWERCASE (for lowercase hex characters).
- * Return: A pointer to the static buffer containing the string representation.
+ * fmt_hex - Formats an unsigned number in lowercase hexadecimal.
+ * @n: The number.
+ * @buf: The buffer (NUM_BUF_SIZE bytes always suffice).
+ * @width: The minimum number of digits, padded with zeros (at most 16).
+ * Return: The length of the string written.
  */
-char *convert_number(long int num, int base, int flags)
+size_t fmt_hex(unsigned long n, char *buf, int width)
 {
-	static char *array;
-	static char buffer[50]; // Static buffer to hold the converted string
-	char sign = 0;
-	char *ptr;
-	unsigned long n = num; // Use unsigned long for conversion logic
+	size_t len = 1;
+	char *p;
 
-	if (!(flags & CONVERT_UNSIGNED) && num < 0)
+	while (len < sizeof(n) * 2 && n >> (len * 4))
+		len++;
+	if (len < (size_t)width)
+		len = width;
+	p = buf + len;
+	*p = '\0';
+	while (p > buf)
 	{
-		n = -num;
-		sign = '-'; // Set sign for negative numbers
+		*--p = "0123456789abcdef"[n & 0xf];
+		n >>= 4;
 	}
-	// Determine the character set based on CONVERT_LOWERCASE flag
-	array = flags & CONVERT_LOWERCASE ? "0123456789abcdef" : "0123456789ABCDEF";
-	ptr = &buffer[49]; // Start pointer from end of buffer (for null terminator)
-	*ptr = '\0'; // Null-terminate the string
-
-	do {
-		*--ptr = array[n % base]; // Convert digit and move pointer left
-		n /= base; // Divide number by base
-	} while (n != 0); // Continue until number becomes 0
-
-	if (sign) // If negative, add the sign
-		*--ptr = sign;
-	return (ptr); // Return pointer to the start of the converted string
+	return (len);
 }
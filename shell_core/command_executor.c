@@ -1,5 +1,163 @@
 #include "../includes/shell.h"
 
+/**
+ * eval_node - Evaluates a command AST node.
+ * @info: The parameter & return info struct.
+ * @node: The node to evaluate (NULL is an empty command).
+ * Return: The exit status of the node, also left in info->status.
+ */
+int eval_node(info_t *info, node_t *node)
+{
+	if (!node || info->ctl != CTL_NONE)
+		return (info->status);
+	info->line_count = node->line; // Errors report the line the command is on
+	switch (node->type)
+	{
+	case NODE_CMD:
+		return (run_command(info, node));
+	case NODE_SEQ:
+		return (eval_list(info, node)); // eval_list from variables/command_chaining.c
+	case NODE_AND:
+	case NODE_OR:
+		return (eval_and_or(info, node)); // eval_and_or from variables/command_chaining.c
+	case NODE_NOT:
+		eval_node(info, node->kid[0]);
+		info->status = !info->status;
+		return (info->status);
+	case NODE_PIPE:
+		return (eval_pipeline(info, node)); // eval_pipeline from io_handling/pipe_handler.c
+	case NODE_BG:
+		return (eval_background(info, node)); // eval_background from variables/command_chaining.c
+	case NODE_SUBSHELL:
+		return (eval_subshell(info, node)); // eval_subshell from io_handling/pipe_handler.c
+	case NODE_GROUP:
+		return (eval_node(info, node->kid[0]));
+	case NODE_IF:
+		return (eval_if(info, node)); // eval_if from shell_core/control_flow.c
+	case NODE_WHILE:
+	case NODE_UNTIL:
+		return (eval_loop(info, node));
+	case NODE_FOR:
+		return (eval_for(info, node));
+	case NODE_ARITH_FOR:
+		return (eval_arith_for(info, node));
+	case NODE_CASE:
+		return (eval_case(info, node));
+	case NODE_ARITH:
+		return (eval_arith(info, node));
+	case NODE_FUNCDEF:
+		return (define_function(info, node)); // define_function from shell_core/functions.c
+	}
+	return (info->status);
+}
+
+/**
+ * run_internal - Runs a shell function or a built-in.
+ * @info: The parameter & return info struct.
+ * @f: The function, or NULL to run @b.
+ * @b: The built-in.
+ */
+static void run_internal(info_t *info, func_t *f, builtin_table *b)
+{
+	int ret;
+
+	if (f)
+	{
+		call_function(info, f); // call_function from shell_core/functions.c
+		return;
+	}
+	ret = b->func(info);
+	if (ret == -2) // The built-in asked the shell to exit
+		info->ctl = CTL_EXIT;
+	else
+		info->status = ret;
+}
+
+/**
+ * free_parts - Frees the expanded arguments of a declaration command.
+ * @parts: The list from set_decl(), or NULL.
+ */
+static void free_parts(char ***parts)
+{
+	int i;
+
+	for (i = 0; parts && parts[i]; i++)
+		free(parts[i]);
+	free(parts);
+}
+
+/**
+ * run_command - Runs a simple command: expands its words, then runs it as
+ * a shell function, a built-in, or finds and executes it from PATH.
+ * Leading NAME=value words are assignments: on their own they set shell
+ * variables (and arrays); before a command they only apply to that command.
+ * Arrays name=(...) after the name can only be arguments of a declaration
+ * command (the parser checks), which are expanded by set_decl().
+ * @info: The parameter & return info struct.
+ * @node: A NODE_CMD node.
+ * Return: The command's exit status.
+ */
+int run_command(info_t *info, node_t *node)
+{
+	int direct = info->forked, n, k;
+	char **assigns = NULL, ***parts = NULL;
+	list_t *saved = NULL;
+	builtin_table *b;
+	func_t *f;
+
+	info->forked = 0; // Only this command may replace the process
+	for (n = 0; n < node->nwords && (node->words[n].flags & (TOKF_ASSIGN | TOKF_ELEM)); n++)
+		;
+	if (n == node->nwords)
+	{
+		if (n)
+			info->status = assign_words(info, node->words, n); // assign_words from variables/shell_variables.c
+		return (info->status);
+	}
+	if (n && !(assigns = expand_words(info, node->words, n))) // Sets status on failure
+		return (info->status);
+	for (k = n; k < node->nwords && !(node->words[k].flags & TOKF_ARRAY); k++)
+		;
+	if (k < node->nwords)
+		parts = set_decl(info, node->words + n, node->nwords - n); // set_decl from shell_core/shell_utilities.c
+	else
+		set_info(info, node->words + n, node->nwords - n); // set_info from shell_core/shell_utilities.c
+	if (!info->argv || !info->argv[0]) // Failed, or "$@" expanded to nothing
+	{
+		if (info->argv)
+			info->status = 0;
+		free_info(info, 0);
+		free(assigns);
+		free_parts(parts);
+		return (info->status);
+	}
+	f = find_function(info, info->argv[0]); // Functions come before built-ins and PATH
+	b = f ? NULL : find_builtin(info->argv[0]); // find_builtin from builtins/builtin_manager.c
+	if (f || b)
+	{
+		n = assigns ? var_assign(info, assigns, &saved) : 0;
+		if (n)
+			info->status = n;
+		else
+			run_internal(info, f, b);
+		var_restore(info, &saved); // var_restore from variables/shell_variables.c
+	}
+	else
+	{
+		info->assigns = assigns;
+		find_cmd(info); // Find the path for the command (updates info->path)
+		if (info->path && direct) // Already in a child: no need to fork again
+			exec_cmd(info);
+		else if (info->path)
+			fork_cmd(info);
+		info->assigns = NULL;
+	}
+	free(assigns);
+	free_parts(parts);
+	free_info(info, 0); // Free command-specific info fields (from shell_core/shell_utilities.c)
+	return (info->status);
+}
+
 /**
  * fork_cmd - Forks a child process to run an external command using execve.
  * @info: The parameter & return info struct.
@@ -9,6 +167,7 @@ void fork_cmd(info_t *info)
 {
 	pid_t child_pid;
 
+	flush_output(); // The child must not inherit unflushed output
 	child_pid = fork();
 	if (child_pid == -1)
 	{
@@ -17,27 +176,66 @@ void fork_cmd(info_t *info)
 		return;
 	}
 	if (child_pid == 0) // Child process
+		exec_cmd(info);
+	wait_child(info, child_pid); // Parent process
+	if (info->status == 126) // Handle permission denied specifically
+		print_error(info, "Permission denied\n"); // print_error from error_handling/error_reporter.c
+}
+
+/**
+ * exec_cmd - Replaces the current (child) process with info->path.
+ * @info: The parameter & return info struct.
+ * Return: Never returns.
+ */
+void exec_cmd(info_t *info)
+{
+	char **a, *eq;
+
+	for (a = info->assigns; a && *a; a++) // NAME=value before the command
 	{
-		// Execute the command
-		// get_environ from environment/env_manager.c
-		if (execve(info->path, info->argv, get_environ(info)) == -1)
-		{
-			// If execve fails, free resources and exit child process
-			free_info(info, 1); // free_info from shell_core/shell_utilities.c
-			if (errno == EACCES) // Permission denied
-				exit(126);
-			exit(1); // General execution error
-		}
-		// This part should ideally not be reached if execve is successful
-	}
-	else // Parent process
-	{
-		wait(&(info->status)); // Wait for child process to complete
-		if (WIFEXITED(info->status)) // Check if child exited normally
-		{
-			info->status = WEXITSTATUS(info->status); // Get child's exit status
-			if (info->status == 126) // Handle permission denied specifically
-				print_error(info, "Permission denied\n"); // print_error from error_handling/error_reporter.c
-		}
+		eq = _strchr(*a, '=');
+		*eq = '\0';
+		if (valid_name(*a)) // Not NAME+= or NAME[i]=
+			_setenv(info, *a, eq + 1); // Only this process's copy changes
 	}
+	// get_environ from environment/env_manager.c
+	execve(info->path, info->argv, get_environ(info));
+	// If execve fails, free resources and exit child process
+	free_info(info, 1); // free_info from shell_core/shell_utilities.c
+	if (errno == EACCES) // Permission denied
+		exit(126);
+	exit(1); // General execution error
+}
+
+/**
+ * wait_child - Waits for a child process and records its exit status.
+ * @info: The parameter & return info struct.
+ * @pid: The child to wait for.
+ * Return: The child's exit status (128 + signal number if it was killed).
+ */
+int wait_child(info_t *info, pid_t pid)
+{
+	int wstatus;
+
+	if (waitpid(pid, &wstatus, 0) == -1)
+		return (info->status);
+	if (WIFEXITED(wstatus)) // Check if child exited normally
+		info->status = WEXITSTATUS(wstatus); // Get child's exit status
+	else if (WIFSIGNALED(wstatus))
+		info->status = 128 + WTERMSIG(wstatus);
+	return (info->status);
+}
+
+/**
+ * child_exit - Ends a forked child of the shell (pipeline stage, subshell
+ * or background job) once it has evaluated its commands.
+ * @info: The parameter & return info struct.
+ * Return: Never returns.
+ */
+void child_exit(info_t *info)
+{
+	flush_output();
+	if (info->ctl == CTL_EXIT && info->err_num != -1)
+		exit(info->err_num);
+	exit(info->status);
 }
@@ -0,0 +1,727 @@
+#include "../includes/shell.h"
+
+static node_t *parse_list(info_t *info);
+static node_t *parse_compound(info_t *info);
+
+/**
+ * peek - Returns the token the parser is looking at.
+ * @info: The parameter struct holding the token vector.
+ * Return: The current token, or NULL at the end of the input read so far.
+ */
+static token_t *peek(info_t *info)
+{
+	if (info->tok_pos >= info->tok_count)
+		return (NULL);
+	return (&info->tokens[info->tok_pos]);
+}
+
+/**
+ * keyword - Identifies the reserved word a token spells, if any.
+ * Reserved words are only recognized where a command may start.
+ * @tok: The token (may be NULL).
+ * Return: The KW_* code, or 0 if tok is not an unquoted reserved word.
+ */
+static int keyword(token_t *tok)
+{
+	if (!tok || tok->type != TOK_WORD || tok->flags)
+		return (0);
+	return (reserved_word(tok->str)); // reserved_word from builtins/builtin_manager.c
+}
+
+/**
+ * is_word - Checks whether a token is the unquoted reserved word kw.
+ * @tok: The token (may be NULL).
+ * @kw: The KW_* code of the reserved word.
+ * Return: 1 if it matches, 0 otherwise.
+ */
+static int is_word(token_t *tok, int kw)
+{
+	return (keyword(tok) == kw);
+}
+
+/**
+ * ends_list - Checks whether a token terminates a command list.
+ * @tok: The token (may be NULL).
+ * Return: 1 if a list cannot continue past tok, 0 otherwise.
+ */
+static int ends_list(token_t *tok)
+{
+	int kw;
+
+	if (!tok || tok->type == TOK_RPAREN || tok->type == TOK_DSEMI)
+		return (1);
+	kw = keyword(tok);
+	return (kw && kw <= KW_ESAC); // }, then, elif, else, fi, do, done, esac
+}
+
+/**
+ * fail - Records a parse failure. Running out of tokens means the command
+ * continues on the next line; anything else is a syntax error.
+ * @info: The parameter struct.
+ * Return: Always NULL, for use in tail position.
+ */
+static node_t *fail(info_t *info)
+{
+	token_t *tok = peek(info);
+	unsigned int line;
+
+	if (info->parse_err != PARSE_OK)
+		return (NULL);
+	if (!tok)
+	{
+		info->parse_err = PARSE_INCOMPLETE;
+		return (NULL);
+	}
+	info->parse_err = PARSE_ERROR;
+	line = info->line_count;
+	info->line_count = tok->line; // Report the line the token is on
+	syntax_error(info, tok->type == TOK_WORD ? tok->str : tok_name(tok->type),
+		"unexpected");
+	info->line_count = line;
+	return (NULL);
+}
+
+/**
+ * parse_arith - Compiles the text of an arithmetic token.
+ * @info: The parameter struct.
+ * @tok: The token, for the line number of any error.
+ * @expr: The expression (tok's text or part of it).
+ * Return: The expression, or NULL if it is empty or invalid (parse_err set).
+ */
+static arith_t *parse_arith(info_t *info, token_t *tok, char *expr)
+{
+	unsigned int line = info->line_count;
+	arith_t *e;
+
+	info->line_count = tok->line;
+	e = arith_parse(info, expr); // arith_parse from variables/arithmetic.c
+	info->line_count = line;
+	return (e);
+}
+
+/**
+ * new_node - Allocates a zeroed AST node from the parse arena.
+ * @info: The parameter struct.
+ * @type: The NODE_* type.
+ * @a: First child.
+ * @b: Second child.
+ * Return: The node, or NULL on allocation failure.
+ */
+static node_t *new_node(info_t *info, int type, node_t *a, node_t *b)
+{
+	node_t *n = arena_alloc(&info->parse, sizeof(node_t));
+
+	if (!n)
+	{
+		info->parse_err = PARSE_ERROR;
+		return (NULL);
+	}
+	_memset((char *)n, 0, sizeof(node_t));
+	n->type = type;
+	if (peek(info))
+		n->line = peek(info)->line;
+	else
+		n->line = info->tok_count ? info->tokens[info->tok_count - 1].line : info->line_count;
+	n->kid[0] = a;
+	n->kid[1] = b;
+	return (n);
+}
+
+/**
+ * skip_newlines - Consumes any newline tokens (the grammar's linebreak).
+ * @info: The parameter struct.
+ */
+static void skip_newlines(info_t *info)
+{
+	while (peek(info) && peek(info)->type == TOK_NEWLINE)
+		info->tok_pos++;
+}
+
+/**
+ * expect - Consumes the reserved word or operator that must come next.
+ * @info: The parameter struct.
+ * @type: Token type wanted.
+ * @kw: KW_* code of the reserved word wanted when type is TOK_WORD.
+ * Return: 1 if it was there, 0 after recording a parse failure.
+ */
+static int expect(info_t *info, int type, int kw)
+{
+	token_t *tok = peek(info);
+
+	if (tok && tok->type == type && (type != TOK_WORD || is_word(tok, kw)))
+	{
+		info->tok_pos++;
+		return (1);
+	}
+	fail(info);
+	return (0);
+}
+
+/**
+ * copy_words - Copies the words of tokens [start, start + n) into the arena.
+ * The words keep pointing into the input line held in the parse arena.
+ * @info: The parameter struct.
+ * @start: Index of the first token.
+ * @n: Number of word tokens.
+ * @stride: Distance between consecutive words (2 skips '|' in case patterns).
+ * Return: The word array, or NULL on allocation failure.
+ */
+static word_t *copy_words(info_t *info, size_t start, int n, int stride)
+{
+	word_t *w = arena_alloc(&info->parse, sizeof(word_t) * (n ? n : 1));
+	int i;
+
+	if (!w)
+	{
+		info->parse_err = PARSE_ERROR;
+		return (NULL);
+	}
+	for (i = 0; i < n; i++, start += stride)
+	{
+		w[i].str = info->tokens[start].str;
+		w[i].flags = info->tokens[start].flags;
+	}
+	return (w);
+}
+
+/**
+ * array_elements - Consumes the elements of a NAME=( array assignment,
+ * which may span lines, up to the closing ')'. They are flagged TOKF_ELEM.
+ * @info: The parameter struct.
+ * Return: 1 on success, 0 after recording a parse failure.
+ */
+static int array_elements(info_t *info)
+{
+	token_t *tok;
+
+	while (skip_newlines(info), (tok = peek(info)) && tok->type == TOK_WORD)
+	{
+		tok->flags |= TOKF_ELEM;
+		info->tok_pos++;
+	}
+	return (expect(info, TOK_RPAREN, 0));
+}
+
+/**
+ * word_list - Parses a possibly empty run of words into a NODE_CMD node.
+ * Array assignments may only come before the command name, and only
+ * when there is no command name at all, or be arguments of a declaration
+ * command (declare, typeset, local, export, readonly).
+ * @info: The parameter struct.
+ * Return: The node, or NULL on failure.
+ */
+static node_t *word_list(info_t *info)
+{
+	size_t start = info->tok_pos;
+	int cmd = 0, decl = 0, arrays = 0, i, k;
+	token_t *tok;
+	node_t *n;
+
+	while ((tok = peek(info)) && tok->type == TOK_WORD)
+	{
+		if ((tok->flags & TOKF_ARRAY) ? cmd && !decl
+			: arrays && !cmd && !(tok->flags & TOKF_ASSIGN))
+			return (fail(info));
+		if (!cmd && !(tok->flags & TOKF_ASSIGN))
+			decl = decl_builtin(tok->str); // decl_builtin from builtins/builtin_manager.c
+		cmd |= !(tok->flags & TOKF_ASSIGN);
+		info->tok_pos++;
+		if ((tok->flags & TOKF_ARRAY) && (++arrays, !array_elements(info)))
+			return (NULL);
+	}
+	n = new_node(info, NODE_CMD, NULL, NULL);
+	if (!n)
+		return (NULL);
+	n->nwords = info->tok_pos - start;
+	if (n->nwords)
+		n->line = info->tokens[start].line;
+	n->words = copy_words(info, start, n->nwords, 1);
+	if (!n->words || !arrays)
+		return (n->words ? n : NULL);
+	for (i = k = 0; i < n->nwords; i++) // Drop the ')' and newlines
+		if (info->tokens[start + i].type == TOK_WORD)
+			n->words[k++] = n->words[i];
+	n->nwords = k;
+	return (n);
+}
+
+/**
+ * parse_simple - Parses a simple command: a run of words.
+ * @info: The parameter struct.
+ * Return: A NODE_CMD node, or NULL on failure.
+ */
+static node_t *parse_simple(info_t *info)
+{
+	if (!peek(info) || peek(info)->type != TOK_WORD)
+		return (fail(info));
+	return (word_list(info));
+}
+
+/**
+ * parse_if - Parses if list then list [elif list then list]... [else list] fi
+ * An elif becomes a nested NODE_IF in the else branch.
+ * @info: The parameter struct, looking at 'if' or 'elif'.
+ * Return: A NODE_IF node, or NULL on failure.
+ */
+static node_t *parse_if(info_t *info)
+{
+	node_t *n = new_node(info, NODE_IF, NULL, NULL);
+
+	if (!n)
+		return (NULL);
+	info->tok_pos++;
+	n->kid[0] = parse_list(info);
+	if (!n->kid[0] || !expect(info, TOK_WORD, KW_THEN))
+		return (NULL);
+	n->kid[1] = parse_list(info);
+	if (!n->kid[1])
+		return (NULL);
+	if (is_word(peek(info), KW_ELIF)) // The nested if consumes the 'fi'
+	{
+		n->kid[2] = parse_if(info);
+		return (n->kid[2] ? n : NULL);
+	}
+	if (is_word(peek(info), KW_ELSE))
+	{
+		info->tok_pos++;
+		n->kid[2] = parse_list(info);
+		if (!n->kid[2])
+			return (NULL);
+	}
+	return (expect(info, TOK_WORD, KW_FI) ? n : NULL);
+}
+
+/**
+ * parse_do - Parses the do list done body shared by every loop.
+ * @info: The parameter struct.
+ * Return: The body, or NULL on failure.
+ */
+static node_t *parse_do(info_t *info)
+{
+	node_t *body;
+
+	skip_newlines(info);
+	if (!expect(info, TOK_WORD, KW_DO))
+		return (NULL);
+	body = parse_list(info);
+	if (!body || !expect(info, TOK_WORD, KW_DONE))
+		return (NULL);
+	return (body);
+}
+
+/**
+ * parse_while - Parses while/until list do list done.
+ * @info: The parameter struct, looking at 'while' or 'until'.
+ * @type: NODE_WHILE or NODE_UNTIL.
+ * Return: The loop's node, or NULL on failure.
+ */
+static node_t *parse_while(info_t *info, int type)
+{
+	node_t *cond, *body;
+
+	info->tok_pos++;
+	cond = parse_list(info);
+	if (!cond)
+		return (NULL);
+	body = parse_do(info);
+	if (!body)
+		return (NULL);
+	return (new_node(info, type, cond, body));
+}
+
+/**
+ * parse_arith_for - Parses the ((init; cond; step)) header of a C-style
+ * for loop, compiling each of the three expressions once.
+ * @info: The parameter struct, looking at the TOK_ARITH token.
+ * @n: The NODE_ARITH_FOR node to fill in.
+ * Return: n, or NULL on failure.
+ */
+static node_t *parse_arith_for(info_t *info, node_t *n)
+{
+	char *part[3], *p = peek(info)->str;
+	int i;
+
+	for (i = 0; i < 3; i++)
+	{
+		part[i] = p;
+		p = _strchr(p, ';');
+		if ((i < 2 && !p) || (i == 2 && p))
+			return (fail(info));
+		if (p)
+			*p++ = '\0';
+	}
+	for (i = 0; i < 3; i++)
+	{
+		n->ex[i] = parse_arith(info, peek(info), part[i]);
+		if (info->parse_err != PARSE_OK)
+			return (NULL);
+	}
+	info->tok_pos++;
+	if (peek(info) && peek(info)->type == TOK_SEMI)
+		info->tok_pos++;
+	n->kid[0] = parse_do(info);
+	return (n->kid[0] ? n : NULL);
+}
+
+/**
+ * parse_for - Parses for name [in word...] do list done, or the
+ * C-style for ((init; cond; step)) do list done.
+ * Without 'in', kid[1] is NULL and the loop runs over the positional
+ * parameters.
+ * @info: The parameter struct, looking at 'for'.
+ * Return: The loop's node, or NULL on failure.
+ */
+static node_t *parse_for(info_t *info)
+{
+	token_t *tok;
+	node_t *n;
+
+	info->tok_pos++;
+	tok = peek(info);
+	if (tok && tok->type == TOK_ARITH)
+	{
+		n = new_node(info, NODE_ARITH_FOR, NULL, NULL);
+		return (n ? parse_arith_for(info, n) : NULL);
+	}
+	if (!tok || tok->type != TOK_WORD || tok->flags || !valid_name(tok->str))
+		return (fail(info));
+	n = new_node(info, NODE_FOR, NULL, NULL);
+	if (!n)
+		return (NULL);
+	n->nwords = 1;
+	n->words = copy_words(info, info->tok_pos++, 1, 1);
+	if (!n->words)
+		return (NULL);
+	skip_newlines(info);
+	if (is_word(peek(info), KW_IN))
+	{
+		info->tok_pos++;
+		n->kid[1] = word_list(info);
+		if (!n->kid[1])
+			return (NULL);
+		tok = peek(info);
+		if (!tok || (tok->type != TOK_SEMI && tok->type != TOK_NEWLINE))
+			return (fail(info));
+		info->tok_pos++;
+	}
+	else if (peek(info) && peek(info)->type == TOK_SEMI)
+		info->tok_pos++;
+	n->kid[0] = parse_do(info);
+	return (n->kid[0] ? n : NULL);
+}
+
+/**
+ * parse_case_item - Parses [(] pattern [| pattern]... ) [list] [;;]
+ * @info: The parameter struct.
+ * Return: A NODE_CASE_ITEM node, or NULL on failure.
+ */
+static node_t *parse_case_item(info_t *info)
+{
+	size_t start;
+	node_t *n = new_node(info, NODE_CASE_ITEM, NULL, NULL);
+	token_t *tok;
+
+	if (!n)
+		return (NULL);
+	if (peek(info) && peek(info)->type == TOK_LPAREN)
+		info->tok_pos++;
+	start = info->tok_pos;
+	while (1) // Patterns alternate with '|' tokens
+	{
+		tok = peek(info);
+		if (!tok || tok->type != TOK_WORD)
+			return (fail(info));
+		info->tok_pos++;
+		n->nwords++;
+		if (!peek(info) || peek(info)->type != TOK_PIPE)
+			break;
+		info->tok_pos++;
+	}
+	n->words = copy_words(info, start, n->nwords, 2);
+	if (!n->words || !expect(info, TOK_RPAREN, 0))
+		return (NULL);
+	skip_newlines(info);
+	tok = peek(info);
+	if (tok && tok->type != TOK_DSEMI && !is_word(tok, KW_ESAC))
+	{
+		n->kid[0] = parse_list(info);
+		if (!n->kid[0])
+			return (NULL);
+	}
+	tok = peek(info);
+	if (tok && tok->type == TOK_DSEMI)
+		info->tok_pos++;
+	else if (!is_word(tok, KW_ESAC))
+		return (fail(info));
+	skip_newlines(info);
+	return (n);
+}
+
+/**
+ * parse_case - Parses case word in item... esac
+ * The items hang off kid[0] as a chain linked through kid[1].
+ * @info: The parameter struct, looking at 'case'.
+ * Return: A NODE_CASE node, or NULL on failure.
+ */
+static node_t *parse_case(info_t *info)
+{
+	node_t *n, **tail;
+
+	info->tok_pos++;
+	if (!peek(info) || peek(info)->type != TOK_WORD)
+		return (fail(info));
+	n = new_node(info, NODE_CASE, NULL, NULL);
+	if (!n)
+		return (NULL);
+	n->nwords = 1;
+	n->words = copy_words(info, info->tok_pos++, 1, 1);
+	if (!n->words)
+		return (NULL);
+	skip_newlines(info);
+	if (!expect(info, TOK_WORD, KW_IN))
+		return (NULL);
+	skip_newlines(info);
+	for (tail = &n->kid[0]; !is_word(peek(info), KW_ESAC); tail = &(*tail)->kid[1])
+	{
+		*tail = parse_case_item(info);
+		if (!*tail)
+			return (NULL);
+	}
+	info->tok_pos++;
+	return (n);
+}
+
+/**
+ * parse_funcdef - Parses name ( ) compound-command
+ * The body must be a compound command: { }, ( ), if, while, until, for
+ * or case.
+ * @info: The parameter struct, looking at the name.
+ * Return: A NODE_FUNCDEF node, or NULL on failure.
+ */
+static node_t *parse_funcdef(info_t *info)
+{
+	node_t *n = new_node(info, NODE_FUNCDEF, NULL, NULL);
+	token_t *tok;
+	int kw;
+
+	if (!n)
+		return (NULL);
+	n->nwords = 1;
+	n->words = copy_words(info, info->tok_pos, 1, 1);
+	if (!n->words)
+		return (NULL);
+	info->tok_pos += 3; // name ( )
+	skip_newlines(info);
+	tok = peek(info);
+	kw = keyword(tok);
+	if ((kw < KW_LBRACE || kw > KW_CASE) && (!tok || tok->type != TOK_LPAREN))
+		return (fail(info));
+	n->kid[0] = parse_compound(info);
+	return (n->kid[0] ? n : NULL);
+}
+
+/**
+ * is_funcdef - Checks whether the tokens at the parser's position start
+ * a function definition: an unquoted name followed by '(' ')'.
+ * @info: The parameter struct.
+ * Return: 1 if they do, 0 otherwise.
+ */
+static int is_funcdef(info_t *info)
+{
+	token_t *tok = peek(info);
+
+	return (tok && tok->type == TOK_WORD && !tok->flags
+		&& info->tok_pos + 2 < info->tok_count
+		&& tok[1].type == TOK_LPAREN && tok[2].type == TOK_RPAREN
+		&& valid_name(tok->str));
+}
+
+/**
+ * parse_compound - Parses a command: a grouping, a control-flow construct,
+ * an arithmetic command, a function definition or a simple command.
+ * @info: The parameter struct.
+ * Return: The command's node, or NULL on failure.
+ */
+static node_t *parse_compound(info_t *info)
+{
+	token_t *tok = peek(info);
+	node_t *body;
+
+	if (tok && tok->type == TOK_LPAREN) // ( list ) runs in a subshell
+	{
+		info->tok_pos++;
+		body = parse_list(info);
+		if (!body || !expect(info, TOK_RPAREN, 0))
+			return (fail(info));
+		return (new_node(info, NODE_SUBSHELL, body, NULL));
+	}
+	if (is_word(tok, KW_LBRACE)) // { list ; } runs in the current shell
+	{
+		info->tok_pos++;
+		body = parse_list(info);
+		if (!body || !expect(info, TOK_WORD, KW_RBRACE))
+			return (fail(info));
+		return (new_node(info, NODE_GROUP, body, NULL));
+	}
+	if (tok && tok->type == TOK_ARITH) // (( expression ))
+	{
+		body = new_node(info, NODE_ARITH, NULL, NULL);
+		if (!body)
+			return (NULL);
+		body->ex[0] = parse_arith(info, tok, tok->str);
+		info->tok_pos++;
+		return (info->parse_err == PARSE_OK ? body : NULL);
+	}
+	switch (keyword(tok)) // One table lookup for every reserved word
+	{
+	case KW_IF:
+		return (parse_if(info));
+	case KW_WHILE:
+		return (parse_while(info, NODE_WHILE));
+	case KW_UNTIL:
+		return (parse_while(info, NODE_UNTIL));
+	case KW_FOR:
+		return (parse_for(info));
+	case KW_CASE:
+		return (parse_case(info));
+	}
+	if (ends_list(tok)) // A closing reserved word with nothing to close
+		return (fail(info));
+	if (is_funcdef(info))
+		return (parse_funcdef(info));
+	return (parse_simple(info));
+}
+
+/**
+ * parse_pipeline - Parses [!] command [| command]...
+ * @info: The parameter struct.
+ * Return: The pipeline's node, or NULL on failure.
+ */
+static node_t *parse_pipeline(info_t *info)
+{
+	int bang = 0;
+	node_t *n, *rest;
+
+	if (is_word(peek(info), KW_BANG))
+	{
+		bang = 1;
+		info->tok_pos++;
+	}
+	n = parse_compound(info);
+	if (n && peek(info) && peek(info)->type == TOK_PIPE)
+	{
+		info->tok_pos++;
+		skip_newlines(info);
+		rest = parse_pipeline(info); // Right-nested: a | (b | c)
+		if (!rest)
+			return (NULL);
+		if (rest->type == NODE_NOT) // '!' is only valid at the start
+			return (fail(info));
+		n = new_node(info, NODE_PIPE, n, rest);
+	}
+	if (n && bang)
+		n = new_node(info, NODE_NOT, n, NULL);
+	return (n);
+}
+
+/**
+ * parse_and_or - Parses pipeline [&& pipeline | || pipeline]...
+ * The operators have equal precedence and group to the left.
+ * @info: The parameter struct.
+ * Return: The node, or NULL on failure.
+ */
+static node_t *parse_and_or(info_t *info)
+{
+	node_t *n = parse_pipeline(info), *rhs;
+	token_t *tok;
+	int type;
+
+	while (n && (tok = peek(info)) && (tok->type == TOK_AND || tok->type == TOK_OR))
+	{
+		type = tok->type == TOK_AND ? NODE_AND : NODE_OR;
+		info->tok_pos++;
+		skip_newlines(info);
+		rhs = parse_pipeline(info);
+		if (!rhs)
+			return (NULL);
+		n = new_node(info, type, n, rhs);
+	}
+	return (n);
+}
+
+/**
+ * parse_list - Parses and_or [; and_or | & and_or | newline and_or]...
+ * up to a token that ends a list (')' , '}', end of input).
+ * @info: The parameter struct.
+ * Return: The list's node, or NULL on failure or an empty list.
+ */
+static node_t *parse_list(info_t *info)
+{
+	node_t *head = NULL, **tail = &head, *n;
+	token_t *tok;
+
+	skip_newlines(info);
+	while (!ends_list(peek(info)))
+	{
+		n = parse_and_or(info);
+		if (!n)
+			return (NULL);
+		tok = peek(info);
+		if (tok && tok->type == TOK_AMP)
+			n = new_node(info, NODE_BG, n, NULL);
+		if (tok && (tok->type == TOK_SEMI || tok->type == TOK_AMP
+			|| tok->type == TOK_NEWLINE))
+			info->tok_pos++;
+		else if (!ends_list(tok))
+			return (fail(info));
+		*tail = new_node(info, NODE_SEQ, n, NULL);
+		if (!*tail)
+			return (NULL);
+		tail = &(*tail)->kid[1];
+		skip_newlines(info);
+	}
+	if (!head)
+		return (fail(info)); // An empty list is not allowed inside ( ) or { }
+	return (head);
+}
+
+/**
+ * parse_command - Parses one complete command from the tokens read so far,
+ * stopping at the newline that ends it at the top level.
+ * On return info->parse_err says whether the command is complete,
+ * needs another line, or had a syntax error.
+ * @info: The parameter struct.
+ * Return: The command's AST, or NULL for an empty line or on failure.
+ */
+node_t *parse_command(info_t *info)
+{
+	node_t *head = NULL, **tail = &head, *n;
+	token_t *tok;
+
+	info->parse_err = PARSE_OK;
+	skip_newlines(info);
+	while (peek(info))
+	{
+		n = parse_and_or(info);
+		if (!n)
+			return (NULL);
+		tok = peek(info);
+		if (tok && tok->type == TOK_AMP)
+			n = new_node(info, NODE_BG, n, NULL);
+		*tail = new_node(info, NODE_SEQ, n, NULL);
+		if (!*tail)
+			return (NULL);
+		tail = &(*tail)->kid[1];
+		if (!tok)
+			break;
+		if (tok->type != TOK_SEMI && tok->type != TOK_AMP && tok->type != TOK_NEWLINE)
+			return (fail(info));
+		info->tok_pos++;
+		if (tok->type != TOK_NEWLINE && peek(info) && peek(info)->type == TOK_NEWLINE)
+			info->tok_pos++; // A trailing ';' or '&' ends the line too
+		else if (tok->type != TOK_NEWLINE)
+			continue;
+		break;
+	}
+	return (head);
+}
@@ -0,0 +1,203 @@
+#include "../includes/shell.h"
+
+/**
+ * loop_ctl - Handles a break or continue raised inside a loop's body.
+ * @info: The parameter & return info struct.
+ * Return: 1 if the loop must stop, 0 if it goes on to its next iteration.
+ */
+static int loop_ctl(info_t *info)
+{
+	int ctl = info->ctl;
+
+	if (ctl != CTL_BREAK && ctl != CTL_CONTINUE)
+		return (ctl != CTL_NONE); // Exit (or nothing) passes straight through
+	if (--info->ctl_levels > 0) // Aimed at an enclosing loop
+		return (1);
+	info->ctl = CTL_NONE;
+	return (ctl == CTL_BREAK);
+}
+
+/**
+ * end_loop - Finishes evaluating a loop.
+ * @info: The parameter & return info struct.
+ * @status: Status of the last body command run (0 if none ran).
+ * Return: The loop's exit status.
+ */
+static int end_loop(info_t *info, int status)
+{
+	info->loop_depth--;
+	if (info->ctl == CTL_NONE)
+		info->status = status;
+	return (info->status);
+}
+
+/**
+ * eval_if - Evaluates if/elif/else.
+ * @info: The parameter & return info struct.
+ * @node: A NODE_IF node.
+ * Return: The status of the branch run, or 0 if none ran.
+ */
+int eval_if(info_t *info, node_t *node)
+{
+	eval_node(info, node->kid[0]);
+	if (info->ctl != CTL_NONE)
+		return (info->status);
+	if (info->status == 0)
+		return (eval_node(info, node->kid[1]));
+	if (node->kid[2])
+		return (eval_node(info, node->kid[2]));
+	return (info->status = 0);
+}
+
+/**
+ * eval_loop - Evaluates while and until loops. The condition and body
+ * were parsed once and are walked again on every iteration.
+ * @info: The parameter & return info struct.
+ * @node: A NODE_WHILE or NODE_UNTIL node.
+ * Return: The status of the last body command run, or 0.
+ */
+int eval_loop(info_t *info, node_t *node)
+{
+	int status = 0;
+
+	info->loop_depth++;
+	while (1)
+	{
+		eval_node(info, node->kid[0]);
+		if (loop_ctl(info))
+			break;
+		if ((info->status == 0) != (node->type == NODE_WHILE))
+			break;
+		eval_node(info, node->kid[1]);
+		status = info->status;
+		if (loop_ctl(info))
+			break;
+	}
+	return (end_loop(info, status));
+}
+
+/**
+ * eval_for - Evaluates for name in words; the words are expanded once,
+ * before the first iteration.
+ * @info: The parameter & return info struct.
+ * @node: A NODE_FOR node.
+ * Return: The status of the last body command run, or 0.
+ */
+int eval_for(info_t *info, node_t *node)
+{
+	char **vals;
+	int i, status = 0;
+
+	if (node->kid[1])
+		vals = expand_words(info, node->kid[1]->words, node->kid[1]->nwords);
+	else // Without 'in' the loop runs over the positional parameters
+		vals = dup_vector(info->params, info->nparams);
+	if (!vals) // expand_words sets the status of its own failures
+		return (node->kid[1] ? info->status : (info->status = 1));
+	info->loop_depth++;
+	for (i = 0; vals[i]; i++)
+	{
+		if (var_set(info, node->words[0].str, vals[i])) // var_set from variables/shell_variables.c
+		{
+			status = 1;
+			break;
+		}
+		eval_node(info, node->kid[0]);
+		status = info->status;
+		if (loop_ctl(info))
+			break;
+	}
+	free(vals);
+	return (end_loop(info, status));
+}
+
+/**
+ * eval_arith_for - Evaluates for ((init; cond; step)) using the
+ * expressions compiled by the parser.
+ * @info: The parameter & return info struct.
+ * @node: A NODE_ARITH_FOR node.
+ * Return: The status of the last body command run, 0, or 2 on an
+ * arithmetic error.
+ */
+int eval_arith_for(info_t *info, node_t *node)
+{
+	long v;
+	int status = 0;
+
+	if (arith_run(info, node->ex[0], &v)) // arith_run from variables/arithmetic.c
+		return (info->status);
+	info->loop_depth++;
+	while (1)
+	{
+		if (node->ex[1] && arith_run(info, node->ex[1], &v))
+		{
+			status = 2;
+			break;
+		}
+		if (node->ex[1] && !v) // An empty condition is always true
+			break;
+		eval_node(info, node->kid[0]);
+		status = info->status;
+		if (loop_ctl(info))
+			break;
+		if (arith_run(info, node->ex[2], &v))
+		{
+			status = 2;
+			break;
+		}
+	}
+	return (end_loop(info, status));
+}
+
+/**
+ * eval_case - Evaluates case: runs the list of the first item with a
+ * pattern that matches the word. Patterns are compiled once and cached.
+ * @info: The parameter & return info struct.
+ * @node: A NODE_CASE node.
+ * Return: The status of the list run, or 0 if no pattern matched.
+ */
+int eval_case(info_t *info, node_t *node)
+{
+	char **word, *pat;
+	node_t *item;
+	pattern_t *p;
+	int i, match = 0;
+
+	info->xjoin = 1; // "$@" must not change the number of words
+	word = expand_words(info, node->words, 1);
+	if (!word)
+	{
+		info->xjoin = 0;
+		return (info->status);
+	}
+	for (item = node->kid[0]; item && !match; item = match ? item : item->kid[1])
+	{
+		for (i = 0; i < item->nwords && !match; i++)
+		{
+			pat = expand_pattern(info, &item->words[i]); // expand_pattern from variables/variable_expansion.c
+			if (!pat)
+				break;
+			p = pattern_get(info, pat); // pattern_get from variables/pattern_match.c
+			match = p && pattern_match(p, word[0], _strlen(word[0]));
+		}
+	}
+	info->xjoin = 0;
+	free(word);
+	info->status = 0;
+	return (match ? eval_node(info, item->kid[0]) : 0);
+}
+
+/**
+ * eval_arith - Evaluates the (( expression )) command.
+ * @info: The parameter & return info struct.
+ * @node: A NODE_ARITH node.
+ * Return: 0 if the expression is non-zero, 1 if it is zero, 2 on error.
+ */
+int eval_arith(info_t *info, node_t *node)
+{
+	long v;
+
+	if (arith_run(info, node->ex[0], &v))
+		return (info->status);
+	return (info->status = !v);
+}
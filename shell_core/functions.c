@@ -0,0 +1,221 @@
+#include "../includes/shell.h"
+
+static node_t *copy_node(arena_t *a, node_t *n);
+
+/**
+ * copy_arith - Deep-copies a compiled arithmetic expression into an arena.
+ * @a: The destination arena.
+ * @e: The expression.
+ * Return: The copy, or NULL on allocation failure.
+ */
+static arith_t *copy_arith(arena_t *a, arith_t *e)
+{
+	arith_t *c = arena_alloc(a, sizeof(arith_t));
+	int i;
+
+	if (!c)
+		return (NULL);
+	*c = *e;
+	if (e->name && !(c->name = arena_strndup(a, e->name, _strlen(e->name))))
+		return (NULL);
+	for (i = 0; i < 3; i++)
+		if (e->kid[i] && !(c->kid[i] = copy_arith(a, e->kid[i])))
+			return (NULL);
+	return (c);
+}
+
+/**
+ * copy_node - Deep-copies an AST into an arena, so a function body
+ * outlives the parse arena of the line that defined it. The kid[1] chain
+ * (the commands of a list, one after another) is followed in a loop, so a
+ * body of any length does not nest calls.
+ * @a: The destination arena.
+ * @n: The AST.
+ * Return: The copy, or NULL on allocation failure.
+ */
+static node_t *copy_node(arena_t *a, node_t *n)
+{
+	node_t *first = NULL, **tail = &first, *c;
+	int i;
+
+	for (; n; n = n->kid[1], tail = &c->kid[1])
+	{
+		c = arena_alloc(a, sizeof(node_t));
+		if (!c)
+			return (NULL);
+		*c = *n;
+		*tail = c;
+		if (n->nwords)
+		{
+			c->words = arena_alloc(a, sizeof(word_t) * n->nwords);
+			if (!c->words)
+				return (NULL);
+			for (i = 0; i < n->nwords; i++)
+			{
+				c->words[i].flags = n->words[i].flags;
+				c->words[i].str = arena_strndup(a, n->words[i].str, _strlen(n->words[i].str));
+				if (!c->words[i].str)
+					return (NULL);
+			}
+		}
+		for (i = 0; i < 3; i++)
+		{
+			if (i != 1 && n->kid[i] && !(c->kid[i] = copy_node(a, n->kid[i])))
+				return (NULL);
+			if (n->ex[i] && !(c->ex[i] = copy_arith(a, n->ex[i])))
+				return (NULL);
+		}
+	}
+	return (first);
+}
+
+/**
+ * drop_function - Releases a function that was redefined or removed.
+ * A body that is still running is freed when its last call returns.
+ * @v: The func_t.
+ */
+static void drop_function(void *v)
+{
+	func_t *f = v;
+
+	if (!f)
+		return;
+	f->dead = 1;
+	if (f->refs)
+		return;
+	arena_free(&f->mem); // arena_free from memory_utils/arena.c
+	free(f);
+}
+
+/**
+ * define_function - Evaluates name() body: copies the parsed body into
+ * the function's own arena and stores it in the function table.
+ * @info: The parameter & return info struct.
+ * @node: A NODE_FUNCDEF node.
+ * Return: 0, or 1 on allocation failure.
+ */
+int define_function(info_t *info, node_t *node)
+{
+	func_t *f = malloc(sizeof(func_t));
+	hash_entry_t *e;
+
+	if (!f)
+		return (info->status = 1);
+	_memset((char *)f, 0, sizeof(func_t));
+	f->body = copy_node(&f->mem, node->kid[0]);
+	e = f->body ? hash_insert(&info->funcs, node->words[0].str) : NULL;
+	if (!e) // hash_insert from linked_lists/hash_table.c
+	{
+		drop_function(f);
+		return (info->status = 1);
+	}
+	drop_function(e->value);
+	e->value = f;
+	return (info->status = 0);
+}
+
+/**
+ * load_function - Defines a function from a packed body, such as one read
+ * back from a state file (see io_handling/state_snapshot.c). The body's
+ * strings stay in the image, which must outlive the function.
+ * @info: The parameter & return info struct.
+ * @name: The function's name.
+ * @image: The body, as made by ast_pack.
+ * @len: Size of the image.
+ * Return: 0, 1 if the image is corrupt or empty, -1 on allocation failure.
+ */
+int load_function(info_t *info, char *name, void *image, size_t len)
+{
+	func_t *f = malloc(sizeof(func_t));
+	hash_entry_t *e;
+
+	if (!f)
+		return (-1);
+	_memset((char *)f, 0, sizeof(func_t));
+	if (ast_unpack(&f->mem, image, len, &f->body) || !f->body) // ast_unpack from io_handling/script_cache.c
+	{
+		drop_function(f);
+		return (1);
+	}
+	e = hash_insert(&info->funcs, name);
+	if (!e)
+	{
+		drop_function(f);
+		return (-1);
+	}
+	drop_function(e->value);
+	e->value = f;
+	return (0);
+}
+
+/**
+ * find_function - Looks up a shell function.
+ * @info: The parameter & return info struct.
+ * @name: The command name.
+ * Return: The function, or NULL if there is none by that name.
+ */
+func_t *find_function(info_t *info, char *name)
+{
+	hash_entry_t *e = hash_find(&info->funcs, name);
+
+	return (e ? e->value : NULL);
+}
+
+/**
+ * call_function - Runs a shell function in the current process with
+ * argv[1..] as its positional parameters.
+ * @info: The parameter & return info struct; argv holds the call.
+ * @f: The function.
+ * Return: The function's exit status.
+ */
+int call_function(info_t *info, func_t *f)
+{
+	char **params = info->params;
+	int nparams = info->nparams, loop_depth = info->loop_depth;
+	list_t *locals = info->locals;
+
+	info->params = dup_vector(info->argv + 1, info->argc - 1);
+	if (!info->params)
+	{
+		info->params = params;
+		return (info->status = 1);
+	}
+	info->nparams = info->argc - 1;
+	info->locals = NULL;
+	info->loop_depth = 0; // break and continue do not reach the caller's loops
+	info->func_depth++;
+	f->refs++;
+	eval_node(info, f->body);
+	if (info->ctl == CTL_RETURN)
+		info->ctl = CTL_NONE;
+	if (!--f->refs && f->dead)
+		drop_function(f);
+	info->func_depth--;
+	var_restore(info, &info->locals); // var_restore from variables/shell_variables.c
+	free(info->params);
+	info->params = params;
+	info->nparams = nparams;
+	info->locals = locals;
+	info->loop_depth = loop_depth;
+	return (info->status);
+}
+
+/**
+ * remove_function - Removes a function definition (unset -f).
+ * @info: The parameter & return info struct.
+ * @name: The function's name.
+ * Return: 1 if it was removed, 0 if there was no such function.
+ */
+int remove_function(info_t *info, char *name)
+{
+	return (hash_remove(&info->funcs, name, drop_function));
+}
+
+/**
+ * free_functions - Frees every function definition.
+ * @info: The parameter & return info struct.
+ */
+void free_functions(info_t *info)
+{
+	hash_free(&info->funcs, drop_function);
+}
@@ -0,0 +1,267 @@
+#include "../includes/shell.h"
+
+/**
+ * read_all - Reads everything left on a file descriptor.
+ * @fd: The file descriptor.
+ * @hint: Expected size (the file size for regular files), or 0.
+ * @len: Receives the number of bytes read.
+ * Return: A malloc'd buffer with room for two more bytes, or NULL.
+ */
+char *read_all(int fd, size_t hint, size_t *len)
+{
+	size_t cap = hint + 3 > READ_BUF_SIZE ? hint + 3 : READ_BUF_SIZE; // + 1: EOF needs no growth
+	char *buf = malloc(cap), *p;
+	ssize_t r;
+
+	*len = 0;
+	while (buf)
+	{
+		if (*len + 2 >= cap) // Keep room for the final newline and NUL
+		{
+			p = _realloc(buf, cap, cap * 2);
+			if (!p)
+				break;
+			buf = p;
+			cap *= 2;
+		}
+		r = read(fd, buf + *len, cap - *len - 2);
+		if (r == 0)
+			return (buf);
+		if (r < 0 && errno != EINTR)
+			break;
+		if (r > 0)
+			*len += r;
+	}
+	free(buf);
+	return (NULL);
+}
+
+/**
+ * map_text - Maps a regular-file script for lexing. The mapping is
+ * private and writable, as the lexer terminates words in place, and is
+ * followed by zero-filled memory so that a final newline and NUL can be
+ * added even when the file ends exactly on a page boundary.
+ * @fd: The script, a regular file.
+ * @size: Its size.
+ * @sc: The script; text and text_map are set on success.
+ * Return: 0 on success, -1 if it could not be mapped (read it instead).
+ */
+static int map_text(int fd, size_t size, script_t *sc)
+{
+	size_t page = sysconf(_SC_PAGESIZE), len = (size + 2 + page - 1) & ~(page - 1);
+	char *p;
+
+	if (!size)
+		return (-1);
+	p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+		return (-1);
+	if (mmap(p, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+	{
+		munmap(p, len);
+		return (-1);
+	}
+	madvise(p, size, MADV_SEQUENTIAL); // Lexed front to back, once
+	lseek(fd, 0, SEEK_END); // As if it had been read
+	sc->text = p;
+	sc->text_map = len;
+	return (0);
+}
+
+/**
+ * compile_script - Lexes and parses a whole script into one command list.
+ * The parser works on the script's own arena and token vector, so the
+ * command that is running (e.g. the `.` that loads the script) is left
+ * untouched. On a syntax error the commands before it are kept and the
+ * failure is recorded so it can be reported after they have run.
+ * @info: The parameter struct.
+ * @sc: The script; sc->text holds its text.
+ */
+static void compile_script(info_t *info, script_t *sc)
+{
+	arena_t parse = info->parse;
+	token_t *tokens = info->tokens;
+	size_t count = info->tok_count, cap = info->tok_cap, pos = info->tok_pos, start;
+	int parse_err = info->parse_err, status = info->status;
+	node_t **tail = &sc->root, *n;
+
+	info->parse = sc->mem;
+	info->tokens = NULL;
+	info->tok_count = info->tok_cap = info->tok_pos = 0;
+	info->syntax_quiet++; // Errors are reported once the commands before them ran
+	if (lex_line(info, sc->text, 1) < 0) // lex_line from string_operations/string_tokenization.c
+	{
+		sc->fail = LEX_INCOMPLETE;
+		while (info->tok_count && info->tokens[info->tok_count - 1].type != TOK_NEWLINE)
+			info->tok_count--; // Only whole lines before the open quote run
+	}
+	while (info->tok_pos < info->tok_count)
+	{
+		start = info->tok_pos;
+		n = parse_command(info); // parse_command from shell_core/command_parser.c
+		if (info->parse_err != PARSE_OK)
+		{
+			sc->fail = sc->fail ? sc->fail : info->parse_err;
+			sc->fail_tok = start;
+			break;
+		}
+		for (*tail = n; *tail; tail = &(*tail)->kid[1]) // Append the NODE_SEQ chain
+			;
+	}
+	info->syntax_quiet--;
+	sc->mem = info->parse;
+	sc->tokens = info->tokens;
+	sc->tok_count = info->tok_count;
+	info->parse = parse;
+	info->tokens = tokens;
+	info->tok_count = count;
+	info->tok_cap = cap;
+	info->tok_pos = pos;
+	info->parse_err = parse_err;
+	info->status = status; // A syntax error only counts once it is reported
+}
+
+/**
+ * report_failure - Reports the syntax error that stopped a script.
+ * A parse error is found again, this time with messages on; running out
+ * of input is reported on the script's last line.
+ * @info: The parameter struct.
+ * @sc: The script.
+ */
+static void report_failure(info_t *info, script_t *sc)
+{
+	token_t *tokens = info->tokens;
+	size_t count = info->tok_count, pos = info->tok_pos;
+	arena_t parse = info->parse;
+	int parse_err = info->parse_err;
+
+	info->line_count = sc->lines;
+	if (sc->fail == LEX_INCOMPLETE)
+		syntax_error(info, NULL, "Unterminated quoted string");
+	else if (sc->fail == PARSE_INCOMPLETE)
+		syntax_error(info, NULL, "end of file unexpected");
+	else
+	{
+		info->tokens = sc->tokens;
+		info->tok_count = sc->tok_count;
+		info->tok_pos = sc->fail_tok;
+		info->parse = sc->mem;
+		parse_command(info);
+		sc->mem = info->parse;
+		info->tokens = tokens;
+		info->tok_count = count;
+		info->tok_pos = pos;
+		info->parse = parse;
+		info->parse_err = parse_err;
+	}
+	info->status = 2;
+}
+
+/**
+ * compile_text - Compiles the text of a script, which has room for two
+ * more bytes: a final newline is added if it lacks one, then a NUL.
+ * @info: The parameter struct.
+ * @sc: The script; sc->text holds its text.
+ * @len: Length of the text.
+ */
+static void compile_text(info_t *info, script_t *sc, size_t len)
+{
+	char *p;
+
+	if (!len || sc->text[len - 1] != '\n')
+		sc->text[len++] = '\n';
+	sc->text[len] = '\0';
+	for (p = sc->text; (p = memchr(p, '\n', sc->text + len - p)); p++)
+		sc->lines++;
+	compile_script(info, sc);
+}
+
+/**
+ * run_compiled - Runs a compiled script, reports the syntax error that
+ * stopped it, if any, and releases it.
+ * @info: The parameter struct.
+ * @sc: The script.
+ */
+static void run_compiled(info_t *info, script_t *sc)
+{
+	eval_node(info, sc->root); // eval_node from shell_core/command_executor.c
+	if (sc->fail && info->ctl == CTL_NONE)
+		report_failure(info, sc);
+	if (sc->map)
+		munmap(sc->map, sc->map_len);
+	arena_free(&sc->mem);
+	free(sc->tokens);
+	if (sc->text_map)
+		munmap(sc->text, sc->text_map);
+	else
+		free(sc->text);
+	free(sc->path);
+}
+
+/**
+ * run_string - Runs a command string (hsh -c) in the current shell. It is
+ * compiled whole, like a script, but never cached.
+ * @info: The parameter struct.
+ * @cmd: The commands.
+ * Return: 0 if the commands ran (their status is in info->status), or -1
+ * on allocation failure.
+ */
+int run_string(info_t *info, char *cmd)
+{
+	script_t sc;
+	size_t len = _strlen(cmd);
+
+	_memset((char *)&sc, 0, sizeof(sc));
+	sc.text = malloc(len + 2);
+	if (!sc.text)
+		return (-1);
+	memcpy(sc.text, cmd, len);
+	compile_text(info, &sc, len);
+	run_compiled(info, &sc);
+	return (0);
+}
+
+/**
+ * run_script - Runs a whole script file in the current shell.
+ * The script is loaded from the compiled-script cache when an entry for
+ * this exact file (path, inode, size and mtime) exists; otherwise it is
+ * lexed and parsed in one go and the result is stored in the cache. A
+ * regular file is lexed straight from a mapping of it; anything else is
+ * read into memory first.
+ * @info: The parameter struct.
+ * @path: The script's path.
+ * @fd: The script, open for reading at its start.
+ * Return: 0 if the script ran (its status is in info->status), or -1 if it
+ * could not be read.
+ */
+int run_script(info_t *info, char *path, int fd)
+{
+	script_t sc;
+	size_t len;
+
+	_memset((char *)&sc, 0, sizeof(sc));
+	if (fstat(fd, &sc.st) == -1)
+		return (-1);
+	if (S_ISREG(sc.st.st_mode))
+	{
+		sc.path = realpath(path, NULL);
+		if (sc.path && cache_load(info, &sc) == 0) // cache_load from io_handling/script_cache.c
+			lseek(fd, 0, SEEK_END); // As if it had been read
+	}
+	if (!sc.map)
+	{
+		len = sc.st.st_size;
+		if (!S_ISREG(sc.st.st_mode) || map_text(fd, len, &sc)) // Pipes and ttys are read
+			sc.text = read_all(fd, S_ISREG(sc.st.st_mode) ? sc.st.st_size : 0, &len);
+		if (!sc.text)
+		{
+			free(sc.path);
+			return (-1);
+		}
+		compile_text(info, &sc, len);
+		if (sc.path && !sc.fail)
+			cache_store(info, &sc); // cache_store from io_handling/script_cache.c
+	}
+	run_compiled(info, &sc);
+	return (0);
+}
@@ -2,21 +2,25 @@
 
 /**
  * hsh - Main shell loop.
- * Orchestrates input reading, command parsing, built-in checking,
- * and external command execution.
+ * Reads and parses one command at a time and evaluates it.
  * @info: The parameter & return info struct.
  * @av: The argument vector from main().
- * Return: 0 on success, 1 on error, or an error code signaling exit.
+ * Return: 0 (on exit the process ends with the shell's exit status).
  */
 int hsh(info_t *info, char **av)
 {
-	ssize_t r = 0; // Bytes read from input
-	int builtin_ret = 0; // Return value of built-in command
+	ssize_t r = 0; // Result of reading input
+	node_t *node; // The parsed command
+	unsigned int line; // Input line count while the command runs
 
+	if (!info->fname)
+		info->fname = av[0]; // Program name, used in error messages
 	// Loop until EOF or an exit signal from a built-in
-	while (r != -1 && builtin_ret != -2)
+	while (r != -1 && info->ctl != CTL_EXIT)
 	{
 		clear_info(info); // Clear info struct for new command cycle (from shell_core/shell_utilities.c)
+		while (waitpid(-1, NULL, WNOHANG) > 0)
+			; // Reap background jobs that have finished
 		if (is_interactive(info))
 		{
 			char cwd[1024]; // Buffer to hold the current working directory
@@ -62,40 +66,45 @@ int hsh(info_t *info, char **av)
 				_puts("hsh$ "); // Fallback prompt if getcwd fails
 			}
 		}
-		_eputchar(BUF_FLUSH); // Flush stderr buffer (from error_handling/error_reporter.c)
 
-		r = get_input(info); // Read input line (from io_handling/input_reader.c)
-		if (r != -1) // If input was successfully read
+		r = get_input(info, &node); // Read and parse a command (from io_handling/input_reader.c)
+		line = info->line_count;
+		if (r != -1)
 		{
-			set_info(info, av); // Parse arguments and set info struct (from shell_core/shell_utilities.c)
-			builtin_ret = find_builtin(info); // Check if it's a built-in
-            if (builtin_ret == -1) // If not a built-in
-            {
-                find_cmd(info); // Find the path for the command (updates info->path)
-                if (info->path) // If a path was successfully found
-                {
-                    fork_cmd(info); // Execute the command (from shell_core/command_executor.c)
-                }
-            }
+			eval_node(info, node); // Run it (from shell_core/command_executor.c)
+			info->line_count = line; // Evaluation moves it to each command's line
 		}
 		else if (is_interactive(info)) // If EOF encountered in interactive mode, print newline
 			_putchar('\n');             // _putchar from string_operations/string_manipulation2.c
-
-		free_info(info, 0); // Free command-specific info fields (from shell_core/shell_utilities.c)
 	}
 
-	write_history(info); // Write history to file before exit (from history/history_manager.c)
+	exit_shell(info);
+	return (0);
+}
+
+/**
+ * exit_shell - Ends the shell: saves the history (and the state, with
+ * --save-state), frees everything and exits with the shell's status. It
+ * returns, for main() to return 0, only when that status is 0 or the
+ * shell was interactive.
+ * @info: The parameter & return info struct.
+ */
+void exit_shell(info_t *info)
+{
+	if (!info->batch)
+		write_history(info); // Append the unsaved history before exit (from history/history_manager.c)
+	if (info->state_file)
+		save_state(info, info->state_file); // save_state from io_handling/state_snapshot.c
 	free_info(info, 1); // Free all remaining info fields (including lists)
 
-	if (!is_interactive(info) && info->status) // If not interactive and there's a status
-		exit(info->status); // Exit with last command's status
-	if (builtin_ret == -2) // If a built-in explicitly signaled exit
+	if (info->ctl == CTL_EXIT) // If a built-in explicitly signaled exit
 	{
 		if (info->err_num == -1) // Default exit status
 			exit(info->status);
 		exit(info->err_num); // Exit with the built-in's error number
 	}
-	return (builtin_ret); // Return final built-in status
+	if (!is_interactive(info) && info->status) // If not interactive and there's a status
+		exit(info->status); // Exit with last command's status
 }
 
 /*
@@ -2,12 +2,13 @@
 
 /**
  * is_interactive - Returns true if the shell is in interactive mode.
+ * A batch shell (-c, -s or a script) never is, and does not ask the tty.
  * @info: Struct address containing shell information.
  * Return: 1 if interactive mode, 0 otherwise.
  */
 int is_interactive(info_t *info)
 {
-	return (isatty(STDIN_FILENO) && info->readfd <= 2);
+	return (!info->batch && info->readfd <= 2 && isatty(STDIN_FILENO));
 }
 
 /**
@@ -37,6 +38,22 @@ int is_alpha_char(int c)
 		return (0);
 }
 
+/**
+ * valid_name - Checks that a string is a valid variable name:
+ * a letter or '_' followed by letters, digits and '_'.
+ * @s: The string to check.
+ * Return: 1 if valid, 0 otherwise.
+ */
+int valid_name(char *s)
+{
+	if (!is_alpha_char(*s) && *s != '_')
+		return (0);
+	while (*++s)
+		if (!is_alpha_char(*s) && *s != '_' && (*s < '0' || *s > '9'))
+			return (0);
+	return (1);
+}
+
 /**
  * string_to_int - Converts a string to an integer.
  * @s: The string to be converted.
@@ -76,50 +93,200 @@ int string_to_int(char *s)
  */
 void clear_info(info_t *info)
 {
-	info->arg = NULL;
 	info->argv = NULL;
 	info->path = NULL;
 	info->argc = 0;
-	// Reset other relevant fields for a new command cycle if needed
-	info->cmd_buf = NULL;
-	info->cmd_buf_type = CMD_NORM;
-	info->readfd = 0; // Default to stdin
-	info->linecount_flag = 0;
 	info->err_num = 0;
-	// histcount, env, history, alias, environ, env_changed, status remain across commands
+	// arg, readfd, histcount, env, history, aliases, environ, status remain across commands
+}
+
+/**
+ * argv_reserve - Grows the reusable argv vector geometrically so that it
+ * holds at least n pointers. Its contents are kept.
+ * @info: Struct address.
+ * @n: Number of pointers needed.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+int argv_reserve(info_t *info, size_t n)
+{
+	size_t cap;
+	char **v;
+
+	if (info->argv_cap >= n)
+		return (0);
+	cap = info->argv_cap * 2 > n ? info->argv_cap * 2 : n;
+	v = _realloc(info->argv_buf, info->argv_cap * sizeof(char *), cap * sizeof(char *));
+	if (!v)
+		return (-1);
+	info->argv_buf = v;
+	info->argv_cap = cap;
+	return (0);
 }
 
 /**
- * set_info - Initializes info_t struct members from argument vector.
- * Parses the raw argument string into an array of strings.
+ * build_argv - Points info->argv at the given words, growing the reusable
+ * vector as needed.
  * @info: Struct address.
- * @av: Argument vector from main().
+ * @words: The words.
+ * @n: Number of words.
+ * Return: 0 on success, -1 on allocation failure.
  */
-void set_info(info_t *info, char **av)
+static int build_argv(info_t *info, word_t *words, int n)
 {
 	int i = 0;
 
-	info->fname = av[0]; // Program name
-	if (info->arg) // If there's a command line string from input_reader
+	if (argv_reserve(info, (size_t)n + 1))
+	{
+		info->argv = NULL;
+		return (-1);
+	}
+	info->argv = info->argv_buf;
+	for (i = 0; i < n; i++) // Words point straight into the line buffer
+		info->argv[i] = words[i].str;
+	info->argv[n] = NULL;
+	info->argc = n;
+	info->cmd_words = words;
+	return (0);
+}
+
+/**
+ * set_info - Initializes info_t struct members for a simple command.
+ * Builds argv from the command's words and expands them.
+ * @info: Struct address.
+ * @words: The words of the command.
+ * @n: Number of words.
+ */
+void set_info(info_t *info, word_t *words, int n)
+{
+	if (n && info->aliases.count)
+		words = expand_alias(info, words, &n); // expand_alias from variables/aliases.c
+	if (!n || build_argv(info, words, n)) // Empty command or no memory
+		return;
+	replace_vars(info);   // replace_vars from variables/variable_expansion.c
+}
+
+/**
+ * expand_words - Expands words that are not a command (for-loop lists,
+ * case words and patterns) into a private vector.
+ * The vector and its strings are one malloc'd block, so they survive
+ * the commands run while it is in use.
+ * @info: Struct address.
+ * @words: The words.
+ * @n: Number of words.
+ * Return: A NULL-terminated vector the caller frees, or NULL on failure
+ * (info->status is then set).
+ */
+char **expand_words(info_t *info, word_t *words, int n)
+{
+	char **v = NULL;
+
+	if (n && build_argv(info, words, n))
+	{
+		info->status = 1;
+		return (NULL);
+	}
+	if (!n || replace_vars(info) >= 0) // On an expansion error status is set
 	{
-		// Tokenize the argument string into argv
-		info->argv = strtow(info->arg, " \t"); // strtow from string_operations/string_tokenization.c
-		if (!info->argv) // If tokenization fails (e.g., only spaces)
+		v = dup_vector(info->argv, n ? info->argc : 0); // "$@" may change the count
+		if (!v)
+			info->status = 1;
+	}
+	free_info(info, 0);
+	return (v);
+}
+
+/**
+ * decl_group - Finds the end of an argument of a declaration command: a
+ * name=( word takes its elements along.
+ * @words: The words of the command.
+ * @i: Index of the argument's first word.
+ * @n: Number of words.
+ * Return: Index of the word after the argument.
+ */
+static int decl_group(word_t *words, int i, int n)
+{
+	int k = i + 1;
+
+	while ((words[i].flags & TOKF_ARRAY) && k < n && (words[k].flags & TOKF_ELEM))
+		k++;
+	return (k);
+}
+
+/**
+ * set_decl - Builds argv for a declaration command that has name=(...)
+ * arguments. Each argument is expanded on its own; a name=( word and its
+ * elements become the one argument "name=" (or "name+="), with the
+ * elements in info->arrays at the same index.
+ * @info: Struct address.
+ * @words: The words of the command.
+ * @n: Number of words.
+ * Return: The expanded arguments, a NULL-terminated list of vectors which
+ * the caller frees once the command has run, or NULL on failure (status
+ * is then set).
+ */
+char ***set_decl(info_t *info, word_t *words, int n)
+{
+	char ***parts = malloc(sizeof(char **) * (n + 1));
+	int i, j, g, argc = 0;
+
+	for (i = g = 0; parts && i < n; i = decl_group(words, i, n), g++)
+	{
+		parts[g] = expand_words(info, words + i, decl_group(words, i, n) - i);
+		parts[g + 1] = NULL;
+		for (j = 0; parts[g] && parts[g][j]; j++)
+			;
+		argc += words[i].flags & TOKF_ARRAY ? 1 : j;
+		if (!parts[g])
+			break;
+	}
+	if (!parts || i < n || argv_reserve(info, (size_t)argc + 1)
+		|| !(info->arrays = arena_alloc(&info->scratch, sizeof(char **) * (argc + 1))))
+	{
+		if (!parts || i == n) // Out of memory, not an expansion error
+			info->status = 1;
+		for (g = 0; parts && parts[g]; g++)
+			free(parts[g]);
+		free(parts);
+		return (NULL);
+	}
+	info->argv = info->argv_buf;
+	for (i = g = argc = 0; i < n; i = decl_group(words, i, n), g++)
+		for (j = 0; parts[g][j]; j++)
 		{
-			info->argv = malloc(sizeof(char *) * 2); // Allocate for at least argv[0] and NULL
-			if (info->argv)
-			{
-				info->argv[0] = _strdup(info->arg); // _strdup from string_operations/string_manipulation2.c
-				info->argv[1] = NULL;
-			}
+			info->arrays[argc] = words[i].flags & TOKF_ARRAY ? parts[g] + 1 : NULL;
+			info->argv[argc++] = parts[g][j];
+			if (words[i].flags & TOKF_ARRAY) // The elements are not arguments
+				break;
 		}
-		for (i = 0; info->argv && info->argv[i]; i++)
-			; // Count argc
-		info->argc = i;
+	info->argv[argc] = NULL;
+	info->arrays[argc] = NULL;
+	info->argc = argc;
+	return (parts);
+}
 
-		replace_alias(info); // replace_alias from variables/variable_expansion.c
-		replace_vars(info);   // replace_vars from variables/variable_expansion.c
-	}
+/**
+ * dup_vector - Copies n strings into a single malloc'd block holding a
+ * NULL-terminated vector followed by the strings.
+ * @src: The strings.
+ * @n: Number of strings.
+ * Return: The copy (one free() releases it), or NULL on failure.
+ */
+char **dup_vector(char **src, int n)
+{
+	size_t size = sizeof(char *) * (n + 1);
+	char **v, *p;
+	int i;
+
+	for (i = 0; i < n; i++)
+		size += _strlen(src[i]) + 1;
+	v = malloc(size);
+	if (!v)
+		return (NULL);
+	p = (char *)(v + n + 1);
+	for (i = 0; i < n; i++, p += _strlen(p) + 1)
+		v[i] = _strcpy(p, src[i]);
+	v[n] = NULL;
+	return (v);
 }
 
 /**
@@ -129,25 +296,43 @@ void set_info(info_t *info, char **av)
  */
 void free_info(info_t *info, int all)
 {
-	ffree(info->argv); // ffree from memory_utils/memory_allocators.c
-	info->argv = NULL;
+	info->argv = NULL; // Words are owned by the line buffer or the scratch arena
+	info->arrays = NULL;
+	arena_reset(&info->scratch); // arena_reset from memory_utils/arena.c
 	info->path = NULL; // path is usually a pointer to memory managed by find_path or argv[0]
 
 	if (all) // Free all fields, including persistent lists
 	{
-		if (!info->cmd_buf) // If cmd_buf wasn't managed by chaining, free info->arg
-			free(info->arg);
-		if (info->env)
-			free_list(&(info->env)); // free_list from linked_lists/list_operations.c
-		if (info->history)
-			free_list(&(info->history));
-		if (info->alias)
-			free_list(&(info->alias));
-		ffree(info->environ); // Free the char** array copy of environ
-		info->environ = NULL;
-		bfree((void **)info->cmd_buf); // bfree from memory_utils/memory_allocators.c
+		bfree((void **)&info->arg); // The last raw input line
+		info->arg_cap = 0;
+		bfree((void **)&info->in.buf);
+		info->in.cap = info->in.pos = info->in.len = info->in.scan = 0;
+		free_env(info); // free_env from environment/env_manager.c
+		hist_free(info); // hist_free from history/history_manager.c
+		free_aliases(info); // free_aliases from variables/aliases.c
+		bfree((void **)&info->argv_buf);
+		info->argv_cap = 0;
+		bfree((void **)&info->rdbuf.buf);
+		info->rdbuf.pos = info->rdbuf.len = 0;
+		bfree((void **)&info->xbuf);
+		info->xbuf_len = info->xbuf_cap = 0;
+		arena_free(&info->scratch);
+		bfree((void **)&info->tokens);
+		info->tok_count = info->tok_cap = info->tok_pos = 0;
+		arena_free(&info->parse);
+		free_functions(info); // free_functions from shell_core/functions.c
+		if (info->state_map) // Held the bodies of functions loaded from a state file
+			munmap(info->state_map, info->state_len);
+		info->state_map = NULL;
+		free_patterns(info); // free_patterns from variables/pattern_match.c
+		free_vars(info); // free_vars from variables/shell_variables.c
+		free_list(&info->locals);
+		bfree((void **)&info->params);
+		info->nparams = 0;
+		bfree((void **)&info->pending);
+		info->pending_len = 0;
 		if (info->readfd > 2) // Close non-standard input file descriptors
 			close(info->readfd);
-		_putchar(BUF_FLUSH); // Flush any remaining buffered output
+		flush_output(); // Flush any remaining buffered output (from io_handling/output_buffer.c)
 	}
 }
@@ -58,34 +58,18 @@ char *_strdup(const char *str)
  */
 void _puts(char *str)
 {
-	int i = 0;
-
-	if (!str)
-		return;
-	while (str[i] != '\0')
-	{
-		_putchar(str[i]); // _putchar is defined in this file.
-		i++;
-	}
+	if (str)
+		out_write(1, str, _strlen(str)); // out_write from io_handling/output_buffer.c
 }
 
 /**
- * _putchar - Writes the character c to stdout.
- * Implements buffering for efficiency.
- * @c: The character to print.
+ * _putchar - Writes the character c to stdout, through its buffer.
+ * @c: The character to print, or BUF_FLUSH to write out the buffer.
  * Return: On success 1. On error, -1 is returned.
  */
 int _putchar(char c)
 {
-	static int i; // Static counter for buffer index
-	static char buf[WRITE_BUF_SIZE]; // Static buffer for output
-
-	if (c == BUF_FLUSH || i >= WRITE_BUF_SIZE) // If buffer is full or flush signal
-	{
-		write(1, buf, i); // Write buffer content to stdout
-		i = 0; // Reset buffer index
-	}
-	if (c != BUF_FLUSH) // If not a flush signal, add char to buffer
-		buf[i++] = c;
-	return (1);
+	if (c == BUF_FLUSH)
+		return (out_flush(1) ? -1 : 1); // out_flush from io_handling/output_buffer.c
+	return (out_putc(1, c)); // out_putc from io_handling/output_buffer.c
 }
@@ -1,105 +1,486 @@
 #include "../includes/shell.h"
 
+/*
+ * Character classes for the lexer. Every byte of the input is classified
+ * with a single table lookup; CC_WORD is 0 so the hot loop over ordinary
+ * word characters is a plain `while (!char_class[c])`.
+ */
+#define CC_WORD     0
+#define CC_END      1
+#define CC_BLANK    2
+#define CC_NEWLINE  3
+#define CC_OP       4
+#define CC_SQUOTE   5
+#define CC_DQUOTE   6
+#define CC_BSLASH   7
+#define CC_HASH     8
+#define CC_DOLLAR   9
+
+/*
+ * Word flag private to the lexer: the word holds a backslash-newline to
+ * drop. It is cleared before the word is stored, so that a reserved word
+ * continued on the next line is still unquoted.
+ */
+#define TOKF_JOINED 32
+
+static const unsigned char char_class[256] = {
+	['\0'] = CC_END,
+	[' '] = CC_BLANK, ['\t'] = CC_BLANK,
+	['\n'] = CC_NEWLINE,
+	[';'] = CC_OP, ['&'] = CC_OP, ['|'] = CC_OP, ['('] = CC_OP, [')'] = CC_OP,
+	['\''] = CC_SQUOTE, ['"'] = CC_DQUOTE, ['\\'] = CC_BSLASH,
+	['#'] = CC_HASH, ['$'] = CC_DOLLAR
+};
+
 /**
- * strtow - Splits a string into words based on a delimiter string.
- * Repeated delimiters are ignored.
- * @str: The input string to split.
- * @d: The delimiter string (e.g., " \t\n").
- * Return: A pointer to an array of strings (words), or NULL on failure.
+ * push_token - Appends a token to info->tokens, growing the vector geometrically.
+ * @info: The parameter struct holding the token vector.
+ * @type: The TOK_* type of the token.
+ * @flags: TOKF_* flags describing a word token.
+ * @str: Start of the token text (NULL for operators).
+ * @line: Line number the token starts on.
+ * Return: 0 on success, -1 on allocation failure.
  */
-char **strtow(char *str, char *d)
+static int push_token(info_t *info, int type, int flags, char *str,
+	unsigned int line)
 {
-	int i, j, k, m, numwords = 0;
-	char **s; // Array of strings to return
+	token_t *tok;
+	size_t cap;
 
-	if (str == NULL || str[0] == 0) // Handle empty or NULL string
-		return (NULL);
-	if (!d) // Default delimiter to space if not provided
-		d = " ";
+	if (info->tok_count == info->tok_cap)
+	{
+		cap = info->tok_cap ? info->tok_cap * 2 : 32;
+		tok = _realloc(info->tokens, info->tok_cap * sizeof(token_t),
+			cap * sizeof(token_t));
+		if (!tok)
+			return (-1);
+		info->tokens = tok;
+		info->tok_cap = cap;
+	}
+	tok = &info->tokens[info->tok_count++];
+	tok->type = type;
+	tok->flags = flags;
+	tok->str = str;
+	tok->line = line;
+	return (0);
+}
 
-	// Count number of words
-	for (i = 0; str[i] != '\0'; i++)
-		if (!is_delimiter(str[i], d) && (is_delimiter(str[i + 1], d) || !str[i + 1])) // Word boundary logic
-			numwords++;
+/**
+ * scan_braced - Finds the '}' closing a ${...} expansion, so that quotes
+ * and blanks inside it (as in ${x:-"a b"}) stay part of the word.
+ * @p: First byte after the "${".
+ * @line: Incremented for every newline inside the braces.
+ * Return: Pointer to the first byte after the '}', or NULL if the
+ * braces or a quote inside them are left unterminated.
+ */
+static char *scan_braced(char *p, unsigned int *line)
+{
+	char *q;
+
+	for (; *p != '}'; p++)
+	{
+		if (!*p)
+			return (NULL);
+		*line += *p == '\n';
+		if (*p == '\\' && p[1])
+			*line += *++p == '\n';
+		else if (*p == '\'')
+		{
+			while (*++p != '\'')
+			{
+				if (!*p)
+					return (NULL);
+				*line += *p == '\n';
+			}
+		}
+		else if (*p == '"')
+		{
+			while (*++p != '"')
+			{
+				if (!*p)
+					return (NULL);
+				*line += *p == '\n';
+				if (*p == '\\' && p[1])
+					p++;
+				else if (*p == '$' && p[1] == '{')
+				{
+					q = scan_braced(p + 2, line);
+					if (!q)
+						return (NULL);
+					p = q - 1;
+				}
+			}
+		}
+		else if (*p == '$' && p[1] == '{')
+		{
+			q = scan_braced(p + 2, line);
+			if (!q)
+				return (NULL);
+			p = q - 1;
+		}
+	}
+	return (p + 1);
+}
 
-	if (numwords == 0) // No words found
-		return (NULL);
+/**
+ * glob_char - Checks for a character that means something in a pattern.
+ * Quoted, it must stay escaped in a case pattern, so a word that quotes
+ * one is left raw for the expander (TOKF_DOLLAR) instead of unquoted here.
+ * @c: The character.
+ * Return: TOKF_DOLLAR if it is one, else 0.
+ */
+static int glob_char(char c)
+{
+	return (c == '*' || c == '?' || c == '[' || c == '\\' ? TOKF_DOLLAR : 0);
+}
 
-	// Allocate memory for the array of string pointers (+1 for NULL terminator)
-	s = malloc((1 + numwords) * sizeof(char *));
-	if (!s)
-		return (NULL);
+/**
+ * scan_word - Finds the end of the word starting at p, honouring quotes,
+ * backslash escapes and ${...} expansions. A backslash-newline continues
+ * the word on the next line; word_unquote() drops it.
+ * @p: Start of the word.
+ * @flags: Receives TOKF_QUOTED, TOKF_DOLLAR and/or TOKF_JOINED.
+ * @line: Incremented for every newline inside the word's quotes.
+ * Return: Pointer to the first byte after the word, or NULL if a quote
+ * is left unterminated or the input ends with a backslash-newline.
+ */
+static char *scan_word(char *p, int *flags, unsigned int *line)
+{
+	char *q;
 
-	// Populate the array with words
-	for (i = 0, j = 0; j < numwords; j++)
+	while (1)
 	{
-		while (is_delimiter(str[i], d)) // Skip leading delimiters
-            i++;
-        k = 0; // Length of current word
-        while (!is_delimiter(str[i + k], d) && str[i + k]) // Find end of current word
-			k++;
-		s[j] = malloc((k + 1) * sizeof(char)); // Allocate memory for the current word
-		if (!s[j]) // Handle malloc failure for a word
+		while (!char_class[(unsigned char)*p]) // Fast path: ordinary characters
+			p++;
+		switch (char_class[(unsigned char)*p])
 		{
-			for (k = 0; k < j; k++) // Free previously allocated words
-				free(s[k]);
-			free(s); // Free the array of pointers
-			return (NULL);
+		case CC_HASH: // '#' only starts a comment at the start of a word
+			p++;
+			break;
+		case CC_DOLLAR:
+			*flags |= TOKF_DOLLAR;
+			p = p[1] == '{' ? scan_braced(p + 2, line) : p + 1;
+			if (!p)
+				return (NULL);
+			break;
+		case CC_BSLASH:
+			if (p[1] == '\n' && !p[2]) // The next line continues the word
+				return (NULL);
+			*flags |= p[1] == '\n' ? TOKF_JOINED : TOKF_QUOTED | glob_char(p[1]);
+			*line += p[1] == '\n';
+			p += p[1] ? 2 : 1;
+			break;
+		case CC_SQUOTE:
+			*flags |= TOKF_QUOTED;
+			while (*++p != '\'')
+			{
+				if (!*p)
+					return (NULL);
+				*line += *p == '\n';
+				*flags |= glob_char(*p);
+			}
+			p++;
+			break;
+		case CC_DQUOTE:
+			*flags |= TOKF_QUOTED;
+			while (*++p != '"')
+			{
+				if (!*p)
+					return (NULL);
+				*line += *p == '\n';
+				if (*p == '$')
+					*flags |= TOKF_DOLLAR;
+				*flags |= glob_char(*p);
+				if (*p == '$' && p[1] == '{')
+				{
+					q = scan_braced(p + 2, line);
+					if (!q)
+						return (NULL);
+					p = q - 1; // The loop steps over the '}'
+				}
+				else if (*p == '\\' && p[1])
+					*line += *++p == '\n';
+			}
+			p++;
+			break;
+		default: // Blank, newline, operator or end of input ends the word
+			return (p);
 		}
-		for (m = 0; m < k; m++) // Copy the word characters
-			s[j][m] = str[i++];
-		s[j][m] = 0; // Null-terminate the word
 	}
-	s[j] = NULL; // Null-terminate the array of strings
-	return (s);
 }
 
 /**
- * strtow2 - Splits a string into words based on a single character delimiter.
- * @str: The input string to split.
- * @d: The single character delimiter.
- * Return: A pointer to an array of strings (words), or NULL on failure.
+ * assign_flags - Checks whether a word starts with an unquoted NAME=,
+ * NAME+= or NAME[subscript]=. A NAME= or NAME+= that the word ends with,
+ * right before a '(', starts an array assignment NAME=(...).
+ * @p: Start of the word.
+ * @end: End of the word.
+ * Return: TOKF_ASSIGN, possibly with TOKF_ARRAY, or 0.
+ */
+static int assign_flags(char *p, char *end)
+{
+	int sub = 0;
+
+	if (!is_alpha_char(*p) && *p != '_')
+		return (0);
+	while (is_alpha_char(*++p) || *p == '_' || (*p >= '0' && *p <= '9'))
+		;
+	if (*p == '[')
+	{
+		sub = 1;
+		while (++p < end && *p != ']')
+			if ((*p == '\'' || *p == '"') && !(p = _strchr(p + 1, *p)))
+				return (0);
+		p += p < end;
+	}
+	p += *p == '+';
+	if (*p != '=')
+		return (0);
+	return (TOKF_ASSIGN | (p + 1 == end && *end == '(' && !sub ? TOKF_ARRAY : 0));
+}
+
+/**
+ * scan_operator - Classifies the operator at p.
+ * @p: Pointer to an operator character.
+ * @type: Receives the TOK_* type.
+ * Return: The number of bytes the operator occupies.
+ */
+static int scan_operator(char *p, int *type)
+{
+	switch (*p)
+	{
+	case ';':
+		*type = p[1] == ';' ? TOK_DSEMI : TOK_SEMI;
+		return (p[1] == ';' ? 2 : 1);
+	case '&':
+		*type = p[1] == '&' ? TOK_AND : TOK_AMP;
+		return (p[1] == '&' ? 2 : 1);
+	case '|':
+		*type = p[1] == '|' ? TOK_OR : TOK_PIPE;
+		return (p[1] == '|' ? 2 : 1);
+	case '(':
+		*type = TOK_LPAREN;
+		return (1);
+	default:
+		*type = TOK_RPAREN;
+		return (1);
+	}
+}
+
+/**
+ * scan_arith - Finds the "))" closing an arithmetic expression, skipping
+ * over nested parentheses.
+ * @p: First byte of the expression, just after "((".
+ * Return: Pointer to the first ')' of the closing "))", or NULL if the
+ * expression is not closed.
  */
-char **strtow2(char *str, char d)
+static char *scan_arith(char *p)
 {
-	int i, j, k, m, numwords = 0;
-	char **s;
-
-	if (str == NULL || str[0] == 0)
-		return (NULL);
-	
-	// Count number of words
-	// Logic slightly different for single char delimiter:
-	// A word starts if current char is not delimiter AND (next is delimiter OR next is null)
-	// Or if current char is delimiter and next is delimiter (empty field between two delimiters)
-	for (i = 0; str[i] != '\0'; i++)
-		if ((str[i] != d && str[i + 1] == d) ||
-		    (str[i] != d && !str[i + 1]) || str[i + 1] == d)
-			numwords++;
-	if (numwords == 0)
-		return (NULL);
-	s = malloc((1 + numwords) * sizeof(char *));
-	if (!s)
-		return (NULL);
-	for (i = 0, j = 0; j < numwords; j++)
+	int depth = 0;
+
+	for (; *p; p++)
 	{
-		while (str[i] == d && str[i] != d) // Skip leading delimiters (this specific condition seems redundant 'str[i] != d')
-			i++;
-		k = 0;
-		while (str[i + k] != d && str[i + k] && str[i + k] != d) // Find end of word (redundant 'str[i+k] != d')
-			k++;
-		s[j] = malloc((k + 1) * sizeof(char));
-		if (!s[j])
+		if (*p == '(')
+			depth++;
+		else if (*p == ')' && !depth && p[1] == ')')
+			return (p);
+		else if (*p == ')')
+			depth--;
+	}
+	return (NULL);
+}
+
+/**
+ * word_unquote - Removes quotes and backslash escapes from a word in place,
+ * and the backslash-newlines that continue it outside single quotes.
+ * The result is never longer than the input, so no allocation is needed.
+ * @s: The NUL-terminated word to unquote.
+ * Return: s.
+ */
+char *word_unquote(char *s)
+{
+	char *r = s, *w = s;
+
+	while (*r)
+	{
+		if (*r == '\'')
 		{
-			for (k = 0; k < j; k++)
-				free(s[k]);
-			free(s);
-			return (NULL);
+			while (*++r && *r != '\'')
+				*w++ = *r;
+			r += *r ? 1 : 0;
+		}
+		else if (*r == '"')
+		{
+			while (*++r && *r != '"')
+			{
+				if (*r == '\\' && r[1] == '\n')
+				{
+					r++; // The loop steps over the newline
+					continue;
+				}
+				if (*r == '\\' && r[1] && _strchr("$`\"\\", r[1]))
+					r++;
+				*w++ = *r;
+			}
+			r += *r ? 1 : 0;
 		}
-		for (m = 0; m < k; m++)
-			s[j][m] = str[i++];
-		s[j][m] = 0;
+		else if (*r == '\\' && r[1])
+		{
+			if (r[1] != '\n')
+				*w++ = r[1];
+			r += 2;
+		}
+		else
+			*w++ = *r++;
 	}
-	s[j] = NULL;
+	*w = '\0';
 	return (s);
 }
+
+/**
+ * lex_words - Splits a text into words in place, the way lex_line splits
+ * a command, except that operator characters stay inside the words and
+ * nothing is a comment. Quoted words without expansions are unquoted.
+ * @p: The NUL-terminated text; it is modified in place.
+ * @words: Receives the words; needs room for strlen(p) / 2 + 1 of them.
+ * Return: The number of words, or -1 on an unterminated quote.
+ */
+int lex_words(char *p, word_t *words)
+{
+	int n = 0, flags;
+	unsigned int line = 0;
+	char *end;
+
+	while (1)
+	{
+		while (char_class[(unsigned char)*p] == CC_BLANK
+			|| char_class[(unsigned char)*p] == CC_NEWLINE
+			|| (*p == '\\' && p[1] == '\n'))
+			*p++ = '\0';
+		if (!*p)
+			return (n);
+		flags = 0;
+		for (end = scan_word(p, &flags, &line); end && char_class[(unsigned char)*end] == CC_OP;)
+			end = scan_word(end + 1, &flags, &line);
+		if (!end)
+			return (-1);
+		words[n].str = p;
+		words[n].flags = flags;
+		p = end + (*end != '\0');
+		*end = '\0';
+		if ((flags & (TOKF_QUOTED | TOKF_JOINED)) && !(flags & TOKF_DOLLAR))
+			word_unquote(words[n].str);
+		words[n++].flags &= ~TOKF_JOINED;
+	}
+}
+
+/**
+ * lex_line - Splits a line into word and operator tokens in a single pass.
+ * Words are NUL-terminated in place in the line buffer, comments are
+ * dropped, and words without expansions have their quotes removed.
+ * Words containing '$' are left raw (flagged TOKF_DOLLAR) for expansion.
+ * Words that start with an unquoted NAME= are flagged TOKF_ASSIGN; in
+ * NAME=(...) the '(' is consumed with the word, flagged TOKF_ARRAY.
+ * An arithmetic expression (( ... )) becomes a single TOK_ARITH token
+ * holding the raw text between the parentheses. A backslash-newline
+ * outside quotes joins the two lines, like an open quote.
+ * @info: The parameter struct; tokens are appended to info->tokens.
+ * @line: The text to tokenize (one or more lines). It is modified in place.
+ * @lineno: Line number of the first line of the text.
+ * Return: The total number of tokens, LEX_INCOMPLETE on an unterminated
+ * quote or a backslash-newline ending the text, or LEX_NOMEM on
+ * allocation failure.
+ */
+ssize_t lex_line(info_t *info, char *line, unsigned int lineno)
+{
+	char *p = line, *start;
+	int type, flags, n;
+	unsigned int first;
+
+	while (1)
+	{
+		switch (char_class[(unsigned char)*p])
+		{
+		case CC_END:
+			return (info->tok_count);
+		case CC_BLANK:
+			*p++ = '\0'; // Terminates any word that ended here
+			break;
+		case CC_HASH: // Comment runs to the end of the line
+			*p++ = '\0';
+			p += strcspn(p, "\n"); // Skipped a block at a time, not a byte
+			break;
+		case CC_NEWLINE:
+			*p++ = '\0';
+			if (push_token(info, TOK_NEWLINE, 0, NULL, lineno++))
+				return (LEX_NOMEM);
+			break;
+		case CC_OP:
+			if (p[0] == '(' && p[1] == '(') // (( expression )) is one token
+			{
+				start = p + 2;
+				*p = '\0';
+				p = scan_arith(start);
+				if (!p)
+					return (LEX_INCOMPLETE);
+				*p = '\0';
+				if (push_token(info, TOK_ARITH, 0, start, lineno))
+					return (LEX_NOMEM);
+				while (start < p)
+					lineno += *start++ == '\n';
+				p += 2;
+				break;
+			}
+			n = scan_operator(p, &type);
+			*p = '\0';
+			p += n;
+			if (push_token(info, type, 0, NULL, lineno))
+				return (LEX_NOMEM);
+			break;
+		default:
+			if (p[0] == '\\' && p[1] == '\n') // Between words it is a blank
+			{
+				if (!p[2])
+					return (LEX_INCOMPLETE);
+				*p++ = '\0';
+				*p++ = '\0';
+				lineno++;
+				break;
+			}
+			start = p;
+			flags = 0;
+			first = lineno;
+			p = scan_word(p, &flags, &lineno);
+			if (!p)
+				return (LEX_INCOMPLETE);
+			flags |= assign_flags(start, p);
+			if (push_token(info, TOK_WORD, flags & ~TOKF_JOINED, start, first))
+				return (LEX_NOMEM);
+			if (flags & TOKF_ARRAY) // The elements follow, up to a ')'
+				*p++ = '\0';
+			if ((flags & (TOKF_QUOTED | TOKF_JOINED)) && !(flags & TOKF_DOLLAR))
+			{
+				n = *p; // word_unquote needs the word terminated
+				*p = '\0';
+				word_unquote(start);
+				*p = n;
+			}
+		}
+	}
+}
+
+/**
+ * tok_name - Returns the source text of an operator token type,
+ * for use in syntax error messages.
+ * @type: The TOK_* type.
+ * Return: A static string.
+ */
+char *tok_name(int type)
+{
+	static char *names[] = {"word", ";", "&&", "||", "|", "&", "(", ")",
+		"newline", ";;", "(("};
+
+	if (type < 0 || type > TOK_ARITH)
+		return ("end of file");
+	return (names[type]);
+}
@@ -0,0 +1,199 @@
+#!/bin/sh
+# ==============================================================================
+# Regression checks for hsh: each one runs a script and compares its output.
+# Usage: sh tests/run_tests.sh [path/to/hsh]   (or: make check)
+# ==============================================================================
+
+HSH=${1:-./hsh}
+case $HSH in /*) ;; *) HSH=$PWD/$HSH ;; esac # check_sh runs elsewhere
+fail=0
+total=0
+tmp=$(mktemp -d "${TMPDIR:-/tmp}/hsh_tests.XXXXXX")
+trap 'rm -rf "$tmp"' EXIT
+
+# verdict NAME OUT EXPECTED - counts a check and reports it if OUT is wrong
+verdict()
+{
+	total=$((total + 1))
+	if [ "$2" != "$3" ]; then
+		fail=$((fail + 1))
+		printf 'FAIL %s\n  expected: %s\n  got:      %s\n' "$1" "$3" "$2"
+	fi
+}
+
+# check NAME SCRIPT EXPECTED - runs SCRIPT through hsh with no history file
+check()
+{
+	verdict "$1" "$(printf '%s\n' "$2" | HOME=/nonexistent "$HSH" 2>&1)" "$3"
+}
+
+# check_sh NAME COMMAND EXPECTED - runs a sh command line that calls "$HSH",
+# in the temporary directory $tmp, for checks that need files or options
+check_sh()
+{
+	verdict "$1" "$(cd "$tmp" && HOME=/nonexistent HSH=$HSH sh -c "$2" 2>&1)" "$3"
+}
+
+# Pipelines take the status of their last command
+check 'pipe true|false' 'true | false; echo $?' '1'
+check 'pipe false|true' 'false | true; echo $?' '0'
+check 'pipe in if' 'if echo x | grep -q y; then echo then; else echo else; fi' 'else'
+
+# Quoted characters in a case pattern match literally
+check 'case "a*"' 'case ab in "a*") echo lit;; a*) echo glob;; esac' 'glob'
+check 'case a\*' 'case ab in a\*) echo lit;; *) echo other;; esac' 'other'
+check 'case $p' 'p="a*"; case ab in $p) echo glob;; esac' 'glob'
+check 'case "$p"' 'p="a*"; case ab in "$p") echo lit;; *) echo other;; esac' 'other'
+
+# Declaration commands take array assignments
+check 'declare -A' 'declare -A m=([a]=1 [b]="x y"); echo ${m[b]}' 'x y'
+check 'declare -a' 'declare -a a=(1 2 3); echo ${#a[@]}' '3'
+check 'typeset -a' 'typeset -a t=(x); echo ${t[0]}' 'x'
+check 'local -a' 'f() { local -a v=("$@"); echo ${v[1]}; }; f p "q r"; echo "[${v[0]}]"' 'q r
+[]'
+
+# A backslash-newline outside single quotes joins the lines
+check 'continued word' 'echo a\
+b' 'ab'
+check 'continued keyword' 'if true; the\
+n echo "c\
+d"; fi' 'cd'
+check 'single-quoted \newline' "echo 'a\\
+b'" 'a\
+b'
+
+# C-style for loops; break and continue, also of enclosing loops
+check 'for ((;;))' 'for ((i = 0; i < 3; i++)); do echo $i; done' '0
+1
+2'
+check 'break/continue' 'for ((i = 0; i < 9; i++)); do (( i == 1 )) && continue; (( i == 3 )) && break; echo $i; done' '0
+2'
+check 'break 2/continue 2' 'for a in 1 2 3; do for b in x y; do (( a == 1 )) && continue 2; (( a == 3 )) && break 2; echo $a$b; done; done; echo end' '2x
+2y
+end'
+
+# Functions: arguments, local variables and return
+check 'local/return' 'f() { local x=in; echo $x; return 3; echo no; }; x=out; f; echo $? $x' 'in
+3 out'
+check 'recursive local' 'g() { local n=$1; (( n > 0 )) && { (( m = n - 1 )); g $m; }; echo $n; }; g 2' '0
+1
+2'
+
+# Parameter expansion operators
+check '${v##p} ${v%%p}' 'v=/usr/lib/libc.so.6; echo ${v##*/} ${v%%.*} ${v#*/} ${v%/*}' 'libc.so.6 /usr/lib/libc usr/lib/libc.so.6 /usr/lib'
+check '${v/p/r} ${v:o:l}' 'v=a-b-c; echo ${v/-/+} ${v//-/+} ${v:2:3} ${v: -1} ${v:1}' 'a+b-c a+b+c b-c c -b-c'
+
+# Aliases expand through other aliases, without looping
+check 'alias chain' 'alias a=b
+alias b="echo via b"
+a x' 'via b x'
+check 'alias trailing blank' 'alias e="echo "
+alias w=word
+e w' 'word'
+check 'alias loop' 'alias x=y
+alias y=x
+x' "$HSH: 3: x: not found"
+
+# read leaves a regular file's offset just past what it consumed
+printf 'one \\x\ntwo\nthree;four\nfive\n' > "$tmp/lines"
+check_sh 'while read -r' '"$HSH" -c '\''while read -r l; do echo "<$l>"; head -n 1; done'\'' < lines' '<one \x>
+two
+<three;four>
+five'
+check_sh 'read -d/-n' '"$HSH" -c '\''read l; echo "[$l]"; read -d ";" l; echo "[$l]"; read -n 3 l; echo "[$l]"; cat'\'' < lines' '[one x]
+[two
+three]
+[fou]
+r
+five'
+
+# Children see the environment as export and unset left it
+check 'export/unset envp' 'export T_A=1 T_B=2 T_C=3
+unset T_B
+export T_A=x
+env | grep "^T_"
+export T_D=4
+unsetenv T_C
+setenv T_A y
+printenv T_A T_B T_C T_D' 'T_A=x
+T_C=3
+y
+4'
+check 'export of a shell variable' 'T_X=1
+env | grep -c ^T_X=
+export T_X
+env | grep ^T_X=
+unset T_X
+env | grep -c ^T_X=' '0
+T_X=1
+0'
+
+# A state image carries the environment, aliases and functions over
+check_sh 'state round trip' '"$HSH" --save-state st -c '\''export T_S=1; alias sa="echo alias"; f() { echo func $1; }'\''
+env -u T_S "$HSH" --load-state st -c '\''printenv T_S; sa; f x'\' '1
+alias
+func x'
+echo junk > "$tmp/junk"
+check_sh 'bad state image' '"$HSH" --load-state junk -c '\''echo started'\' "$HSH: junk: not a usable state file
+started"
+
+# The reader keeps CRs, runs a last line without a newline and grows for
+# lines longer than its buffer
+check_sh 'CRLF input' 'printf '\''echo a\r\necho b'\'' | "$HSH" | cat -v' 'a^M
+b'
+printf 'echo a\necho last' > "$tmp/nonl"
+check_sh 'no final newline' '"$HSH" < nonl; "$HSH" nonl' 'a
+last
+a
+last'
+check_sh 'long line' 'awk '\''BEGIN { printf "echo"; for (i = 0; i < 50000; i++) printf " w"; print "" }'\'' | "$HSH" | awk '\''{ print NF }'\' '50000'
+
+# -c, -s and script operands set the positional parameters
+check_sh '-c params' '"$HSH" -c '\''echo $0 $#; for a in "$@"; do echo "<$a>"; done'\'' name a "b c"' 'name 2
+<a>
+<b c>'
+check_sh '-s params' 'echo '\''echo $# $1 "$2"'\'' | "$HSH" -s x "y z"' '2 x y z'
+echo 'echo $# $1' > "$tmp/args"
+check_sh 'script params' '"$HSH" args p q' '2 p'
+
+# Buffered built-in output comes out before what later commands write
+check 'builtin then child' 'alias a=1
+alias a
+echo child
+alias a
+cd /nonexistent
+alias a | cat
+alias a' "a='1'
+child
+a='1'
+$HSH: 5: cd: can't cd to /nonexistent
+a='1'
+a='1'"
+
+# Error lines stay whole when shells write to the same pipe at once: with
+# the line numbers taken out, all 2000 lines are the same
+check_sh 'parallel error lines' '{ for n in 1 2 3 4; do
+	awk '\''BEGIN { for (i = 0; i < 500; i++) printf "cd /nonexistent/%0300d\n", 0 }'\'' | "$HSH" &
+done; wait; } 2>&1 | sed '\''s/: [0-9]*: cd: /: cd: /'\'' | sort | uniq -c | awk '\''{ print $1 }'\' '2000'
+
+# history N prints the last N of the HIST_MAX lines kept, by number
+mkdir "$tmp/h049"
+check_sh 'history N' 'awk '\''BEGIN { for (i = 0; i < 4100; i++) print ": " i; print "history 2"; print "history | wc -l" }'\'' | HOME=$PWD/h049 "$HSH"' '4099: : 4099
+4100: history 2
+4096'
+
+# The history file gets the first line at once, then batches of
+# HIST_FLUSH_LINES, and the rest on exit; past HIST_COMPACT lines it is
+# rewritten with the last HIST_MAX
+mkdir "$tmp/h050a" "$tmp/h050b"
+check_sh 'history batches' 'awk '\''BEGIN { for (i = 0; i < 130; i++) print ": " i; print "cat $HOME/.simple_shell_history | wc -l" }'\'' | HOME=$PWD/h050a "$HSH"
+wc -l < h050a/.simple_shell_history' '129
+131'
+awk 'BEGIN { for (i = 0; i < 9000; i++) print "old " i }' > "$tmp/h050b/.simple_shell_history"
+check_sh 'history compaction' 'echo ": new" | HOME=$PWD/h050b "$HSH"
+wc -l < h050b/.simple_shell_history; sed -n '\''1p;$p'\'' h050b/.simple_shell_history' '4096
+old 4905
+: new'
+
+echo "$((total - fail))/$total checks passed"
+[ "$fail" -eq 0 ]
@@ -0,0 +1,201 @@
+#include "../includes/shell.h"
+
+/**
+ * alias_alloc - Allocates an alias with room for its words and both
+ * copies of its value in the same block.
+ * @len: Size of the value, its NUL included.
+ * @words: Number of words to make room for.
+ * Return: The alias, with its pointers set, or NULL on allocation failure.
+ */
+static alias_t *alias_alloc(size_t len, size_t words)
+{
+	alias_t *a = malloc(sizeof(alias_t) + words * sizeof(word_t) + len * 2);
+
+	if (!a)
+		return (NULL);
+	_memset((char *)a, 0, sizeof(alias_t));
+	a->words = (word_t *)(a + 1);
+	a->value = (char *)(a->words + words);
+	a->text = a->value + len;
+	a->len = len;
+	return (a);
+}
+
+/**
+ * alias_put - Stores an alias under a name, replacing any previous one.
+ * @info: The parameter struct.
+ * @name: The alias name.
+ * @a: The alias; freed if it cannot be stored.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int alias_put(info_t *info, char *name, alias_t *a)
+{
+	hash_entry_t *e = hash_insert(&info->aliases, name); // hash_insert from linked_lists/hash_table.c
+
+	if (!e)
+	{
+		free(a);
+		return (-1);
+	}
+	free(e->value);
+	e->value = a;
+	return (0);
+}
+
+/**
+ * alias_set - Defines (or redefines) an alias. The value is split into
+ * words once, here, so that using the alias is a copy and a splice. The
+ * alias, its words and both copies of the value share one allocation.
+ * @info: The parameter struct.
+ * @name: The alias name.
+ * @value: The value.
+ * Return: 0 on success, 1 if the value has an unterminated quote, -1 on
+ * allocation failure.
+ */
+int alias_set(info_t *info, char *name, char *value)
+{
+	size_t len = _strlen(value) + 1;
+	alias_t *a = alias_alloc(len, len / 2 + 1);
+
+	if (!a)
+		return (-1);
+	memcpy(a->value, value, len);
+	memcpy(a->text, value, len);
+	a->more = len > 1 && (value[len - 2] == ' ' || value[len - 2] == '\t');
+	a->nwords = lex_words(a->text, a->words); // lex_words from string_operations/string_tokenization.c
+	if (a->nwords < 0)
+	{
+		free(a);
+		return (1);
+	}
+	return (alias_put(info, name, a));
+}
+
+/**
+ * alias_load - Defines an alias that was already split into words, such
+ * as one read back from a state file (see io_handling/state_snapshot.c).
+ * @info: The parameter struct.
+ * @name: The alias name.
+ * @src: The alias; its words must point into its text.
+ * Return: 0 on success, 1 if src is inconsistent, -1 on allocation failure.
+ */
+int alias_load(info_t *info, char *name, alias_t *src)
+{
+	alias_t *a;
+	int i;
+
+	if (src->nwords < 0 || !src->len || src->text[src->len - 1])
+		return (1);
+	for (i = 0; i < src->nwords; i++)
+		if (src->words[i].str < src->text || src->words[i].str >= src->text + src->len)
+			return (1);
+	a = alias_alloc(src->len, src->nwords + 1);
+	if (!a)
+		return (-1);
+	memcpy(a->value, src->value, src->len);
+	memcpy(a->text, src->text, src->len);
+	a->nwords = src->nwords;
+	a->more = src->more;
+	for (i = 0; i < src->nwords; i++)
+	{
+		a->words[i].str = a->text + (src->words[i].str - src->text);
+		a->words[i].flags = src->words[i].flags;
+	}
+	return (alias_put(info, name, a));
+}
+
+/**
+ * alias_unset - Removes an alias.
+ * @info: The parameter struct.
+ * @name: The alias name.
+ * Return: 1 if the alias was removed, 0 if there was none.
+ */
+int alias_unset(info_t *info, char *name)
+{
+	return (hash_remove(&info->aliases, name, free));
+}
+
+/**
+ * splice - Replaces the word at position i with the words of an alias.
+ * The words go into a new vector and the alias text is copied, both in
+ * the scratch arena, as expansion may later rewrite the words.
+ * @info: The parameter struct.
+ * @words: The words of the command.
+ * @n: Number of words; updated.
+ * @i: Position of the word to replace.
+ * @a: The alias.
+ * Return: The new vector, or NULL on allocation failure.
+ */
+static word_t *splice(info_t *info, word_t *words, int *n, int i, alias_t *a)
+{
+	int k, total = *n - 1 + a->nwords;
+	word_t *w = arena_alloc(&info->scratch, sizeof(word_t) * (total + 1));
+	char *text = arena_alloc(&info->scratch, a->len);
+
+	if (!w || !text)
+		return (NULL);
+	memcpy(text, a->text, a->len);
+	memcpy(w, words, sizeof(word_t) * i);
+	for (k = 0; k < a->nwords; k++)
+	{
+		w[i + k].str = text + (a->words[k].str - a->text);
+		w[i + k].flags = a->words[k].flags;
+	}
+	memcpy(w + i + k, words + i + 1, sizeof(word_t) * (*n - i - 1));
+	*n = total;
+	return (w);
+}
+
+/**
+ * expand_alias - Expands the aliases of a command. A command word that
+ * is an unquoted alias name is replaced by the alias's words, and the
+ * first new word is checked again; when a value ends with a blank, the
+ * word after it is checked too. Each alias is used at most once per
+ * command (its seen mark is set to this expansion's number), so aliases
+ * such as ls='ls -F', or ones that refer to each other, end without any
+ * fixed limit on the depth.
+ * @info: The parameter struct.
+ * @words: The words of the command.
+ * @n: Number of words; updated.
+ * Return: The expanded words (the original ones if nothing changed).
+ */
+word_t *expand_alias(info_t *info, word_t *words, int *n)
+{
+	int i = 0, end, more;
+	unsigned int gen = ++info->alias_gen;
+	hash_entry_t *e;
+	alias_t *a;
+	word_t *w;
+
+	if (!gen) // Wrapped around; 0 is the mark of aliases never used
+		gen = ++info->alias_gen;
+	while (i < *n)
+	{
+		for (end = i + 1, more = 0; i < *n; end += a->nwords - 1)
+		{
+			e = words[i].flags ? NULL : hash_find(&info->aliases, words[i].str);
+			a = e ? e->value : NULL;
+			if (!a || a->seen == gen)
+				break;
+			a->seen = gen;
+			w = splice(info, words, n, i, a);
+			if (!w)
+				return (words);
+			words = w;
+			more |= a->more;
+		}
+		if (!more)
+			break;
+		i = end;
+	}
+	return (words);
+}
+
+/**
+ * free_aliases - Frees every alias.
+ * @info: The parameter struct.
+ */
+void free_aliases(info_t *info)
+{
+	hash_free(&info->aliases, free); // hash_free from linked_lists/hash_table.c
+}
@@ -0,0 +1,578 @@
+#include "../includes/shell.h"
+
+/*
+ * Operator codes of compiled arithmetic expressions (arith_t.op).
+ * Binary operators start at A_MUL so that 0 can mean "plain assignment"
+ * in the num field of an A_ASSIGN node.
+ */
+#define A_NUM     0
+#define A_VAR     1
+#define A_ASSIGN  2
+#define A_PREINC  3
+#define A_PREDEC  4
+#define A_POSTINC 5
+#define A_POSTDEC 6
+#define A_NEG     7
+#define A_NOT     8
+#define A_BNOT    9
+#define A_COND    10
+#define A_COMMA   11
+#define A_PARAM   12 // $1..$9 (num is the index), $# (num is 0)
+#define A_MUL     20
+#define A_DIV     21
+#define A_MOD     22
+#define A_ADD     23
+#define A_SUB     24
+#define A_SHL     25
+#define A_SHR     26
+#define A_LT      27
+#define A_LE      28
+#define A_GT      29
+#define A_GE      30
+#define A_EQ      31
+#define A_NE      32
+#define A_BAND    33
+#define A_XOR     34
+#define A_BOR     35
+#define A_LAND    36
+#define A_LOR     37
+
+/*
+ * Binary operators with their precedence (higher binds tighter).
+ * Two-character operators come first so they win over their prefixes.
+ */
+static const struct binop
+{
+	char *s;
+	int len;
+	int prec;
+	int op;
+} binops[] = {
+	{"||", 2, 1, A_LOR}, {"&&", 2, 2, A_LAND}, {"==", 2, 6, A_EQ},
+	{"!=", 2, 6, A_NE}, {"<=", 2, 7, A_LE}, {">=", 2, 7, A_GE},
+	{"<<", 2, 8, A_SHL}, {">>", 2, 8, A_SHR}, {"<", 1, 7, A_LT},
+	{">", 1, 7, A_GT}, {"|", 1, 3, A_BOR}, {"^", 1, 4, A_XOR},
+	{"&", 1, 5, A_BAND}, {"+", 1, 9, A_ADD}, {"-", 1, 9, A_SUB},
+	{"*", 1, 10, A_MUL}, {"/", 1, 10, A_DIV}, {"%", 1, 10, A_MOD},
+	{NULL, 0, 0, 0}
+};
+
+static arith_t *parse_comma(info_t *info, char **s);
+static arith_t *parse_assign(info_t *info, char **s);
+
+/**
+ * arith_error - Prints an arithmetic error to stderr.
+ * Format: "shell_name: line_count: arithmetic expression: msg: "expr"\n"
+ * @info: The parameter struct.
+ * @msg: The error message.
+ * @expr: The expression text, or NULL.
+ */
+static void arith_error(info_t *info, char *msg, char *expr)
+{
+	if (info->syntax_quiet)
+		return;
+	if (expr) // error_line from error_handling/error_utilities.c
+		error_line(info, "arithmetic expression: ", msg, ": \"", expr, "\"", NULL);
+	else
+		error_line(info, "arithmetic expression: ", msg, NULL);
+}
+
+/**
+ * skip_blanks - Advances the cursor over blanks and newlines.
+ * @s: The cursor.
+ */
+static void skip_blanks(char **s)
+{
+	while (**s == ' ' || **s == '\t' || **s == '\n')
+		(*s)++;
+}
+
+/**
+ * name_end - Finds the end of a variable name.
+ * @p: Start of the name.
+ * Return: Pointer past the name (p itself if there is no name).
+ */
+static char *name_end(char *p)
+{
+	if (!is_alpha_char(*p) && *p != '_')
+		return (p);
+	while (is_alpha_char(*p) || *p == '_' || (*p >= '0' && *p <= '9'))
+		p++;
+	return (p);
+}
+
+/**
+ * new_arith - Allocates an expression node from the parse arena.
+ * @info: The parameter struct.
+ * @op: The operator code.
+ * @a: First operand.
+ * @b: Second operand.
+ * Return: The node, or NULL on allocation failure.
+ */
+static arith_t *new_arith(info_t *info, int op, arith_t *a, arith_t *b)
+{
+	arith_t *e = arena_alloc(&info->parse, sizeof(arith_t));
+
+	if (!e)
+		return (NULL);
+	_memset((char *)e, 0, sizeof(arith_t));
+	e->op = op;
+	e->kid[0] = a;
+	e->kid[1] = b;
+	return (e);
+}
+
+/**
+ * new_var - Allocates a node that refers to the variable named at p.
+ * The name is copied once here; evaluation looks it up with var_get().
+ * @info: The parameter struct.
+ * @op: The operator code.
+ * @p: Start of the name.
+ * @end: End of the name.
+ * Return: The node, or NULL on allocation failure.
+ */
+static arith_t *new_var(info_t *info, int op, char *p, char *end)
+{
+	arith_t *e = new_arith(info, op, NULL, NULL);
+
+	if (!e)
+		return (NULL);
+	e->name = arena_strndup(&info->parse, p, end - p);
+	return (e->name ? e : NULL);
+}
+
+/**
+ * parse_primary - Parses a number, a variable (with optional postfix
+ * ++ or --), a positional parameter or a parenthesized expression.
+ * @info: The parameter struct.
+ * @s: The cursor.
+ * Return: The node, or NULL on a syntax error.
+ */
+static arith_t *parse_primary(info_t *info, char **s)
+{
+	arith_t *e;
+	char *end;
+	long n;
+
+	skip_blanks(s);
+	if (**s == '(')
+	{
+		(*s)++;
+		e = parse_comma(info, s);
+		skip_blanks(s);
+		if (!e || **s != ')')
+			return (NULL);
+		(*s)++;
+		return (e);
+	}
+	if (**s >= '0' && **s <= '9')
+	{
+		n = strtol(*s, &end, 0);
+		*s = end;
+		e = new_arith(info, A_NUM, NULL, NULL);
+		if (e)
+			e->num = n;
+		return (e);
+	}
+	if (**s == '$' && ((*s)[1] == '#' || ((*s)[1] >= '1' && (*s)[1] <= '9')))
+	{
+		e = new_arith(info, A_PARAM, NULL, NULL);
+		if (e)
+			e->num = (*s)[1] == '#' ? 0 : (*s)[1] - '0';
+		*s += 2;
+		return (e);
+	}
+	if (**s == '$') // $name means the same as name here
+		(*s)++;
+	end = name_end(*s);
+	if (end == *s)
+		return (NULL);
+	e = new_var(info, A_VAR, *s, end);
+	*s = end;
+	skip_blanks(s);
+	if (e && ((*s)[0] == '+' || (*s)[0] == '-') && (*s)[1] == (*s)[0])
+	{
+		e->op = **s == '+' ? A_POSTINC : A_POSTDEC;
+		*s += 2;
+	}
+	return (e);
+}
+
+/**
+ * parse_unary - Parses prefix operators: - + ! ~ ++ --
+ * @info: The parameter struct.
+ * @s: The cursor.
+ * Return: The node, or NULL on a syntax error.
+ */
+static arith_t *parse_unary(info_t *info, char **s)
+{
+	char c, *end;
+	arith_t *a;
+
+	skip_blanks(s);
+	c = **s;
+	if ((c == '+' || c == '-') && (*s)[1] == c) // Pre-increment/decrement
+	{
+		*s += 2;
+		skip_blanks(s);
+		end = name_end(*s);
+		if (end == *s)
+			return (NULL);
+		a = new_var(info, c == '+' ? A_PREINC : A_PREDEC, *s, end);
+		*s = end;
+		return (a);
+	}
+	if (c != '-' && c != '+' && c != '!' && c != '~')
+		return (parse_primary(info, s));
+	(*s)++;
+	a = parse_unary(info, s);
+	if (!a || c == '+')
+		return (a);
+	return (new_arith(info, c == '-' ? A_NEG : c == '!' ? A_NOT : A_BNOT, a, NULL));
+}
+
+/**
+ * match_binop - Finds the binary operator at p.
+ * A single-character operator followed by '=' is a compound assignment
+ * and is not matched.
+ * @p: The text.
+ * Return: The operator's table entry, or NULL.
+ */
+static const struct binop *match_binop(char *p)
+{
+	int i;
+
+	for (i = 0; binops[i].s; i++)
+		if (!strncmp(p, binops[i].s, binops[i].len))
+		{
+			if (p[binops[i].len] == '=' && (binops[i].len == 1
+				|| binops[i].op == A_SHL || binops[i].op == A_SHR))
+				return (NULL);
+			return (&binops[i]);
+		}
+	return (NULL);
+}
+
+/**
+ * parse_binary - Parses binary operators by precedence climbing.
+ * @info: The parameter struct.
+ * @s: The cursor.
+ * @min_prec: Lowest precedence this call may consume.
+ * Return: The node, or NULL on a syntax error.
+ */
+static arith_t *parse_binary(info_t *info, char **s, int min_prec)
+{
+	arith_t *lhs = parse_unary(info, s), *rhs;
+	const struct binop *b;
+
+	while (lhs)
+	{
+		skip_blanks(s);
+		b = match_binop(*s);
+		if (!b || b->prec < min_prec)
+			break;
+		*s += b->len;
+		rhs = parse_binary(info, s, b->prec + 1);
+		if (!rhs)
+			return (NULL);
+		lhs = new_arith(info, b->op, lhs, rhs);
+	}
+	return (lhs);
+}
+
+/**
+ * parse_cond - Parses cond ? expr : expr
+ * @info: The parameter struct.
+ * @s: The cursor.
+ * Return: The node, or NULL on a syntax error.
+ */
+static arith_t *parse_cond(info_t *info, char **s)
+{
+	arith_t *e = parse_binary(info, s, 1), *a, *b;
+
+	skip_blanks(s);
+	if (!e || **s != '?')
+		return (e);
+	(*s)++;
+	a = parse_assign(info, s);
+	skip_blanks(s);
+	if (!a || **s != ':')
+		return (NULL);
+	(*s)++;
+	b = parse_cond(info, s);
+	e = b ? new_arith(info, A_COND, e, a) : NULL;
+	if (e)
+		e->kid[2] = b;
+	return (e);
+}
+
+/**
+ * parse_assign - Parses name = expr and the compound assignments
+ * (+= -= *= /= %= <<= >>= &= ^= |=), which group to the right.
+ * @info: The parameter struct.
+ * @s: The cursor.
+ * Return: The node, or NULL on a syntax error.
+ */
+static arith_t *parse_assign(info_t *info, char **s)
+{
+	char *name, *end, *q;
+	const struct binop *b = NULL;
+	arith_t *e, *rhs;
+	int len = 0, i;
+
+	skip_blanks(s);
+	name = **s == '$' ? *s + 1 : *s;
+	end = name_end(name);
+	q = end;
+	skip_blanks(&q);
+	if (end != name && q[0] == '=' && q[1] != '=')
+		len = 1;
+	else if (end != name && q[0] && _strchr("+-*/%&^|", q[0]) && q[1] == '=')
+		len = 2;
+	else if (end != name && (q[0] == '<' || q[0] == '>') && q[1] == q[0] && q[2] == '=')
+		len = 3;
+	if (!len)
+		return (parse_cond(info, s));
+	for (i = 0; len > 1 && binops[i].s && !b; i++) // The operator it applies
+		if (binops[i].len == len - 1 && !strncmp(q, binops[i].s, len - 1))
+			b = &binops[i];
+	*s = q + len;
+	rhs = parse_assign(info, s);
+	e = rhs ? new_var(info, A_ASSIGN, name, end) : NULL;
+	if (e)
+	{
+		e->kid[0] = rhs;
+		e->num = b ? b->op : 0;
+	}
+	return (e);
+}
+
+/**
+ * parse_comma - Parses expr , expr ...
+ * @info: The parameter struct.
+ * @s: The cursor.
+ * Return: The node, or NULL on a syntax error.
+ */
+static arith_t *parse_comma(info_t *info, char **s)
+{
+	arith_t *e = parse_assign(info, s), *rhs;
+
+	skip_blanks(s);
+	while (e && **s == ',')
+	{
+		(*s)++;
+		rhs = parse_assign(info, s);
+		e = rhs ? new_arith(info, A_COMMA, e, rhs) : NULL;
+		skip_blanks(s);
+	}
+	return (e);
+}
+
+/**
+ * arith_parse - Compiles an arithmetic expression into a tree allocated
+ * from the parse arena, so it is parsed once however often it runs.
+ * @info: The parameter struct.
+ * @expr: The expression text.
+ * Return: The compiled expression, or NULL if it is empty or invalid
+ * (info->parse_err is PARSE_ERROR in the latter case).
+ */
+arith_t *arith_parse(info_t *info, char *expr)
+{
+	char *s = expr;
+	arith_t *e;
+
+	skip_blanks(&s);
+	if (!*s)
+		return (NULL);
+	e = parse_comma(info, &s);
+	skip_blanks(&s);
+	if (!e || *s)
+	{
+		info->parse_err = PARSE_ERROR;
+		info->status = 2;
+		arith_error(info, "syntax error", expr);
+		return (NULL);
+	}
+	return (e);
+}
+
+/**
+ * get_var - Reads a variable as a number (unset or empty is 0).
+ * @info: The parameter struct.
+ * @e: The variable's node.
+ * Return: The value.
+ */
+static long get_var(info_t *info, arith_t *e)
+{
+	char *v = var_get(info, e->name); // var_get from variables/shell_variables.c
+
+	return (v ? strtol(v, NULL, 0) : 0);
+}
+
+/**
+ * set_var - Stores a number in a variable.
+ * @info: The parameter struct.
+ * @e: The variable's node.
+ * @v: The value.
+ * Return: v.
+ */
+static long set_var(info_t *info, arith_t *e, long v)
+{
+	char num[NUM_BUF_SIZE];
+
+	fmt_signed(v, num); // fmt_signed in memory_utils/string_converters.c
+	var_set(info, e->name, num);
+	return (v);
+}
+
+/**
+ * binary - Applies a binary operator. Arithmetic wraps around instead
+ * of overflowing.
+ * @op: The operator code.
+ * @a: Left operand.
+ * @b: Right operand.
+ * @err: Set to 1 on division by zero.
+ * Return: The result.
+ */
+static long binary(int op, long a, long b, int *err)
+{
+	switch (op)
+	{
+	case A_MUL:
+		return ((long)((unsigned long)a * (unsigned long)b));
+	case A_DIV:
+	case A_MOD:
+		if (!b)
+		{
+			*err = 1;
+			return (0);
+		}
+		if (b == -1) // LONG_MIN / -1 would trap
+			return (op == A_DIV ? (long)(0UL - (unsigned long)a) : 0);
+		return (op == A_DIV ? a / b : a % b);
+	case A_ADD:
+		return ((long)((unsigned long)a + (unsigned long)b));
+	case A_SUB:
+		return ((long)((unsigned long)a - (unsigned long)b));
+	case A_SHL:
+		return ((long)((unsigned long)a << (b & 63)));
+	case A_SHR:
+		return (a >> (b & 63));
+	case A_LT:
+		return (a < b);
+	case A_LE:
+		return (a <= b);
+	case A_GT:
+		return (a > b);
+	case A_GE:
+		return (a >= b);
+	case A_EQ:
+		return (a == b);
+	case A_NE:
+		return (a != b);
+	case A_BAND:
+		return (a & b);
+	case A_XOR:
+		return (a ^ b);
+	default:
+		return (a | b);
+	}
+}
+
+/**
+ * eval - Evaluates a compiled expression.
+ * @info: The parameter struct.
+ * @e: The expression.
+ * @err: Set to 1 on an error.
+ * Return: The value.
+ */
+static long eval(info_t *info, arith_t *e, int *err)
+{
+	long a;
+
+	switch (e->op)
+	{
+	case A_NUM:
+		return (e->num);
+	case A_VAR:
+		return (get_var(info, e));
+	case A_PARAM:
+		if (!e->num)
+			return (info->nparams);
+		return (e->num <= info->nparams ? strtol(info->params[e->num - 1], NULL, 0) : 0);
+	case A_PREINC:
+	case A_PREDEC:
+		return (set_var(info, e, get_var(info, e) + (e->op == A_PREINC ? 1 : -1)));
+	case A_POSTINC:
+	case A_POSTDEC:
+		a = get_var(info, e);
+		set_var(info, e, a + (e->op == A_POSTINC ? 1 : -1));
+		return (a);
+	case A_NEG:
+		return ((long)(0UL - (unsigned long)eval(info, e->kid[0], err)));
+	case A_NOT:
+		return (!eval(info, e->kid[0], err));
+	case A_BNOT:
+		return (~eval(info, e->kid[0], err));
+	case A_COND:
+		return (eval(info, e->kid[eval(info, e->kid[0], err) ? 1 : 2], err));
+	case A_COMMA:
+		eval(info, e->kid[0], err);
+		return (eval(info, e->kid[1], err));
+	case A_LAND:
+		return (eval(info, e->kid[0], err) && eval(info, e->kid[1], err));
+	case A_LOR:
+		return (eval(info, e->kid[0], err) || eval(info, e->kid[1], err));
+	case A_ASSIGN:
+		a = eval(info, e->kid[0], err);
+		if (e->num)
+			a = binary(e->num, get_var(info, e), a, err);
+		return (*err ? 0 : set_var(info, e, a));
+	}
+	a = eval(info, e->kid[0], err);
+	return (binary(e->op, a, eval(info, e->kid[1], err), err));
+}
+
+/**
+ * arith_run - Evaluates a compiled arithmetic expression.
+ * @info: The parameter struct.
+ * @e: The expression (NULL, an empty expression, is 0).
+ * @result: Receives the value.
+ * Return: 0 on success, -1 on an error (reported, status set to 2).
+ */
+int arith_run(info_t *info, arith_t *e, long *result)
+{
+	int err = 0;
+
+	*result = e ? eval(info, e, &err) : 0;
+	if (!err)
+		return (0);
+	arith_error(info, "division by zero", NULL);
+	info->status = 2;
+	return (-1);
+}
+
+/**
+ * arith_eval - Compiles and evaluates expression text only known at run
+ * time, such as an array subscript. The tree goes to the scratch arena:
+ * the parse arena holds the command that is running.
+ * @info: The parameter struct.
+ * @expr: The expression text.
+ * @result: Receives the value.
+ * Return: 0 on success, -1 on an error (reported, status set to 2).
+ */
+int arith_eval(info_t *info, char *expr, long *result)
+{
+	arena_t parse = info->parse;
+	int err = info->parse_err, r;
+	arith_t *e;
+
+	info->parse = info->scratch;
+	info->parse_err = PARSE_OK;
+	e = arith_parse(info, expr);
+	r = info->parse_err == PARSE_OK ? arith_run(info, e, result) : -1;
+	info->scratch = info->parse;
+	info->parse = parse;
+	info->parse_err = err;
+	return (r);
+}
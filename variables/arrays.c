@@ -0,0 +1,305 @@
+#include "../includes/shell.h"
+
+/**
+ * array_new - Allocates an empty array.
+ * @assoc: Non-zero for an associative array.
+ * Return: The array, or NULL on allocation failure.
+ */
+array_t *array_new(int assoc)
+{
+	array_t *a = malloc(sizeof(array_t));
+
+	if (!a)
+		return (NULL);
+	_memset((char *)a, 0, sizeof(array_t));
+	a->assoc = assoc;
+	return (a);
+}
+
+/**
+ * array_clear - Removes every element, keeping the allocations.
+ * @a: The array.
+ */
+void array_clear(array_t *a)
+{
+	size_t i;
+
+	for (i = 0; i < a->n; i++)
+	{
+		free(a->vals[i]);
+		a->vals[i] = NULL;
+		if (a->keys)
+		{
+			free(a->keys[i]);
+			a->keys[i] = NULL;
+		}
+	}
+	if (a->slots)
+		_memset((char *)a->slots, 0, sizeof(size_t) * a->nslots);
+	a->n = a->count = 0;
+}
+
+/**
+ * array_free - Frees an array and its elements.
+ * @a: The array (may be NULL).
+ */
+void array_free(array_t *a)
+{
+	if (!a)
+		return;
+	array_clear(a);
+	free(a->vals);
+	free(a->keys);
+	free(a->slots);
+	free(a);
+}
+
+/**
+ * array_grow - Makes room for at least n slots; new slots are unset.
+ * @a: The array.
+ * @n: Slots needed.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int array_grow(array_t *a, size_t n)
+{
+	size_t cap = a->cap ? a->cap : 8;
+	char **p;
+
+	if (n <= a->cap)
+		return (0);
+	while (cap < n)
+		cap *= 2;
+	if (cap > ((size_t)-1) / sizeof(char *))
+		return (-1);
+	p = _realloc(a->vals, a->cap * sizeof(char *), cap * sizeof(char *));
+	if (!p)
+		return (-1);
+	a->vals = p;
+	_memset((char *)(p + a->cap), 0, (cap - a->cap) * sizeof(char *));
+	if (a->assoc)
+	{
+		p = _realloc(a->keys, a->cap * sizeof(char *), cap * sizeof(char *));
+		if (!p)
+			return (-1);
+		a->keys = p;
+		_memset((char *)(p + a->cap), 0, (cap - a->cap) * sizeof(char *));
+	}
+	a->cap = cap;
+	return (0);
+}
+
+/**
+ * key_hash - Hashes a key (FNV-1a, as in hash_string()).
+ * @key: The key (not NUL-terminated).
+ * @len: Length of the key.
+ * Return: The hash value.
+ */
+static unsigned long key_hash(const char *key, size_t len)
+{
+	unsigned long h = 14695981039346656037UL;
+
+	while (len--)
+	{
+		h ^= (unsigned char)*key++;
+		h *= 1099511628211UL;
+	}
+	return (h);
+}
+
+/**
+ * find_slot - Probes the index of an associative array for a key.
+ * Deleted entries keep their slot until the next rehash, so probing walks
+ * over them; a key set again after a delete gets a new entry at the end.
+ * @a: The array; its index must exist.
+ * @key: The key (not NUL-terminated).
+ * @len: Length of the key.
+ * Return: The key's slot, or the empty slot where it would go.
+ */
+static size_t *find_slot(array_t *a, const char *key, size_t len)
+{
+	size_t mask = a->nslots - 1, i = key_hash(key, len) & mask, e;
+
+	for (;; i = (i + 1) & mask)
+	{
+		e = a->slots[i];
+		if (!e || (a->vals[e - 1] && !strncmp(a->keys[e - 1], key, len)
+			&& !a->keys[e - 1][len]))
+			return (&a->slots[i]);
+	}
+}
+
+/**
+ * rehash - Drops deleted entries (keeping the order of the others) and
+ * rebuilds the index with room for growth.
+ * @a: An associative array.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int rehash(array_t *a)
+{
+	size_t i, j, nslots = 16, *slots;
+
+	while (nslots < a->count * 4)
+		nslots *= 2;
+	slots = malloc(sizeof(size_t) * nslots);
+	if (!slots)
+		return (-1);
+	for (i = j = 0; i < a->n; i++)
+		if (a->vals[i])
+		{
+			a->vals[j] = a->vals[i];
+			a->keys[j++] = a->keys[i];
+		}
+		else
+			free(a->keys[i]);
+	for (i = j; i < a->n; i++)
+		a->vals[i] = a->keys[i] = NULL;
+	a->n = j;
+	free(a->slots);
+	a->slots = slots;
+	a->nslots = nslots;
+	_memset((char *)slots, 0, sizeof(size_t) * nslots);
+	for (i = 0; i < a->n; i++)
+		*find_slot(a, a->keys[i], _strlen(a->keys[i])) = i + 1;
+	return (0);
+}
+
+/**
+ * array_at - Finds an element of an indexed array.
+ * @a: The array.
+ * @i: The index; a negative one counts back from the end.
+ * Return: The value, or NULL if the element is not set.
+ */
+char *array_at(array_t *a, long i)
+{
+	if (i < 0)
+		i += a->n;
+	if (i < 0 || (size_t)i >= a->n)
+		return (NULL);
+	return (a->vals[i]);
+}
+
+/**
+ * array_find - Finds an element of an associative array in one probe
+ * sequence of its open-addressing index.
+ * @a: The array.
+ * @key: The key (not NUL-terminated).
+ * @len: Length of the key.
+ * Return: The value, or NULL if the element is not set.
+ */
+char *array_find(array_t *a, const char *key, size_t len)
+{
+	size_t e;
+
+	if (!a->count)
+		return (NULL);
+	e = *find_slot(a, key, len);
+	return (e ? a->vals[e - 1] : NULL);
+}
+
+/**
+ * elem_slot - Finds the value slot of an element, adding the element.
+ * @a: The array.
+ * @i: The index, for an indexed array.
+ * @key: The key, for an associative array.
+ * Return: The slot, or NULL on allocation failure or a bad index.
+ */
+static char **elem_slot(array_t *a, long i, const char *key)
+{
+	size_t len, *slot;
+
+	if (!a->assoc)
+	{
+		if (i < 0)
+			i += a->n;
+		if (i < 0 || array_grow(a, (size_t)i + 1))
+			return (NULL);
+		if ((size_t)i >= a->n)
+			a->n = i + 1;
+		return (&a->vals[i]);
+	}
+	len = _strlen((char *)key);
+	if ((a->n + 1) * 4 > a->nslots * 3 && rehash(a)) // Keep probe runs short
+		return (NULL);
+	slot = find_slot(a, key, len);
+	if (*slot)
+		return (&a->vals[*slot - 1]);
+	if (array_grow(a, a->n + 1))
+		return (NULL);
+	a->keys[a->n] = _strdup((char *)key);
+	if (!a->keys[a->n])
+		return (NULL);
+	*slot = ++a->n;
+	return (&a->vals[a->n - 1]);
+}
+
+/**
+ * array_set - Sets (or appends to) an element.
+ * @a: The array.
+ * @i: The index, for an indexed array (negative counts from the end).
+ * @key: The key, for an associative array.
+ * @val: The value (not NUL-terminated).
+ * @len: Length of the value.
+ * @append: Append to the current value instead of replacing it (+=).
+ * Return: 0 on success, -1 on allocation failure or a bad index.
+ */
+int array_set(array_t *a, long i, const char *key, const char *val, size_t len,
+	int append)
+{
+	char **slot = elem_slot(a, i, key), *p;
+	size_t old;
+
+	if (!slot)
+		return (-1);
+	old = append && *slot ? (size_t)_strlen(*slot) : 0;
+	p = malloc(old + len + 1);
+	if (!p)
+		return (-1);
+	memcpy(p, *slot ? *slot : "", old);
+	memcpy(p + old, val, len);
+	p[old + len] = '\0';
+	a->count += !*slot;
+	free(*slot);
+	*slot = p;
+	return (0);
+}
+
+/**
+ * array_push - Appends an element after the last index of an indexed array.
+ * @a: The array.
+ * @val: The value (not NUL-terminated).
+ * @len: Length of the value.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+int array_push(array_t *a, const char *val, size_t len)
+{
+	return (array_set(a, a->n, NULL, val, len, 0));
+}
+
+/**
+ * array_unset - Unsets an element. An associative entry stays in place,
+ * without a value, until the next rehash drops it.
+ * @a: The array.
+ * @i: The index, for an indexed array.
+ * @key: The key, for an associative array.
+ */
+void array_unset(array_t *a, long i, const char *key)
+{
+	char **slot = NULL;
+	size_t e;
+
+	if (!a->assoc)
+	{
+		i += i < 0 ? (long)a->n : 0;
+		if (i >= 0 && (size_t)i < a->n)
+			slot = &a->vals[i];
+	}
+	else if (a->count && (e = *find_slot(a, key, _strlen((char *)key))))
+		slot = &a->vals[e - 1];
+	if (!slot || !*slot)
+		return;
+	free(*slot);
+	*slot = NULL;
+	a->count--;
+	while (!a->assoc && a->n && !a->vals[a->n - 1])
+		a->n--;
+}
@@ -1,69 +1,58 @@
 #include "../includes/shell.h"
 
 /**
- * is_chain - Tests if the current character in the buffer is a chain delimiter (;, &&, ||).
+ * eval_list - Evaluates a list of commands separated by ';', '&' or newlines.
+ * Every command runs regardless of the status of the one before it.
  * @info: The parameter struct.
- * @buf: The character buffer holding the command line.
- * @p: Address of the current position in buf.
- * Return: 1 if it's a chain delimiter, 0 otherwise.
+ * @node: The first NODE_SEQ node of the list.
+ * Return: The status of the last command run.
  */
-int is_chain(info_t *info, char *buf, size_t *p)
+int eval_list(info_t *info, node_t *node)
 {
-	size_t j = *p;
+	for (; node && info->ctl == CTL_NONE; node = node->kid[1])
+		eval_node(info, node->kid[0]);
+	return (info->status);
+}
 
-	if (buf[j] == '|' && buf[j + 1] == '|') // Logical OR
-	{
-		buf[j] = 0; // Null-terminate current command
-		j++;
-		info->cmd_buf_type = CMD_OR;
-	}
-	else if (buf[j] == '&' && buf[j + 1] == '&') // Logical AND
-	{
-		buf[j] = 0; // Null-terminate current command
-		j++;
-		info->cmd_buf_type = CMD_AND;
-	}
-	else if (buf[j] == ';') /* Found end of this command */
-	{
-		buf[j] = 0; /* Replace semicolon with null */
-		info->cmd_buf_type = CMD_CHAIN;
-	}
-	else
-		return (0); // Not a chain delimiter
-	*p = j; // Update buffer position to after the delimiter
-	return (1);
+/**
+ * eval_and_or - Evaluates '&&' (run the right side if the left succeeded)
+ * and '||' (run the right side if the left failed).
+ * @info: The parameter struct containing the last command's status.
+ * @node: A NODE_AND or NODE_OR node.
+ * Return: The status of the last command run.
+ */
+int eval_and_or(info_t *info, node_t *node)
+{
+	eval_node(info, node->kid[0]);
+	if (info->ctl != CTL_NONE)
+		return (info->status);
+	if ((node->type == NODE_AND) == (info->status == 0))
+		eval_node(info, node->kid[1]);
+	return (info->status);
 }
 
 /**
- * check_chain - Checks if command chaining should continue based on the last command's status.
- * Used for '&&' (execute next if previous succeeded) and '||' (execute next if previous failed).
- * @info: The parameter struct containing the last command's status and chain type.
- * @buf: The command line character buffer.
- * @p: Address of current position in buf.
- * @i: Starting position in buf (usually the beginning of the current command).
- * @len: Total length of buf.
- * Return: Void.
+ * eval_background - Runs a command asynchronously ('cmd &').
+ * The shell does not wait; finished jobs are reaped by the main loop.
+ * @info: The parameter struct.
+ * @node: A NODE_BG node.
+ * Return: 0, or 1 if the fork failed.
  */
-void check_chain(info_t *info, char *buf, size_t *p, size_t i, size_t len)
+int eval_background(info_t *info, node_t *node)
 {
-	size_t j = *p; // Current position in the buffer
+	pid_t pid;
 
-	if (info->cmd_buf_type == CMD_AND) // If previous was '&&'
+	flush_output();
+	pid = fork();
+	if (pid == -1)
 	{
-		if (info->status) // And previous command failed
-		{
-			buf[i] = 0; // Nullify the current command (effectively skip it)
-			j = len;    // Advance pointer to end of buffer to stop processing chain
-		}
+		perror("Error:");
+		return (info->status = 1);
 	}
-	if (info->cmd_buf_type == CMD_OR) // If previous was '||'
+	if (pid == 0)
 	{
-		if (!info->status) // And previous command succeeded
-		{
-			buf[i] = 0; // Nullify the current command (effectively skip it)
-			j = len;    // Advance pointer to end of buffer to stop processing chain
-		}
+		eval_node(info, node->kid[0]);
+		child_exit(info); // child_exit from shell_core/command_executor.c
 	}
-
-	*p = j; // Update the buffer position
+	return (info->status = 0);
 }
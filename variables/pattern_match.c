@@ -0,0 +1,210 @@
+#include "../includes/shell.h"
+#include <ctype.h>
+
+/**
+ * set_class - Adds the characters of a [:name:] class to a bracket set.
+ * @op: The bracket operation.
+ * @name: The class name (not NUL-terminated).
+ * @len: Length of the name.
+ * Return: 1 if the class is known, 0 otherwise.
+ */
+static int set_class(pat_op_t *op, const char *name, size_t len)
+{
+	static const char * const names[] = {"alnum", "alpha", "blank", "digit",
+		"lower", "punct", "space", "upper", "xdigit", NULL};
+	static int (* const tests[])(int) = {isalnum, isalpha, isblank, isdigit,
+		islower, ispunct, isspace, isupper, isxdigit};
+	int i, c;
+
+	for (i = 0; names[i]; i++)
+		if (_strlen((char *)names[i]) == (int)len && !strncmp(names[i], name, len))
+		{
+			for (c = 1; c < 256; c++)
+				if (tests[i](c))
+					op->set[c >> 3] |= 1 << (c & 7);
+			return (1);
+		}
+	return (0);
+}
+
+/**
+ * compile_bracket - Compiles a [...] expression into a 256-bit set.
+ * @op: The operation to fill.
+ * @p: Points just past the '['.
+ * Return: Pointer past the closing ']', or NULL if there is none (the '['
+ * is then an ordinary character).
+ */
+static char *compile_bracket(pat_op_t *op, char *p)
+{
+	unsigned char lo, hi;
+	char *e;
+	int first = 1;
+
+	op->type = PAT_SET;
+	op->negate = (*p == '!' || *p == '^');
+	p += op->negate;
+	_memset((char *)op->set, 0, sizeof(op->set));
+	for (; *p && (*p != ']' || first); first = 0)
+	{
+		if (p[0] == '[' && p[1] == ':' && (e = _strchr(p + 2, ':')) && e[1] == ']'
+			&& set_class(op, p + 2, e - p - 2))
+		{
+			p = e + 2;
+			continue;
+		}
+		p += (*p == '\\' && p[1]);
+		lo = hi = *p++;
+		if (*p == '-' && p[1] && p[1] != ']')
+		{
+			p += 1 + (p[1] == '\\' && p[2]);
+			hi = *p++;
+		}
+		for (; lo && lo <= hi; lo++)
+		{
+			op->set[lo >> 3] |= 1 << (lo & 7);
+			if (lo == 255)
+				break;
+		}
+	}
+	return (*p == ']' ? p + 1 : NULL);
+}
+
+/**
+ * pattern_compile - Compiles a glob pattern (*, ?, [...] and \ escapes)
+ * into a vector of operations.
+ * @pat: The pattern.
+ * Return: The malloc'd compiled pattern, or NULL on allocation failure.
+ */
+static pattern_t *pattern_compile(char *pat)
+{
+	pattern_t *p = malloc(sizeof(pattern_t) + sizeof(pat_op_t) * (_strlen(pat) + 1));
+	pat_op_t *op;
+	char *next;
+
+	if (!p)
+		return (NULL);
+	p->n = p->minlen = 0;
+	p->star = 0;
+	while (*pat)
+	{
+		op = &p->ops[p->n++];
+		if (*pat == '*')
+		{
+			op->type = PAT_STAR;
+			p->star = 1;
+			while (*pat == '*') // Runs of stars match like one
+				pat++;
+			continue;
+		}
+		p->minlen++;
+		if (*pat == '?')
+			op->type = PAT_ANY;
+		else if (*pat == '[' && (next = compile_bracket(op, pat + 1)))
+		{
+			pat = next;
+			continue;
+		}
+		else
+		{
+			op->type = PAT_CHAR;
+			pat += (*pat == '\\' && pat[1]);
+			op->c = *pat;
+		}
+		pat++;
+	}
+	return (p);
+}
+
+/**
+ * pattern_get - Returns the compiled form of a pattern. Compiled patterns
+ * are kept in a table, so a pattern used on every iteration of a loop is
+ * compiled only once.
+ * @info: The parameter struct.
+ * @pat: The pattern.
+ * Return: The compiled pattern, or NULL on allocation failure.
+ */
+pattern_t *pattern_get(info_t *info, char *pat)
+{
+	hash_entry_t *e = hash_find(&info->patterns, pat); // hash_find from linked_lists/hash_table.c
+	pattern_t *p;
+
+	if (e)
+		return (e->value);
+	if (info->patterns.count >= PATTERN_CACHE_MAX) // Start over rather than grow forever
+		free_patterns(info);
+	p = pattern_compile(pat);
+	e = p ? hash_insert(&info->patterns, pat) : NULL;
+	if (!e)
+	{
+		free(p);
+		return (NULL);
+	}
+	e->value = p;
+	return (p);
+}
+
+/**
+ * op_matches - Checks one character against a non-star operation.
+ * @op: The operation.
+ * @c: The character.
+ * Return: 1 if it matches, 0 otherwise.
+ */
+static int op_matches(pat_op_t *op, unsigned char c)
+{
+	if (op->type == PAT_ANY)
+		return (1);
+	if (op->type == PAT_CHAR)
+		return (op->c == c);
+	return (((op->set[c >> 3] >> (c & 7)) & 1) != op->negate);
+}
+
+/**
+ * pattern_match - Checks whether a whole string matches a compiled pattern.
+ * A star that fails to match is retried one character further along, so
+ * the match never backtracks more than one star deep.
+ * @p: The compiled pattern.
+ * @s: The string (need not be NUL-terminated).
+ * @len: Length of the string.
+ * Return: 1 if it matches, 0 otherwise.
+ */
+int pattern_match(pattern_t *p, const char *s, size_t len)
+{
+	size_t pi = 0, si = 0, star = 0, mark = 0;
+	int starred = 0;
+
+	if (len < p->minlen || (!p->star && len != p->minlen))
+		return (0);
+	while (si < len)
+	{
+		if (pi < p->n && p->ops[pi].type == PAT_STAR)
+		{
+			starred = 1;
+			star = ++pi;
+			mark = si;
+		}
+		else if (pi < p->n && op_matches(&p->ops[pi], s[si]))
+		{
+			pi++;
+			si++;
+		}
+		else if (starred)
+		{
+			pi = star;
+			si = ++mark;
+		}
+		else
+			return (0);
+	}
+	while (pi < p->n && p->ops[pi].type == PAT_STAR)
+		pi++;
+	return (pi == p->n);
+}
+
+/**
+ * free_patterns - Frees every compiled pattern.
+ * @info: The parameter struct.
+ */
+void free_patterns(info_t *info)
+{
+	hash_free(&info->patterns, free);
+}
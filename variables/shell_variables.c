@@ -0,0 +1,568 @@
+#include "../includes/shell.h"
+
+/**
+ * free_var - Frees a var_t (the value callback of info->vars).
+ * @p: The var_t.
+ */
+static void free_var(void *p)
+{
+	var_t *v = p;
+
+	if (v)
+	{
+		free(v->value);
+		array_free(v->arr); // array_free from variables/arrays.c
+	}
+	free(v);
+}
+
+/**
+ * add_var - Adds an unset variable to the table.
+ * @info: The parameter struct.
+ * @name: The name.
+ * @flags: Its VAR_* attributes.
+ * Return: The new variable, or NULL on allocation failure.
+ */
+static var_t *add_var(info_t *info, char *name, int flags)
+{
+	var_t *v = malloc(sizeof(var_t));
+	hash_entry_t *e = v ? hash_insert(&info->vars, name) : NULL; // hash_insert from linked_lists/hash_table.c
+
+	if (!e)
+	{
+		free(v);
+		return (NULL);
+	}
+	v->value = NULL;
+	v->cap = 0;
+	v->flags = flags;
+	v->arr = NULL;
+	e->value = v;
+	return (v);
+}
+
+/**
+ * var_find - Looks up a variable's table entry.
+ * @info: The parameter struct.
+ * @name: The name.
+ * Return: The variable, or NULL if it has no entry (it is then either an
+ * inherited environment variable or not set at all).
+ */
+var_t *var_find(info_t *info, char *name)
+{
+	hash_entry_t *e = hash_find(&info->vars, name);
+
+	return (e ? e->value : NULL);
+}
+
+/**
+ * var_error - Reports an error about a variable.
+ * Format: "shell_name: line_count: name: msg\n"
+ * @info: The parameter struct.
+ * @name: The variable's name.
+ * @msg: The message.
+ * Return: 1, the status of the failed command.
+ */
+static int var_error(info_t *info, char *name, char *msg)
+{
+	error_line(info, name, ": ", msg, NULL); // error_line from error_handling/error_utilities.c
+	return (1);
+}
+
+/**
+ * elem_zero - Finds the element an array stands for when it is used as a
+ * plain variable: index 0, or key "0" of an associative array.
+ * @a: The array.
+ * Return: The value, or NULL if it is not set.
+ */
+static char *elem_zero(array_t *a)
+{
+	return (a->assoc ? array_find(a, "0", 1) : array_at(a, 0));
+}
+
+/**
+ * var_lookup - Finds a variable's value. A shell variable costs one hash
+ * lookup; only exported variables are searched for in the environment.
+ * @info: The parameter struct.
+ * @name: The name (not NUL-terminated).
+ * @len: Length of the name.
+ * Return: The value, or NULL if the variable is not set.
+ */
+char *var_lookup(info_t *info, const char *name, size_t len)
+{
+	hash_entry_t *e = hash_find_len(&info->vars, name, len);
+	var_t *v = e ? e->value : NULL;
+
+	if (v && !(v->flags & VAR_EXPORT))
+		return (v->arr ? elem_zero(v->arr) : v->value);
+	return (env_find(info, name, len));
+}
+
+/**
+ * var_array - Finds the elements of an array variable.
+ * @info: The parameter struct.
+ * @name: The name (not NUL-terminated).
+ * @len: Length of the name.
+ * Return: The array, or NULL if the variable is not an array.
+ */
+array_t *var_array(info_t *info, const char *name, size_t len)
+{
+	hash_entry_t *e = hash_find_len(&info->vars, name, len);
+
+	return (e ? ((var_t *)e->value)->arr : NULL);
+}
+
+/**
+ * var_get - Finds the value of a variable.
+ * @info: The parameter struct.
+ * @name: The name.
+ * Return: The value, or NULL if the variable is not set.
+ */
+char *var_get(info_t *info, char *name)
+{
+	return (var_lookup(info, name, _strlen(name)));
+}
+
+/**
+ * var_set - Assigns a variable. An exported variable is updated in the
+ * environment; any other is kept as a shell variable, so assigning it
+ * never makes the environment passed to commands stale.
+ * @info: The parameter struct.
+ * @name: The name, which must be valid.
+ * @value: The value.
+ * Return: 0 on success, 1 if the variable is read-only (reported),
+ * -1 on allocation failure.
+ */
+int var_set(info_t *info, char *name, char *value)
+{
+	var_t *v = var_find(info, name);
+	size_t len = _strlen(value) + 1;
+	char *p;
+
+	if (v && (v->flags & VAR_READONLY))
+		return (var_error(info, name, "is read only"));
+	if (v && v->arr) // An array's value is its first element
+		return (array_set(v->arr, 0, "0", value, len - 1, 0)); // array_set from variables/arrays.c
+	if (v ? (v->flags & VAR_EXPORT) : env_find(info, name, _strlen(name)) != NULL)
+		return (_setenv(info, name, value) ? -1 : 0); // _setenv from environment/env_manager.c
+	if (!v && !(v = add_var(info, name, 0)))
+		return (-1);
+	if (len > v->cap) // Grow; a loop counter keeps reusing its buffer
+	{
+		p = malloc(len);
+		if (!p)
+			return (-1);
+		memcpy(p, value, len);
+		free(v->value);
+		v->value = p;
+		v->cap = len;
+	}
+	else
+		memmove(v->value, value, len);
+	return (0);
+}
+
+/**
+ * var_export - Marks a variable for the environment of commands, moving a
+ * shell variable's value into info->env: export name[=value].
+ * @info: The parameter struct.
+ * @name: The name, which must be valid.
+ * @value: The new value, or NULL to export the current one. An unset
+ * variable is exported as soon as it is assigned.
+ * Return: 0 on success, 1 if the variable is read-only (reported),
+ * -1 on allocation failure.
+ */
+int var_export(info_t *info, char *name, char *value)
+{
+	var_t *v = var_find(info, name);
+
+	if (v && value && (v->flags & VAR_READONLY))
+		return (var_error(info, name, "is read only"));
+	if (v && v->arr) // Arrays cannot be passed to commands
+		return (value ? var_set(info, name, value) : 0);
+	if (!v && !value && !env_find(info, name, _strlen(name)))
+		return (add_var(info, name, VAR_EXPORT) ? 0 : -1);
+	if (!v || (v->flags & VAR_EXPORT)) // Already in the environment
+		return (value && _setenv(info, name, value) ? -1 : 0);
+	value = value ? value : v->value;
+	if (value && _setenv(info, name, value))
+		return (-1);
+	if (!(v->flags & VAR_READONLY) && value)
+	{
+		hash_remove(&info->vars, name, free_var); // The environment alone holds it now
+		return (0);
+	}
+	v->flags |= VAR_EXPORT;
+	free(v->value);
+	v->value = NULL;
+	v->cap = 0;
+	return (0);
+}
+
+/**
+ * var_readonly - Makes a variable read-only: readonly name[=value].
+ * @info: The parameter struct.
+ * @name: The name, which must be valid.
+ * @value: A value to assign first, or NULL.
+ * Return: 0 on success, 1 if the variable is already read-only and a
+ * value was given (reported), -1 on allocation failure.
+ */
+int var_readonly(info_t *info, char *name, char *value)
+{
+	var_t *v;
+	int r = value ? var_set(info, name, value) : 0;
+
+	if (r)
+		return (r);
+	v = var_find(info, name);
+	if (!v)
+		v = add_var(info, name, env_find(info, name, _strlen(name)) ? VAR_EXPORT : 0);
+	if (!v)
+		return (-1);
+	v->flags |= VAR_READONLY;
+	return (0);
+}
+
+/**
+ * var_unset - Unsets a variable and drops its attributes.
+ * @info: The parameter struct.
+ * @name: The name.
+ * Return: 0 on success, 1 if the variable is read-only (reported).
+ */
+int var_unset(info_t *info, char *name)
+{
+	var_t *v = var_find(info, name);
+
+	if (v && (v->flags & VAR_READONLY))
+		return (var_error(info, name, "is read only"));
+	if (!v || (v->flags & VAR_EXPORT))
+		_unsetenv(info, name); // _unsetenv from environment/env_manager.c
+	if (v)
+		hash_remove(&info->vars, name, free_var);
+	return (0);
+}
+
+/**
+ * var_save - Records a variable's current value so var_restore() can put
+ * it back, once per variable per list (local and NAME=value cmd use it).
+ * @info: The parameter struct.
+ * @saved: The list of saved values.
+ * @name: The name.
+ * Return: 0 on success, 1 on allocation failure.
+ */
+int var_save(info_t *info, list_t **saved, char *name)
+{
+	list_t *node;
+	char *p, *value = var_get(info, name), *buf;
+	int r;
+
+	for (node = *saved; node; node = node->next)
+	{
+		p = starts_with(node->str, name);
+		if (p && (*p == '=' || !*p)) // Already saved
+			return (0);
+	}
+	if (!value) // Saved as just "NAME": unset it on restore
+		return (!add_node(saved, name, 0));
+	buf = malloc(_strlen(name) + _strlen(value) + 2);
+	if (!buf)
+		return (1);
+	_strcpy(buf, name);
+	_strcat(buf, "=");
+	_strcat(buf, value);
+	r = !add_node(saved, buf, 1); // add_node from linked_lists/list_operations.c
+	free(buf);
+	return (r);
+}
+
+/**
+ * var_restore - Puts back the values recorded by var_save() and empties
+ * the list.
+ * @info: The parameter struct.
+ * @saved: The list of saved values.
+ */
+void var_restore(info_t *info, list_t **saved)
+{
+	list_t *node;
+	char *eq;
+
+	for (node = *saved; node; node = node->next)
+	{
+		eq = _strchr(node->str, '=');
+		if (node->num && eq) // It was set: "NAME=value"
+		{
+			*eq = '\0';
+			var_set(info, node->str, eq + 1);
+		}
+		else
+			var_unset(info, node->str);
+	}
+	free_list(saved); // free_list from linked_lists/list_operations.c
+}
+
+/**
+ * var_make_array - Finds or creates an array variable. A scalar becomes
+ * the array's first element.
+ * @info: The parameter struct.
+ * @name: The name, which must be valid.
+ * @assoc: 1 for an associative array, 0 for an indexed one, -1 to accept
+ * either (a new array is then indexed).
+ * Return: The array, or NULL on an error (reported) or allocation failure.
+ */
+array_t *var_make_array(info_t *info, char *name, int assoc)
+{
+	var_t *v = var_find(info, name);
+	char *value;
+
+	if (v && (v->flags & VAR_READONLY))
+	{
+		var_error(info, name, "is read only");
+		return (NULL);
+	}
+	if (v && v->arr)
+	{
+		if (assoc < 0 || assoc == v->arr->assoc)
+			return (v->arr);
+		var_error(info, name, assoc ? "cannot convert indexed to associative array"
+			: "cannot convert associative to indexed array");
+		return (NULL);
+	}
+	value = var_get(info, name);
+	if (!v && !(v = add_var(info, name, 0)))
+		return (NULL);
+	v->arr = array_new(assoc > 0); // array_new from variables/arrays.c
+	if (!v->arr || (value && array_set(v->arr, 0, "0", value, _strlen(value), 0)))
+		return (NULL);
+	if (v->flags & VAR_EXPORT || env_find(info, name, _strlen(name)))
+	{
+		_unsetenv(info, name); // Arrays cannot be passed to commands
+		v->flags &= ~VAR_EXPORT;
+	}
+	free(v->value);
+	v->value = NULL;
+	v->cap = 0;
+	return (v->arr);
+}
+
+/**
+ * subscript_index - Evaluates the expanded subscript of an indexed array.
+ * A plain number is read directly; anything else is an arithmetic
+ * expression.
+ * @info: The parameter struct.
+ * @sub: The subscript.
+ * @idx: Receives the index.
+ * Return: 0 on success, -1 on an arithmetic error (reported).
+ */
+int subscript_index(info_t *info, char *sub, long *idx)
+{
+	char *p = sub + (*sub == '-');
+	long n = 0;
+
+	for (; *p >= '0' && *p <= '9'; p++)
+		n = n * 10 + *p - '0';
+	if (*p || p == sub + (*sub == '-'))
+		return (arith_eval(info, sub, idx)); // arith_eval from variables/arithmetic.c
+	*idx = *sub == '-' ? -n : n;
+	return (0);
+}
+
+/**
+ * set_elem - Assigns one element of an array.
+ * @info: The parameter struct.
+ * @name: The array's name, for error messages.
+ * @a: The array.
+ * @sub: The expanded subscript.
+ * @value: The value.
+ * @append: Append to the element instead of replacing it (+=).
+ * Return: 0 on success, 1 on an error (reported).
+ */
+static int set_elem(info_t *info, char *name, array_t *a, char *sub, char *value,
+	int append)
+{
+	long i = 0;
+
+	if (!a->assoc && subscript_index(info, sub, &i))
+		return (1);
+	if (array_set(a, i, sub, value, _strlen(value), append))
+		return (var_error(info, name, "bad array subscript"));
+	return (0);
+}
+
+/**
+ * var_unset_elem - Unsets one element of an array: unset 'name[subscript]'.
+ * @info: The parameter struct.
+ * @name: The name; it is cut at the '['.
+ * @sub: The subscript, up to the closing ']'.
+ * Return: 0 on success, 1 on an error (reported).
+ */
+int var_unset_elem(info_t *info, char *name, char *sub)
+{
+	var_t *v;
+	long i = 0;
+	char *end = _strchr(sub, ']');
+
+	if (!end || end[1])
+		return (var_error(info, name, "bad array subscript"));
+	*end = '\0';
+	sub[-1] = '\0';
+	v = var_find(info, name);
+	if (v && (v->flags & VAR_READONLY))
+		return (var_error(info, name, "is read only"));
+	if (!v || !v->arr)
+		return (_strcmp(sub, "0") ? 0 : var_unset(info, name)); // name[0] is the scalar
+	if (!v->arr->assoc && subscript_index(info, sub, &i))
+		return (1);
+	array_unset(v->arr, i, sub); // array_unset from variables/arrays.c
+	return (0);
+}
+
+/**
+ * var_set_array - Performs a compound assignment: name=(word...) or
+ * name+=(word...). A word of the form [subscript]=value sets that
+ * element; any other sets the index after the previous one.
+ * @info: The parameter struct.
+ * @name: The name, which must be valid.
+ * @elems: The expanded words, NULL-terminated.
+ * @append: Add to the array instead of replacing its elements.
+ * Return: 0 on success, 1 on an error (reported).
+ */
+int var_set_array(info_t *info, char *name, char **elems, int append)
+{
+	array_t *a = var_make_array(info, name, -1);
+	char *eq;
+	int r = 0;
+
+	if (!a)
+		return (1);
+	if (!append)
+		array_clear(a); // The words were expanded before the old elements go
+	for (; *elems && !r; elems++)
+	{
+		eq = **elems == '[' ? _strchr(*elems, ']') : NULL;
+		if (eq && eq[1] == '=')
+		{
+			*eq = '\0';
+			r = set_elem(info, name, a, *elems + 1, eq + 2, 0);
+			*eq = ']';
+		}
+		else if (a->assoc)
+			r = var_error(info, *elems, "must use subscript when assigning associative array");
+		else if (array_push(a, *elems, _strlen(*elems))) // array_push from variables/arrays.c
+			r = -1;
+	}
+	return (r != 0);
+}
+
+/**
+ * assign_one - Performs one expanded assignment: NAME=value, NAME+=value
+ * or NAME[subscript]=value (also with +=).
+ * @info: The parameter struct.
+ * @s: The assignment; it is restored before returning.
+ * @saved: If not NULL, the old value is recorded here first.
+ * Return: 0 on success, non-zero if the assignment failed.
+ */
+static int assign_one(info_t *info, char *s, list_t **saved)
+{
+	char *p = s, *sub = NULL, *end = NULL, *cat, *old;
+	array_t *a;
+	int append, r;
+
+	while (is_alpha_char(*p) || *p == '_' || (p > s && *p >= '0' && *p <= '9'))
+		p++;
+	if (*p == '[')
+	{
+		for (sub = end = p + 1; *end && (*end != ']' || (end[1] != '='
+			&& (end[1] != '+' || end[2] != '='))); end++)
+			;
+		*end = '\0';
+		p = end + 1;
+	}
+	append = *p == '+';
+	*(sub ? sub - 1 : p) = '\0';
+	if (sub)
+	{
+		a = var_make_array(info, s, -1);
+		r = a ? set_elem(info, s, a, sub, p + 1 + append, append) : 1;
+		sub[-1] = '[';
+		*end = ']';
+		return (r);
+	}
+	r = saved ? var_save(info, saved, s) : 0;
+	old = append ? var_get(info, s) : NULL;
+	cat = p + 1 + append;
+	if (old) // NAME+=value
+	{
+		cat = arena_alloc(&info->scratch, _strlen(old) + _strlen(p + 2) + 1);
+		if (cat)
+		{
+			_strcpy(cat, old);
+			_strcat(cat, p + 2);
+		}
+	}
+	if (!r)
+		r = cat ? var_set(info, s, cat) : -1;
+	*p = append ? '+' : '=';
+	return (r);
+}
+
+/**
+ * var_assign - Performs expanded assignments in order.
+ * @info: The parameter struct.
+ * @assigns: The assignments, NULL-terminated.
+ * @saved: If not NULL, the old values are recorded here first, so the
+ * assignments can be undone with var_restore().
+ * Return: 0 on success, 1 if an assignment failed.
+ */
+int var_assign(info_t *info, char **assigns, list_t **saved)
+{
+	int r = 0;
+
+	for (; *assigns && !r; assigns++)
+		r = assign_one(info, *assigns, saved);
+	return (r != 0);
+}
+
+/**
+ * assign_words - Performs the assignments of a command that has no command
+ * name. Each is expanded just before it is made, so it sees the ones
+ * before it; a NAME=( word is expanded together with its elements.
+ * @info: The parameter struct.
+ * @words: The words, all flagged TOKF_ASSIGN or TOKF_ELEM.
+ * @n: Number of words.
+ * Return: The command's status.
+ */
+int assign_words(info_t *info, word_t *words, int n)
+{
+	char **v, *name;
+	int i, k, r = 0, append;
+
+	for (i = 0; i < n && !r; i = k)
+	{
+		for (k = i + 1; (words[i].flags & TOKF_ARRAY) && k < n
+			&& (words[k].flags & TOKF_ELEM); k++)
+			;
+		v = expand_words(info, words + i, k - i); // expand_words from shell_core/shell_utilities.c
+		if (!v)
+			return (info->status);
+		if (words[i].flags & TOKF_ARRAY) // "name=" or "name+="
+		{
+			name = v[0];
+			append = name[_strlen(name) - 2] == '+';
+			name[_strlen(name) - 1 - append] = '\0';
+			r = var_set_array(info, name, v + 1, append);
+		}
+		else
+			r = var_assign(info, v, NULL);
+		free(v);
+	}
+	return (r);
+}
+
+/**
+ * free_vars - Frees every shell variable.
+ * @info: The parameter struct.
+ */
+void free_vars(info_t *info)
+{
+	hash_free(&info->vars, free_var);
+}
@@ -1,95 +1,769 @@
 #include "../includes/shell.h"
 
+static int expand_range(info_t *info, char *w, char *end, int pat);
+
 /**
- * replace_alias - Replaces an alias in the tokenized string (argv[0]).
- * Attempts up to 10 replacements to handle nested aliases.
+ * xbuf_put - Appends bytes to the expansion buffer, growing it
+ * geometrically. All the words of a command are expanded into this one
+ * buffer, one after the other, each followed by a NUL.
  * @info: The parameter struct.
- * Return: 1 if an alias was replaced, 0 otherwise.
+ * @s: The bytes.
+ * @len: Number of bytes.
+ * Return: 0 on success, -1 on allocation failure.
  */
-int replace_alias(info_t *info)
+static int xbuf_put(info_t *info, const char *s, size_t len)
 {
-	int i;
-	list_t *node;
+	size_t cap;
 	char *p;
 
-	for (i = 0; i < 10; i++) // Max 10 alias replacements to prevent infinite loop
+	if (info->xbuf_len + len + 1 > info->xbuf_cap)
 	{
-		// Check if argv[0] is an alias
-		node = node_starts_with(info->alias, info->argv[0], '='); // node_starts_with in linked_lists/list_utilities.c
-		if (!node)
-			return (0); // No alias found
+		cap = info->xbuf_cap ? info->xbuf_cap * 2 : 256;
+		while (cap < info->xbuf_len + len + 1)
+			cap *= 2;
+		p = _realloc(info->xbuf, info->xbuf_cap, cap);
+		if (!p)
+			return (-1);
+		info->xbuf = p;
+		info->xbuf_cap = cap;
+	}
+	memcpy(info->xbuf + info->xbuf_len, s, len);
+	info->xbuf_len += len;
+	return (0);
+}
 
-		free(info->argv[0]); // Free the old argv[0] string
+/**
+ * put_value - Appends text to the expansion buffer. When a pattern is
+ * being built from quoted text, glob characters are escaped so that they
+ * only match themselves.
+ * @info: The parameter struct.
+ * @s: The text.
+ * @len: Its length.
+ * @esc: Escape *, ?, [, ] and backslash.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int put_value(info_t *info, const char *s, size_t len, int esc)
+{
+	size_t i, run;
 
-		p = _strchr(node->str, '='); // _strchr in string_operations/string_manipulation1.c
-		if (!p)
-			return (0); // Should not happen for a valid alias node
+	if (!esc)
+		return (xbuf_put(info, s, len));
+	for (i = run = 0; i < len; i++)
+		if (_strchr("*?[]\\", s[i]))
+		{
+			if (xbuf_put(info, s + run, i - run) || xbuf_put(info, "\\", 1))
+				return (-1);
+			run = i;
+		}
+	return (xbuf_put(info, s + run, len - run));
+}
 
-		p = _strdup(p + 1); // Duplicate the alias value (part after '=') (_strdup in string_operations/string_manipulation2.c)
-		if (!p)
-			return (0); // Malloc failure
+/**
+ * xbuf_num - Appends a non-negative number in decimal.
+ * @info: The parameter struct.
+ * @n: The number.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int xbuf_num(info_t *info, unsigned long n)
+{
+	char digits[NUM_BUF_SIZE];
+
+	// fmt_unsigned from memory_utils/string_converters.c
+	return (xbuf_put(info, digits, fmt_unsigned(n, digits)));
+}
 
-		info->argv[0] = p; // Assign the new alias value to argv[0]
+/**
+ * put_break - Separates two elements of "$@" or "${name[@]}": they become
+ * separate words, unless the word being expanded must stay one word, in
+ * which case (and for $* and ${name[*]}) they are joined with a space.
+ * @info: The parameter struct.
+ * @join: Join the elements in any case.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int put_break(info_t *info, int join)
+{
+	if (join || !info->xfields)
+		return (xbuf_put(info, " ", 1));
+	info->xsplit++;
+	return (xbuf_put(info, "", 1)); // Ends the word; replace_vars() counts it
+}
+
+/**
+ * expand_special - Appends the value of a one-character parameter:
+ * ?, $, #, @, * or a digit.
+ * @info: The parameter struct.
+ * @c: The parameter's character.
+ * @esc: Escape glob characters (see put_value()).
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int expand_special(info_t *info, char c, int esc)
+{
+	int i;
+
+	switch (c)
+	{
+	case '?':
+		return (xbuf_num(info, info->status));
+	case '$':
+		return (xbuf_num(info, info->pid));
+	case '#':
+		return (xbuf_num(info, info->nparams));
+	case '@':
+	case '*':
+		info->xnone |= c == '@' && !info->nparams && info->xfields;
+		for (i = 0; i < info->nparams; i++)
+			if ((i && put_break(info, c == '*'))
+				|| put_value(info, info->params[i], _strlen(info->params[i]), esc))
+				return (-1);
+		return (0);
+	case '0':
+		return (put_value(info, info->fname, _strlen(info->fname), esc));
 	}
-	return (1); // Alias was replaced
+	i = c - '0';
+	if (i > info->nparams)
+		return (0);
+	return (put_value(info, info->params[i - 1], _strlen(info->params[i - 1]), esc));
 }
 
 /**
- * replace_vars - Replaces variables in the tokenized string (argv).
- * Handles $?, $$, $ENV_VAR.
+ * bad_substitution - Reports a malformed ${...}.
  * @info: The parameter struct.
- * Return: 1 if any variable was replaced, 0 otherwise.
+ * Return: Always -2.
  */
-int replace_vars(info_t *info)
+static int bad_substitution(info_t *info)
+{
+	error_line(info, "Bad substitution", NULL); // error_line from error_handling/error_utilities.c
+	info->status = 2;
+	return (-2);
+}
+
+/**
+ * expand_text - Expands part of a word into a string of its own, for the
+ * operand of a ${name op word} operator.
+ * @info: The parameter struct.
+ * @w: Start of the text.
+ * @end: End of the text.
+ * @pat: The text is a pattern (see expand_range()).
+ * @out: Receives the expansion, in the scratch arena.
+ * Return: 0 on success, -1 on allocation failure, -2 on a bad ${...}.
+ */
+static int expand_text(info_t *info, char *w, char *end, int pat, char **out)
+{
+	size_t mark = info->xbuf_len;
+	int fields = info->xfields, r;
+
+	info->xfields = 0; // "$@" in an operand is joined
+	r = expand_range(info, w, end, pat);
+	info->xfields = fields;
+	if (!r)
+		*out = arena_strndup(&info->scratch, info->xbuf + mark, info->xbuf_len - mark);
+	info->xbuf_len = mark;
+	return (r ? r : *out ? 0 : -1);
+}
+
+/**
+ * put_elems - Appends every element, or every index or key, of an array:
+ * ${name[@]}, ${name[*]}, ${!name[@]} and ${!name[*]}. Elements come in
+ * index order, or in insertion order for an associative array.
+ * @info: The parameter struct.
+ * @name: The array's name (not NUL-terminated).
+ * @len: Length of the name.
+ * @join: Join the elements with spaces ([*]) instead of separating them.
+ * @keys: Append the indexes or keys instead of the values.
+ * @esc: Escape glob characters (see put_value()).
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int put_elems(info_t *info, char *name, size_t len, int join, int keys,
+	int esc)
 {
-	int i = 0;
-	list_t *node;
-	int replaced_any = 0;
+	array_t *a = var_array(info, name, len); // var_array from variables/shell_variables.c
+	char *v = a ? NULL : var_lookup(info, name, len);
+	size_t i, n = 0;
+	int r = 0;
 
-	for (i = 0; info->argv[i]; i++)
+	if (v) // A plain variable is an array of one element
+		return (keys ? xbuf_put(info, "0", 1) : put_value(info, v, _strlen(v), esc));
+	for (i = 0; a && i < a->n && !r; i++)
+		if (a->vals[i])
+		{
+			r = n++ ? put_break(info, join) : 0;
+			if (!r && keys)
+				r = a->assoc ? put_value(info, a->keys[i], _strlen(a->keys[i]), esc)
+					: xbuf_num(info, i);
+			else if (!r)
+				r = put_value(info, a->vals[i], _strlen(a->vals[i]), esc);
+		}
+	info->xnone |= !n && !join && info->xfields;
+	return (r);
+}
+
+/**
+ * elem_value - Gets the value of ${name[subscript]}. The subscript of an
+ * indexed array is an arithmetic expression; that of an associative array
+ * is a key. [@] and [*] give all the elements joined with spaces.
+ * @info: The parameter struct.
+ * @name: The name and subscript (not NUL-terminated).
+ * @len: Length of the name and subscript, up to and including the ']'.
+ * @val: Receives the value ("" if the element is unset).
+ * Return: 0 if the element is set, 1 if it is not, -1 on allocation
+ * failure, -2 on a bad subscript.
+ */
+static int elem_value(info_t *info, char *name, size_t len, char **val)
+{
+	char *sub = memchr(name, '[', len), *end = name + len - 1;
+	size_t n = sub - name, mark = info->xbuf_len;
+	array_t *a = var_array(info, name, n);
+	long i = 0;
+	int r;
+
+	*val = "";
+	if (end == sub + 2 && (sub[1] == '@' || sub[1] == '*'))
+	{
+		r = put_elems(info, name, n, 1, 0, 0);
+		*val = r ? NULL : arena_strndup(&info->scratch, info->xbuf + mark, info->xbuf_len - mark);
+		info->xbuf_len = mark;
+		return (!*val ? -1 : (a ? !a->count : !var_lookup(info, name, n)));
+	}
+	r = expand_text(info, sub + 1, end, 0, &sub);
+	if (r)
+		return (r);
+	if (a && a->assoc)
+		*val = array_find(a, sub, _strlen(sub)); // array_find from variables/arrays.c
+	else if (subscript_index(info, sub, &i)) // Reported; status is 2
+		return (-2);
+	else if (a)
+		*val = array_at(a, i); // array_at from variables/arrays.c
+	else
+		*val = i ? NULL : var_lookup(info, name, n);
+	return (*val ? 0 : (*val = "", 1));
+}
+
+/**
+ * param_value - Gets the value of the parameter named in a ${...}.
+ * @info: The parameter struct.
+ * @name: The name: a variable (possibly with a [subscript]), a positional
+ * number or a special character.
+ * @len: Length of the name.
+ * @val: Receives the value ("" if the parameter is unset).
+ * Return: 0 if the parameter is set, 1 if it is not, -1 on allocation
+ * failure, -2 on a bad subscript.
+ */
+static int param_value(info_t *info, char *name, size_t len, char **val)
+{
+	size_t mark = info->xbuf_len, i, n = 0;
+	int fields = info->xfields;
+
+	*val = "";
+	if (is_alpha_char(*name) || *name == '_')
+	{
+		if (name[len - 1] == ']')
+			return (elem_value(info, name, len, val));
+		*val = var_lookup(info, name, len);
+		return (*val ? 0 : (*val = "", 1));
+	}
+	if (*name >= '0' && *name <= '9')
+	{
+		for (i = 0; i < len && n <= (size_t)info->nparams; i++)
+			n = n * 10 + name[i] - '0';
+		if (n > (size_t)info->nparams)
+			return (1);
+		*val = n ? info->params[n - 1] : info->fname;
+		return (0);
+	}
+	info->xfields = 0; // $@ is joined
+	i = expand_special(info, *name, 0);
+	info->xfields = fields;
+	if (i)
+		return (-1);
+	*val = arena_strndup(&info->scratch, info->xbuf + mark, info->xbuf_len - mark);
+	info->xbuf_len = mark;
+	if (!*val)
+		return (-1);
+	return ((*name == '@' || *name == '*') && !info->nparams);
+}
+
+/**
+ * scan_to - Finds a delimiter that is outside quotes and nested ${...}.
+ * @p: Where to start.
+ * @end: Where to stop, or NULL to stop at the end of the string.
+ * @c: The delimiter.
+ * Return: Pointer to the delimiter, or NULL if there is none.
+ */
+static char *scan_to(char *p, char *end, char c)
+{
+	int depth = 0;
+
+	for (; *p && (!end || p < end); p++)
+	{
+		if (*p == c && !depth)
+			return (p);
+		if (*p == '\\' && p[1])
+			p++;
+		else if (*p == '\'' && !(p = _strchr(p + 1, '\'')))
+			return (NULL);
+		else if (*p == '"')
+		{
+			for (p++; *p && *p != '"'; p++)
+				p += (*p == '\\' && p[1]);
+			if (!*p)
+				return (NULL);
+		}
+		else if (*p == '$' && p[1] == '{')
+			depth++, p++;
+		else if (*p == '}' && depth)
+			depth--;
+	}
+	return (NULL);
+}
+
+/**
+ * strip - Evaluates ${name#pat}, ${name##pat}, ${name%pat} and ${name%%pat}:
+ * removes the shortest (or longest) prefix or suffix matching the pattern.
+ * @info: The parameter struct.
+ * @v: The value.
+ * @pat: The pattern.
+ * @op: '#' for a prefix, '%' for a suffix.
+ * @longest: Remove the longest match instead of the shortest.
+ * @esc: Escape glob characters in the result (see put_value()).
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int strip(info_t *info, char *v, char *pat, char op, int longest, int esc)
+{
+	pattern_t *p = pattern_get(info, pat); // pattern_get from variables/pattern_match.c
+	size_t len = _strlen(v), i, k;
+
+	if (!p)
+		return (-1);
+	for (i = 0; i <= len; i++)
+	{
+		k = (op == '#') == longest ? len - i : i; // Length of the prefix kept or removed
+		if (op == '#' && pattern_match(p, v, k))
+			return (put_value(info, v + k, len - k, esc));
+		if (op == '%' && pattern_match(p, v + k, len - k))
+			return (put_value(info, v, k, esc));
+	}
+	return (put_value(info, v, len, esc));
+}
+
+/**
+ * substitute - Evaluates ${name/pat/rep} and ${name//pat/rep}: replaces
+ * the first (or every) longest match of the pattern. ${name/#pat/rep}
+ * and ${name/%pat/rep} only match at the start or the end of the value.
+ * @info: The parameter struct.
+ * @v: The value.
+ * @pat: The pattern.
+ * @rep: The replacement.
+ * @how: '/' to replace every match, '#' or '%' to anchor, 0 for the first.
+ * @esc: Escape glob characters in the result (see put_value()).
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int substitute(info_t *info, char *v, char *pat, char *rep, int how, int esc)
+{
+	pattern_t *p = pattern_get(info, pat);
+	size_t len = _strlen(v), i = 0, j, last = 0;
+
+	if (!p)
+		return (-1);
+	while (p->n && i + p->minlen <= len)
 	{
-		if (info->argv[i][0] != '$' || !info->argv[i][1]) // Not a variable or just '$'
+		j = p->star || how == '%' ? len : i + p->minlen; // Without a '*' only one length can match
+		while (j > i && !pattern_match(p, v + i, j - i))
+			j = how == '%' ? i : j - 1;
+		if (j == i && how == '#')
+			break;
+		if (j == i)
+		{
+			i++;
 			continue;
+		}
+		if (put_value(info, v + last, i - last, esc)
+			|| put_value(info, rep, _strlen(rep), esc))
+			return (-1);
+		last = i = j;
+		if (how != '/')
+			break;
+	}
+	return (put_value(info, v + last, len - last, esc));
+}
+
+/**
+ * get_number - Reads an optionally signed decimal number.
+ * @pp: The text; advanced past the number and any blanks.
+ * @n: Receives the number.
+ * Return: 0 on success, -1 if there is no number.
+ */
+static int get_number(char **pp, long *n)
+{
+	char *p = *pp;
+	int neg;
+
+	while (*p == ' ' || *p == '\t')
+		p++;
+	neg = *p == '-';
+	p += (*p == '-' || *p == '+');
+	if (*p < '0' || *p > '9')
+		return (-1);
+	for (*n = 0; *p >= '0' && *p <= '9'; p++)
+		*n = *n * 10 + *p - '0';
+	*n = neg ? -*n : *n;
+	while (*p == ' ' || *p == '\t')
+		p++;
+	*pp = p;
+	return (0);
+}
+
+/**
+ * substring - Evaluates ${name:offset} and ${name:offset:length}.
+ * A negative offset counts from the end; a negative length stops that
+ * many characters before the end.
+ * @info: The parameter struct.
+ * @v: The value.
+ * @spec: The expanded "offset[:length]" text.
+ * @esc: Escape glob characters in the result (see put_value()).
+ * Return: 0 on success, -1 on allocation failure, -2 on a bad spec.
+ */
+static int substring(info_t *info, char *v, char *spec, int esc)
+{
+	long len = _strlen(v), off, n = len;
+
+	if (get_number(&spec, &off) || (*spec == ':' && (++spec, get_number(&spec, &n)))
+		|| *spec)
+		return (bad_substitution(info));
+	if (off < 0)
+		off = off + len < 0 ? len : off + len;
+	else if (off > len)
+		off = len;
+	if (n < 0) // Stop -n characters before the end
+		n = len + n - off;
+	if (n < 0)
+		n = 0;
+	if (n > len - off)
+		n = len - off;
+	return (put_value(info, v + off, n, esc));
+}
+
+/**
+ * use_default - Evaluates ${name-word}, ${name=word}, ${name+word} and their
+ * ':' forms, which also treat an empty value as unset.
+ * @info: The parameter struct.
+ * @name: The parameter's name (not NUL-terminated).
+ * @len: Length of the name.
+ * @op: Points at the operator character; the word follows it.
+ * @end: The closing '}'.
+ * @esc: Escape glob characters in the result (see put_value()).
+ * Return: 0 on success, -1 on allocation failure, -2 on an error.
+ */
+static int use_default(info_t *info, char *name, size_t len, char *op, char *end,
+	int esc)
+{
+	char *v, *word, *key;
+	int unset = param_value(info, name, len, &v), r;
+
+	if (unset < 0)
+		return (unset);
+	unset |= op[-1] == ':' && !*v;
+	if ((*op == '+') == unset) // The value itself is the result ('+': nothing)
+		return (*op == '+' ? 0 : put_value(info, v, _strlen(v), esc));
+	r = expand_text(info, op + 1, end, 0, &word);
+	if (r)
+		return (r);
+	if (*op == '=')
+	{
+		if ((!is_alpha_char(*name) && *name != '_') || name[len - 1] == ']')
+			return (bad_substitution(info)); // Only variables can be assigned
+		key = arena_strndup(&info->scratch, name, len);
+		r = key ? var_set(info, key, word) : -1; // var_set from variables/shell_variables.c
+		if (r)
+		{
+			info->status = 1; // A read-only variable; var_set reported it
+			return (r < 0 ? -1 : -2);
+		}
+	}
+	return (put_value(info, word, _strlen(word), esc));
+}
+
+/**
+ * expand_braced - Expands a ${...} parameter: plain ${name}, ${#name} and
+ * the operators #, ##, %, %%, /, //, /#, /%, :offset:length, -, =, + and
+ * their ':' forms. Patterns are compiled once and cached (see pattern_get()).
+ * A name may have a [subscript]; ${name[@]}, ${#name[@]} and ${!name[@]}
+ * give the elements, their number and their indexes or keys.
+ * @info: The parameter struct.
+ * @pp: Points at the '{'; advanced past the closing '}'.
+ * @esc: Escape glob characters in the result (see put_value()).
+ * Return: 0 on success, -1 on allocation failure, -2 on a bad ${...}.
+ */
+static int expand_braced(info_t *info, char **pp, int esc)
+{
+	char *p = *pp + 1, *end = scan_to(p, NULL, '}'), *name, *v, *a, *b, *slash;
+	int length, keys, all = 0, r, twice, how;
+	array_t *arr;
+
+	if (!end)
+		return (bad_substitution(info));
+	*pp = end + 1;
+	length = *p == '#' && p + 1 < end && !_strchr("#%:/-=+", p[1]);
+	keys = *p == '!' && p + 1 < end;
+	name = p += length + keys;
+	if (is_alpha_char(*p) || *p == '_')
+		while (is_alpha_char(*p) || *p == '_' || (*p >= '0' && *p <= '9'))
+			p++;
+	else if (*p >= '0' && *p <= '9')
+		while (*p >= '0' && *p <= '9')
+			p++;
+	else if (*p && _strchr("?$#@*", *p))
+		p++;
+	if (*p == '[' && p > name && (is_alpha_char(*name) || *name == '_'))
+	{
+		a = p + 1;
+		p = scan_to(a, end, ']');
+		if (!p)
+			return (bad_substitution(info));
+		all = p++ == a + 1 && (*a == '@' || *a == '*');
+	}
+	if (p == name || ((length || keys) && p != end) || (keys && !all))
+		return (bad_substitution(info));
+	if (all && (keys || (!length && p == end))) // Every element, or every index
+		return (put_elems(info, name, p - name - 3, p[-2] == '*', keys, esc));
+	if (all && length)
+	{
+		arr = var_array(info, name, p - name - 3);
+		return (xbuf_num(info, arr ? arr->count : var_lookup(info, name, p - name - 3) != NULL));
+	}
+	if ((*name == '@' || *name == '*') && p == end && !length)
+		return (expand_special(info, *name, esc)); // "${@}" is "$@"
+	if (*p == ':' && p + 1 < end && _strchr("-=+", p[1]))
+		p++;
+	if (*p == '-' || *p == '=' || *p == '+')
+		return (use_default(info, name, p - name - (p[-1] == ':'), p, end, esc));
+	r = param_value(info, name, p - name, &v);
+	if (r < 0)
+		return (r);
+	if (length)
+		return (xbuf_num(info, _strlen(v)));
+	if (p == end)
+		return (put_value(info, v, _strlen(v), esc));
+	twice = p[1] == *p && (*p == '#' || *p == '%' || *p == '/');
+	if (*p == '#' || *p == '%')
+	{
+		r = expand_text(info, p + 1 + twice, end, 1, &a);
+		return (r ? r : strip(info, v, a, *p, twice, esc));
+	}
+	if (*p == '/')
+	{
+		how = twice ? '/' : p[1] == '#' || p[1] == '%' ? p[1] : 0;
+		p += 1 + !!how;
+		slash = scan_to(p, end, '/');
+		r = expand_text(info, p, slash ? slash : end, 1, &a);
+		b = "";
+		if (!r && slash)
+			r = expand_text(info, slash + 1, end, 0, &b);
+		return (r ? r : substitute(info, v, a, b, how, esc));
+	}
+	if (*p != ':')
+		return (bad_substitution(info));
+	r = expand_text(info, p + 1, end, 0, &a);
+	return (r ? r : substring(info, v, a, esc));
+}
+
+/**
+ * expand_param - Expands the parameter that follows a '$'.
+ * @info: The parameter struct.
+ * @pp: Points just past the '$'; advanced past the parameter.
+ * @esc: Escape glob characters in the result (see put_value()).
+ * Return: 0 on success, -1 on allocation failure, -2 on a bad ${...}.
+ */
+static int expand_param(info_t *info, char **pp, int esc)
+{
+	char *p = *pp, *v;
+
+	if (*p == '{')
+		return (expand_braced(info, pp, esc));
+	if (is_alpha_char(*p) || *p == '_')
+	{
+		while (is_alpha_char(*p) || *p == '_' || (*p >= '0' && *p <= '9'))
+			p++;
+		v = var_lookup(info, *pp, p - *pp);
+		*pp = p;
+		return (v ? put_value(info, v, _strlen(v), esc) : 0);
+	}
+	if (*p && _strchr("?$#@*0123456789", *p))
+	{
+		*pp = p + 1;
+		return (expand_special(info, *p, esc));
+	}
+	return (xbuf_put(info, "$", 1)); // A lone '$' stands for itself
+}
 
-		replaced_any = 1; // Assume replacement will happen
+/**
+ * expand_range - Expands the parameters in raw word text and removes its
+ * quotes, appending the result to the expansion buffer. The text is
+ * scanned once; runs of ordinary characters are copied whole.
+ * @info: The parameter struct.
+ * @w: The raw text, as the lexer left it.
+ * @end: Where the text ends, or NULL if it runs to a NUL.
+ * @pat: The text is a pattern: quoted characters are escaped so that
+ * they only match themselves.
+ * Return: 0 on success, -1 on allocation failure, -2 on a bad ${...}.
+ */
+static int expand_range(info_t *info, char *w, char *end, int pat)
+{
+	char *run;
+	int dq = 0, r = 0;
 
-		if (!_strcmp(info->argv[i], "$?")) // Replace with last exit status
+	while (*w && w != end && !r)
+	{
+		for (run = w; *w && w != end && !_strchr("$'\"\\", *w); w++)
+			;
+		if (w > run && put_value(info, run, w - run, pat && dq))
+			return (-1);
+		if (!*w || w == end)
+			break;
+		if (*w == '$')
 		{
-			replace_string(&(info->argv[i]),
-				_strdup(convert_number(info->status, 10, 0))); // convert_number in memory_utils/string_converters.c
+			w++;
+			r = expand_param(info, &w, pat && dq);
 		}
-		else if (!_strcmp(info->argv[i], "$$")) // Replace with shell's PID
+		else if (*w == '"')
 		{
-			replace_string(&(info->argv[i]),
-				_strdup(convert_number(getpid(), 10, 0)));
+			dq = !dq;
+			w++;
 		}
-		else // Replace with environment variable
+		else if (*w == '\'' && !dq) // Single quotes: everything up to the next one is literal
 		{
-			node = node_starts_with(info->env, &info->argv[i][1], '='); // Search env list
-			if (node)
-			{
-				replace_string(&(info->argv[i]),
-					_strdup(_strchr(node->str, '=') + 1)); // Replace with env value
-			}
-			else
-			{
-				replace_string(&info->argv[i], _strdup("")); // Variable not found, replace with empty string
-			}
+			for (run = ++w; *w && w != end && *w != '\''; w++)
+				;
+			r = put_value(info, run, w - run, pat);
+			w += *w == '\'';
+		}
+		else if (*w == '\\' && w[1] == '\n') // Line continuation
+			w += 2;
+		else if (*w == '\\' && w[1] && (!dq || _strchr("$`\"\\", w[1])))
+		{
+			r = put_value(info, w + 1, 1, pat);
+			w += 2;
+		}
+		else
+			r = put_value(info, w++, 1, pat && dq);
+	}
+	return (r);
+}
+
+/**
+ * expand_pattern - Expands a word of a case item into a pattern: quoted
+ * characters are escaped so that they only match themselves, as in the
+ * ${name#pat} operators.
+ * @info: The parameter struct.
+ * @word: The word.
+ * Return: The pattern (in the scratch arena, unless the word needed no
+ * expansion), or NULL on error, with status set.
+ */
+char *expand_pattern(info_t *info, word_t *word)
+{
+	char *out = NULL;
+	int r;
+
+	if (!(word->flags & TOKF_DOLLAR))
+		return (word->str);
+	info->xbuf_len = 0;
+	r = expand_text(info, word->str, NULL, 1, &out);
+	if (r == -1)
+		info->status = 1;
+	return (r ? NULL : out);
+}
+
+/**
+ * split_words - Points argv at the expanded words when "$@" or
+ * "${name[@]}" turned some words into several, or into none.
+ * @info: The parameter struct.
+ * @fields: Number of words each expanded word became.
+ * Return: 0 on success, -1 on allocation failure.
+ */
+static int split_words(info_t *info, int *fields)
+{
+	char **old = arena_alloc(&info->scratch, sizeof(char *) * info->argc), *p = info->xbuf;
+	int i, j, n = 0;
+
+	for (i = 0; old && i < info->argc; i++)
+	{
+		old[i] = info->argv[i];
+		n += info->cmd_words[i].flags & TOKF_DOLLAR ? fields[i] : 1;
+	}
+	if (!old || argv_reserve(info, n + 1)) // argv_reserve from shell_core/shell_utilities.c
+		return (-1);
+	info->argv = info->argv_buf;
+	for (i = n = 0; i < info->argc; i++)
+	{
+		if (!(info->cmd_words[i].flags & TOKF_DOLLAR))
+			info->argv[n++] = old[i];
+		for (j = 0; (info->cmd_words[i].flags & TOKF_DOLLAR) && j < fields[i]; j++)
+		{
+			info->argv[n++] = p;
+			p += _strlen(p) + 1;
 		}
+		if ((info->cmd_words[i].flags & TOKF_DOLLAR) && !fields[i])
+			p++; // The word vanished; skip its empty string
 	}
-	return (replaced_any);
+	info->argv[n] = NULL;
+	info->argc = n;
+	return (0);
 }
 
 /**
- * replace_string - Replaces an old string pointer with a new string pointer,
- * and frees the memory of the old string.
- * @old: Address of the old string pointer.
- * @new: New string pointer.
- * Return: 1 if replaced, 0 otherwise (should always be 1 if old is not NULL).
+ * replace_vars - Expands $NAME, ${NAME} (and its operators), $?, $$, $#,
+ * $0-$9, $@ and $* anywhere in the command's words. Only words the lexer
+ * flagged as containing a '$' are touched; every other word stays a slice
+ * of the line buffer. The expanded words share one reusable buffer.
+ * "$@" and "${name[@]}" make a word of each element, except in a plain
+ * assignment, which stays one word.
+ * @info: The parameter struct.
+ * Return: 1 if any word was expanded, 0 if none needed it, or -1 on
+ * error (argv is then cleared and the command is not run).
  */
-int replace_string(char **old, char *new)
+int replace_vars(info_t *info)
 {
-	free(*old); // Free the memory pointed to by old
-	*old = new; // Update the pointer to the new string
-	return (1);
+	int i, k, any = 0, r = 0, *fields = NULL;
+	size_t mark;
+	char *p;
+
+	info->xbuf_len = 0;
+	for (i = 0; info->argv[i] && !r; i++)
+		if (info->cmd_words[i].flags & TOKF_DOLLAR) // Quoted or no '$' at all
+		{
+			mark = info->xbuf_len;
+			info->xsplit = info->xnone = 0;
+			info->xfields = !info->xjoin
+				&& (info->cmd_words[i].flags & (TOKF_ASSIGN | TOKF_ELEM)) != TOKF_ASSIGN;
+			r = expand_range(info, info->argv[i], NULL, 0);
+			r = r ? r : xbuf_put(info, "", 1);
+			info->xnone &= info->xbuf_len == mark + 1; // Only an empty word vanishes
+			if (!r && !fields && (info->xsplit || info->xnone))
+			{
+				fields = arena_alloc(&info->scratch, sizeof(int) * info->argc);
+				for (k = 0; fields && k < i; k++)
+					fields[k] = 1;
+				r = fields ? 0 : -1;
+			}
+			if (fields)
+				fields[i] = info->xnone ? 0 : info->xsplit + 1;
+			any = 1;
+		}
+	info->xfields = 0;
+	if (!r && fields)
+		r = split_words(info, fields);
+	if (r)
+	{
+		if (r == -1)
+			info->status = 1;
+		info->argv = NULL;
+		return (-1);
+	}
+	// The buffer may have moved while it grew: point argv at it only now
+	for (p = info->xbuf, i = 0; any && !fields && info->argv[i]; i++)
+		if (info->cmd_words[i].flags & TOKF_DOLLAR)
+		{
+			info->argv[i] = p;
+			p += _strlen(p) + 1;
+		}
+	return (any);
 }